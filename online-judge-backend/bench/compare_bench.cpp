@@ -0,0 +1,110 @@
+/**
+ * 输出比较器基准测试
+ *
+ * 生成指定大小（默认 256MB）的标准答案和用户输出文件，分别测量原先“整文件读入 std::string 再 strcmp”的方式
+ * 与 OutputComparator 各比较模式的耗时和吞吐量。
+ *
+ * 用法：compare-bench [大小（MB）] [临时目录]
+ */
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+
+#include "judger/output_comparator.h"
+
+using namespace std;
+
+// 生成输出文件：每行 8 个整数，trailing 为 true 时在每行行末追加空格，mismatch 为 true 时修改最后一行
+static void WriteOutput(const string &path, size_t lines, bool trailing, bool mismatch) {
+    ofstream out(path, ios::binary);
+    string line;
+    unsigned int seed = 12345;
+    for (size_t n = 1; n <= lines; n++) {
+        line.clear();
+        for (int i = 0; i < 8; i++) {
+            seed = seed * 1103515245 + 12345;
+            line += to_string(seed % 1000000007);
+            line += i == 7 ? "" : " ";
+        }
+        if (trailing) {
+            line += "  ";
+        }
+        line += "\n";
+        if (mismatch && n == lines) {
+            line[0] = line[0] == '9' ? '8' : '9';
+        }
+        out << line;
+    }
+}
+
+// 原先的比较方式：整文件读入后 strcmp
+static bool LegacyCompare(const string &expectedpath, const string &actualpath) {
+    ifstream infile1(expectedpath);
+    string expected((istreambuf_iterator<char>(infile1)), (istreambuf_iterator<char>()));
+    ifstream infile2(actualpath);
+    string actual((istreambuf_iterator<char>(infile2)), (istreambuf_iterator<char>()));
+    return strcmp(expected.data(), actual.data()) == 0;
+}
+
+static void Measure(const string &name, size_t bytes, const function<bool()> &fn) {
+    auto start = chrono::steady_clock::now();
+    bool equal = fn();
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    printf("%-36s %-8s %10.1f ms %10.1f MB/s\n", name.data(), equal ? "equal" : "differ", seconds * 1000,
+           bytes / 1048576.0 / seconds);
+}
+
+int main(int argc, char *argv[]) {
+    size_t megabytes = argc > 1 ? strtoul(argv[1], nullptr, 10) : 256;
+    string dir = argc > 2 ? argv[2] : "/tmp";
+    size_t bytes = megabytes << 20;
+    size_t lines = bytes / 80;  // 按每行约 80 字节估算行数
+
+    string expectedpath = dir + "/compare_bench_expected.out";
+    string samepath = dir + "/compare_bench_same.out";
+    string trailingpath = dir + "/compare_bench_trailing.out";
+    string mismatchpath = dir + "/compare_bench_mismatch.out";
+    cout << "Generating " << megabytes << "MB outputs in " << dir << " ..." << endl;
+    WriteOutput(expectedpath, lines, false, false);
+    WriteOutput(samepath, lines, false, false);
+    WriteOutput(trailingpath, lines, true, false);
+    WriteOutput(mismatchpath, lines, false, true);
+
+    // 预热页缓存
+    LegacyCompare(expectedpath, samepath);
+    LegacyCompare(trailingpath, mismatchpath);
+
+    struct Case {
+        string name;
+        string actualpath;
+    } cases[] = {{"same", samepath}, {"trailing-space", trailingpath}, {"mismatch-at-end", mismatchpath}};
+    struct Mode {
+        string name;
+        CompareMode mode;
+    } modes[] = {{"exact", CompareMode::EXACT},
+                 {"trailing", CompareMode::TRAILING},
+                 {"line", CompareMode::LINE},
+                 {"token", CompareMode::TOKEN}};
+
+    for (auto &c : cases) {
+        cout << "== " << c.name << " ==" << endl;
+        Measure("legacy (read + strcmp)", bytes, [&] { return LegacyCompare(expectedpath, c.actualpath); });
+        for (auto &m : modes) {
+            Measure("mmap " + m.name, bytes, [&] {
+                CompareResult res = OutputComparator::CompareFiles(expectedpath, c.actualpath, m.mode);
+                return res.equal;
+            });
+        }
+    }
+
+    remove(expectedpath.data());
+    remove(samepath.data());
+    remove(trailingpath.data());
+    remove(mismatchpath.data());
+    return EXIT_SUCCESS;
+}
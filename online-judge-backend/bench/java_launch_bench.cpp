@@ -0,0 +1,101 @@
+/**
+ * Java 启动开销基准测试
+ *
+ * 分别以原先的启动参数和“固定启动参数 + CDS 归档”运行同一个已编译的 Java 程序，测量平均 CPU 时间
+ * （包括 JIT 编译线程和 GC 线程）和实际运行时间。调整 Java 的时间限制（constants::judge::JAVA_TIME_FACTOR）前，
+ * 先在判题机上用计算量较大的程序测量。
+ * 需要先等待 CDS 归档生成完成（首次运行时会在 JVM_CDS_PATH 下生成）。
+ *
+ * 用法：java-launch-bench <class 所在目录> [主类名（默认 Main）] [运行次数（默认 20）] [输入文件]
+ */
+#include <fcntl.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "judger/jvm_cds.h"
+
+using namespace std;
+
+// 运行一次，返回 CPU 时间和实际运行时间（毫秒）
+static bool RunOnce(const vector<string> &args, const string &inputpath, double &cpums, double &realms) {
+    auto start = chrono::steady_clock::now();
+    pid_t pid = fork();
+    if (pid < 0) {
+        return false;
+    }
+    if (pid == 0) {
+        int infd = open(inputpath.empty() ? "/dev/null" : inputpath.data(), O_RDONLY);
+        int outfd = open("/dev/null", O_WRONLY);
+        dup2(infd, STDIN_FILENO);
+        dup2(outfd, STDOUT_FILENO);
+        vector<char *> argv;
+        for (auto &arg : args) {
+            argv.push_back((char *)arg.data());
+        }
+        argv.push_back(nullptr);
+        execv(argv[0], argv.data());
+        _exit(127);
+    }
+    int status;
+    struct rusage usage;
+    if (wait4(pid, &status, 0, &usage) < 0 || !WIFEXITED(status) || WEXITSTATUS(status) != 0) {
+        return false;
+    }
+    realms = chrono::duration<double, milli>(chrono::steady_clock::now() - start).count();
+    cpums = usage.ru_utime.tv_sec * 1000.0 + usage.ru_utime.tv_usec / 1000.0 + usage.ru_stime.tv_sec * 1000.0 +
+            usage.ru_stime.tv_usec / 1000.0;
+    return true;
+}
+
+// 运行多次并输出平均值
+static void Measure(const char *name, const vector<string> &args, const string &inputpath, int times) {
+    double totalcpu = 0, totalreal = 0;
+    for (int i = 0; i < times; i++) {
+        double cpums, realms;
+        if (!RunOnce(args, inputpath, cpums, realms)) {
+            printf("%-16s 运行失败\n", name);
+            return;
+        }
+        totalcpu += cpums;
+        totalreal += realms;
+    }
+    printf("%-16s 平均 CPU 时间 %8.1f ms  平均实际运行时间 %8.1f ms\n", name, totalcpu / times, totalreal / times);
+}
+
+int main(int argc, char *argv[]) {
+    if (argc < 2) {
+        printf("用法：%s <class 所在目录> [主类名] [运行次数] [输入文件]\n", argv[0]);
+        return 1;
+    }
+    string classpath = argv[1];
+    string mainclass = argc > 2 ? argv[2] : "Main";
+    int times = argc > 3 ? atoi(argv[3]) : 20;
+    string inputpath = argc > 4 ? argv[4] : "";
+
+    // 等待 CDS 归档生成完成
+    JvmCds *jvmcds = JvmCds::GetInstance();
+    jvmcds->Prepare();
+    while (jvmcds->GetStats()["State"].asString() == "Building") {
+        this_thread::sleep_for(chrono::milliseconds(100));
+    }
+    printf("CDS 归档：%s\n", jvmcds->GetStats().toStyledString().data());
+
+    vector<string> legacy = {"/usr/bin/java", "-cp", classpath, mainclass};
+    vector<string> tuned = {"/usr/bin/java"};
+    for (auto &arg : jvmcds->GetLaunchArgs()) {
+        tuned.push_back(arg);
+    }
+    tuned.insert(tuned.end(), {"-cp", classpath, mainclass});
+
+    Measure("原先的启动参数", legacy, inputpath, times);
+    Measure("CDS + 启动参数", tuned, inputpath, times);
+    return 0;
+}
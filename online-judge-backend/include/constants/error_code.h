@@ -65,6 +65,10 @@ constexpr int PROBLEM_NOT_FOUND = 3001;
 constexpr int PROBLEM_TITLE_EXISTS = 3002;
 /** 题目数据格式错误 */
 constexpr int PROBLEM_DATA_INVALID = 3003;
+/** SPJ 编译失败 */
+constexpr int PROBLEM_SPJ_COMPILE_FAILED = 3004;
+/** 题目数据版本冲突 */
+constexpr int PROBLEM_DATA_CONFLICT = 3005;
 
 // ==================== 公告模块错误 (4xxx) ====================
 /** 公告不存在 */
@@ -99,6 +103,8 @@ constexpr int JUDGE_CODE_EMPTY = 9001;
 constexpr int JUDGE_LANGUAGE_UNSUPPORTED = 9002;
 /** 判题服务不可用 */
 constexpr int JUDGE_SERVICE_UNAVAILABLE = 9003;
+/** 判题队列已满 */
+constexpr int JUDGE_QUEUE_FULL = 9004;
 
 }  // namespace error_code
 
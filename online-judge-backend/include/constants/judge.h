@@ -7,14 +7,16 @@
 
 // 判题状态枚举
 enum Status {
-    PJ,   // PJ "Pending & Judging"
-    CE,   // CE "Compile Error"
-    AC,   // AC "Accepted"
-    WA,   // WA "Wrong Answer"
-    RE,   // RE "Runtime Error"
-    TLE,  // TLE "Time Limit Exceeded"
-    MLE,  // MLE "Memory Limit Exceeded"
-    SE    // SE "System Error"
+    PJ,    // PJ "Pending & Judging"
+    CE,    // CE "Compile Error"
+    AC,    // AC "Accepted"
+    WA,    // WA "Wrong Answer"
+    RE,    // RE "Runtime Error"
+    TLE,   // TLE "Time Limit Exceeded"
+    MLE,   // MLE "Memory Limit Exceeded"
+    SE,    // SE "System Error"
+    SKIP,  // SKIP "Skipped"（仅用于测试用例，遇到首个失败用例后不再评测的用例）
+    OLE    // OLE "Output Limit Exceeded"（在已有编号之后追加，不改变已保存的状态编号）
 };
 
 namespace constants {
@@ -28,6 +30,8 @@ constexpr int STATUS_RUNTIME_ERROR = 4;          // 运行时错误 "RENum"
 constexpr int STATUS_TIME_LIMIT_EXCEEDED = 5;    // 超时 "TLENum"
 constexpr int STATUS_MEMORY_LIMIT_EXCEEDED = 6;  // 内存超限 "MLENum"
 constexpr int STATUS_SYSTEM_ERROR = 7;           // 系统错误 "SENum"
+constexpr int STATUS_SKIPPED = 8;                // 跳过（仅用于测试用例）
+constexpr int STATUS_OUTPUT_LIMIT_EXCEEDED = 9;  // 输出超限 "OLENum"
 
 // 各状态对应的题目统计字段
 constexpr const char* FIELD_COMPILE_ERROR = "CENum";           // 编译错误 1
@@ -37,17 +41,138 @@ constexpr const char* FIELD_RUNTIME_ERROR = "RENum";           // 运行时错
 constexpr const char* FIELD_TIME_LIMIT_EXCEEDED = "TLENum";    // 超时 5
 constexpr const char* FIELD_MEMORY_LIMIT_EXCEEDED = "MLENum";  // 内存超限 6
 constexpr const char* FIELD_SYSTEM_ERROR = "SENum";            // 系统错误 7
+constexpr const char* FIELD_OUTPUT_LIMIT_EXCEEDED = "OLENum";  // 输出超限 9
 
 // 资源限制
 constexpr int DEFAULT_TIME_LIMIT_MS = 1000;   // 默认时间限制（毫秒）
 constexpr int DEFAULT_MEMORY_LIMIT_MB = 256;  // 默认内存限制（MB）
 constexpr int MAX_TIME_LIMIT_MS = 10000;      // 最大时间限制（毫秒）
 constexpr int MAX_MEMORY_LIMIT_MB = 1024;     // 最大内存限制（MB）
+constexpr int DEFAULT_OUTPUT_LIMIT_MB = 32;   // 默认输出限制（MB，单个测试用例的标准输出和标准错误输出分别计算）
+constexpr int MAX_OUTPUT_LIMIT_MB = 64;       // 最大输出限制（MB，工作区的大小上限按该值预留并行评测的全部输出）
 
-// 代码运行的路径
+// 判题队列
+constexpr int JUDGE_WORKER_COUNT = 4;      // 判题工作线程数（与 HTTP 工作线程相互独立）
+constexpr int JUDGE_QUEUE_CAPACITY = 256;  // 判题队列最大长度，队列已满时拒绝新的提交
+
+// 测试用例并行评测
+constexpr int JUDGE_CASE_PARALLEL_SLOTS = 4;  // 单次提交最多同时运行的测试用例数（设置为 1 即串行评测）
+constexpr int JUDGE_RESERVED_CPU_COUNT = 1;   // 保留给 HTTP 服务和数据库的 CPU 数，不用于绑定评测槽位
+
+// 评测模式（按题目配置）
+constexpr const char* JUDGE_MODE_ICPC = "ICPC";  // 遇到首个失败的测试用例即停止评测，其余用例记为跳过
+constexpr const char* JUDGE_MODE_OI = "OI";      // 评测全部测试用例（默认）
+
+// 输出比较模式（按题目配置，SPJ 题目不使用）
+constexpr const char* COMPARE_MODE_EXACT = "Exact";                     // 逐字节完全一致
+constexpr const char* COMPARE_MODE_TRAILING = "Trailing";               // 忽略行末空白字符和文件末尾空行（默认）
+constexpr const char* COMPARE_MODE_LINE = "Line";                       // 忽略每行首尾空白字符和文件末尾空行
+constexpr const char* COMPARE_MODE_TOKEN = "Token";                     // 按空白字符分隔的单词比较
+constexpr const char* COMPARE_MODE_TOKEN_CASELESS = "TokenCaseless";    // 按单词比较，忽略大小写
+constexpr const char* COMPARE_MODE_FLOAT = "Float";                     // 按单词比较，数字允许绝对或相对误差
+constexpr const char* COMPARE_MODE_UNORDERED_LINES = "UnorderedLines";  // 忽略行的顺序
+constexpr const char* COMPARE_MODE_YES_NO = "YesNo";                    // 按单词比较 yes/no，忽略大小写
+constexpr double COMPARE_FLOAT_EPSILON = 1e-6;                          // 浮点数比较的默认误差（题目未设置时使用）
+
+// 编译和 SPJ 子进程（直接以参数数组启动，不经过 shell）
+constexpr int COMPILE_TIMEOUT = 10000;            // 编译的实际运行时间限制（毫秒）
+constexpr int COMPILE_INFO_MAX_BYTES = 64 << 10;  // 捕获的编译信息的最大字节数（超出的部分截断）
+constexpr int PCH_BUILD_TIMEOUT = 120000;         // 生成预编译头的实际运行时间限制（毫秒）
+constexpr int SPJ_TIMEOUT = 10000;                // 单个测试用例 SPJ 判定的实际运行时间限制（毫秒）
+
+// 编译阶段（与运行阶段使用独立的工作线程，之间通过有界队列衔接，未命中编译缓存的编译需要先申请准入）
+constexpr int COMPILE_WORKER_COUNT = 2;                           // 编译工作线程数（也是同时运行的编译数上限）
+constexpr int COMPILE_RUN_QUEUE_CAPACITY = 8;                     // 编译完成、等待运行的提交数上限
+constexpr long long COMPILE_MEMORY_ESTIMATE_BYTES = 512LL << 20;  // 单个 C++/Java 编译的预估内存
+constexpr long long COMPILE_MEMORY_RESERVE_BYTES = 512LL << 20;   // 准入后系统至少保留的可用内存
+constexpr double COMPILE_MAX_LOAD_PER_CPU = 1.0;                  // 平均负载与 CPU 数之比达到该值时推迟编译
+constexpr int COMPILE_ADMISSION_POLL_MS = 100;                    // 等待准入时重新检查内存和负载的间隔（毫秒）
+
+// 编译缓存（按源代码、语言、编译器版本和编译选项寻址）
+constexpr const char* COMPILE_CACHE_PATH = "./compilecache/";  // 编译缓存目录
+constexpr long long COMPILE_CACHE_MAX_BYTES = 1LL << 30;       // 编译缓存总大小上限，超出后按最近最少使用淘汰
+
+// 判题结果复用（相同代码在测试数据和评测参数未变化时直接复用判题结果，管理员可在运行时开关）
+constexpr bool VERDICT_CACHE_ENABLED = true;               // 启动时是否启用
+constexpr long long VERDICT_CACHE_MAX_BYTES = 64LL << 20;  // 缓存总大小上限，超出后按最近最少使用淘汰
+
+// 测试用例结果记忆（按编译产物、评测参数和测试用例内容寻址，重新评测时只运行变化或新增的测试用例）
+constexpr long long CASE_MEMO_MAX_BYTES = 64LL << 20;  // 记忆总大小上限，超出后按最近最少使用淘汰
+
+// 重新评测（由单独的线程逐个送入判题队列，只在判题队列较空时送入，优先评测正常的提交）
+constexpr int REJUDGE_MAX_RECORDS = 10000;  // 单次请求最多重新评测的测评记录数
+constexpr int REJUDGE_MAX_QUEUED = 2;       // 判题队列中的任务数达到该值时暂停送入
+constexpr int REJUDGE_INTERVAL_MS = 100;    // 相邻两次送入的最小间隔（毫秒）
+
+// 预编译头缓存（按头文件组合、编译器版本和编译选项寻址）
+constexpr const char* PCH_CACHE_PATH = "./pchcache/";
+
+// JVM 类数据共享归档（判题服务启动时在后台生成，按 JDK 版本和启动参数寻址）
+constexpr const char* JVM_CDS_PATH = "./jvmcds/";
+
+// Java 的资源限制倍数（保持原有的限制，在判题机上用 java-launch-bench 测量后再调整）
+constexpr int JAVA_TIME_FACTOR = 3;    // 沙箱中 CPU 时间和实际运行时间的倍数（判定超时仍使用原时间限制）
+constexpr int JAVA_MEMORY_FACTOR = 3;  // 空间限制的倍数（判定结果时同样使用放大后的限制）
+
+// SPJ 缓存（创建或修改题目时编译，按源代码、编译器版本和编译选项寻址）
+constexpr const char* SPJ_CACHE_PATH = "./spjcache/";        // SPJ 编译产物目录
+constexpr const char* SPJ_COMPILE_FLAGS = "-O2 -std=c++17";  // SPJ 编译选项
+
+// 测试数据缓存（按题目缓存 mmap 映射的测试数据）
+constexpr long long TESTDATA_CACHE_MAX_BYTES = 512LL << 20;  // 测试数据缓存总大小上限，超出后按最近最少使用淘汰
+constexpr bool TESTDATA_CACHE_LOCK_PAGES = true;             // 是否使用 mlock 锁定缓存的页面（失败时仅计数）
+
+// 测评记录和后台题目编辑器中的测试用例信息（只包含输入输出的预览、大小和 SHA-256，完整数据按需从题目数据目录获取）
+constexpr int TESTINFO_PREVIEW_BYTES = 1024;  // 每项输入输出预览的最大字节数
+constexpr int TESTINFO_PREVIEW_LINES = 32;    // 每项输入输出预览的最大行数
+
+// 沙箱启动器（由单线程的 judge-launcher 进程调用 run()，与后端可执行文件位于同一目录，不再从后端进程 fork 沙箱进程）
+constexpr const char* LAUNCHER_NAME = "judge-launcher";                         // 启动器可执行文件名
+constexpr int LAUNCHER_COUNT = JUDGE_WORKER_COUNT * JUDGE_CASE_PARALLEL_SLOTS;  // 启动器数目（设置为 0 即不使用）
+
+// cgroup v2（可选，需要 root 权限，只用于由沙箱启动器运行的测试用例）
+// 每个评测槽位一个 cgroup，cpuset 固定为槽位的 CPU；每次运行在其下创建子 cgroup，用 memory.max 和 pids.max 限制
+// 沙箱进程，用 cpu.stat 和 memory.peak 统计运行时间和内存。父 cgroup 中须可用 cpuset、memory 和 pids 控制器，
+// 不可用时（cgroup v1、缺少控制器）按原方式运行
+constexpr bool CGROUP_ENABLED = false;                              // 是否启用
+constexpr const char* CGROUP_ROOT = "/sys/fs/cgroup/online-judge";  // 判题使用的 cgroup 目录
+
+// Python2/Python3 的 zygote（每个评测槽位只启动一次解释器，由它为每个测试用例 fork 子进程运行用户程序）
+constexpr bool ZYGOTE_ENABLED = false;       // 是否启用（关闭时每个测试用例都冷启动解释器）
+constexpr int ZYGOTE_START_TIMEOUT = 10000;  // 等待解释器启动和 fork 子进程的超时时间（毫秒）
+
+// 判题阶段耗时统计（按语言和题目汇总的直方图，见 judger/judge_trace.h）
+constexpr int TRACE_HISTOGRAM_BUCKETS = 40;  // 直方图的桶数（最后一个桶统计 2^39 纳秒即约 9 分钟以上的耗时）
+constexpr int TRACE_MAX_PROBLEMS = 1024;     // 单独统计的题目数上限
+
+// 代码运行的路径（评测工作区根目录，其下为预先创建的工作区槽位）
 constexpr const char* RUN_PATH_PREFIX = "./tmp/";
-// 存储题目数据的路径
+
+// 评测工作区（编译时签出，运行结束后归还，槽位数覆盖编译中、等待运行和运行中的全部提交）
+constexpr int WORKSPACE_SLOT_COUNT = JUDGE_WORKER_COUNT + COMPILE_WORKER_COUNT + COMPILE_RUN_QUEUE_CAPACITY;
+// 单个工作区槽位的大小上限：并行评测的各测试用例同时写满标准输出和标准错误输出（槽位数 × 2 × 最大输出限制），
+// 另留 128MB 给源代码、编译产物和 SPJ 等文件
+constexpr long long WORKSPACE_SLOT_QUOTA_BYTES = (2LL * JUDGE_CASE_PARALLEL_SLOTS * MAX_OUTPUT_LIMIT_MB + 128) << 20;
+constexpr bool WORKSPACE_USE_TMPFS = true;  // 是否为每个槽位挂载独立的 tmpfs（需要 root 权限）
+
+// 存储题目数据的路径（<题目 ID> 是指向当前版本目录 <题目 ID>@<版本> 的符号链接，见 judger/testdata_store.h）
 constexpr const char* PROBLEM_DATA_PREFIX = "./problemdata/";
+constexpr const char* TESTDATA_MANIFEST_NAME = "manifest.json";  // 版本目录中的测试数据清单
+constexpr int TESTDATA_MAX_CASES = 10000;                        // 单个题目的测试用例数目上限
+constexpr int TESTDATA_CASE_PAGE_SIZE = 20;                      // 后台分页查询测试用例信息的默认每页数目
+constexpr int TESTDATA_CASE_PAGE_MAX = 100;                      // 后台分页查询测试用例信息的每页数目上限
+
+// 测试数据包（每个版本的测试用例打包为一个带索引的文件，见 judger/testdata_pack.h）
+constexpr const char* TESTDATA_PACK_NAME = "data.pack";       // 版本目录中的数据包文件名
+constexpr bool TESTDATA_PACK_ENABLED = true;                  // 提交新版本时是否打包（关闭时按单独的文件存放）
+constexpr bool TESTDATA_PACK_COMPRESS = true;                 // 是否尝试用 zstd 压缩每个文件
+constexpr int TESTDATA_PACK_ZSTD_LEVEL = 3;                   // zstd 压缩级别
+constexpr long long TESTDATA_PACK_MIN_COMPRESS_BYTES = 4096;  // 小于该大小的文件不压缩
+constexpr int TESTDATA_PACK_MIN_SAVING = 10;                  // 压缩至少节省的百分比，否则按原样存放
+constexpr size_t TESTDATA_PACK_CHUNK_SIZE = 1 << 20;          // 流式读取和解压的块大小
+// 判题时数据包中的测试用例导出到该目录（沙箱按路径打开标准输入），每个数据版本导出一次
+constexpr const char* TESTDATA_EXTRACT_PATH = "/dev/shm/online-judge-testdata/";
+constexpr long long TESTDATA_EXTRACT_MAX_BYTES = 1LL << 30;  // 保留的导出目录总大小上限，超出后按最近最少使用淘汰
 
 // 编程语言
 constexpr const char* LANG_C = "C";
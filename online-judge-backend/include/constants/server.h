@@ -13,7 +13,8 @@ constexpr int MAX_THREAD_COUNT = 8;
 constexpr const char* API_PREFIX = "/api";
 
 // 请求限制
-constexpr int MAX_REQUEST_BODY_SIZE = 10 * 1024 * 1024;  // 10MB
+constexpr int MAX_REQUEST_BODY_SIZE = 10 * 1024 * 1024;         // 10MB
+constexpr long long MAX_UPLOAD_BODY_SIZE = 1024LL * 1024 * 1024;  // 1GB，只用于测试数据上传（流式写入磁盘）
 constexpr int REQUEST_TIMEOUT_SECONDS = 30;
 
 // 静态资源路径（相对于程序运行目录 online-judge-backend/）
@@ -3,6 +3,8 @@
 
 #include <json/json.h>
 
+#include "services/problem_service.h"  // 测试数据上传的接收函数类型
+
 /**
  * 控制类头文件
  */
@@ -109,6 +111,30 @@ public:
      */
     Json::Value DeleteProblem(Json::Value &deletejson);
 
+    /**
+     * 功能：获取题目测试数据的清单
+     * 权限：只允许管理员查询
+     */
+    Json::Value GetProblemDataManifest(Json::Value &queryjson);
+
+    /**
+     * 功能：分页获取题目测试用例的信息（只包含大小、哈希和预览）
+     * 权限：只允许管理员查询
+     */
+    Json::Value SelectProblemDataCases(Json::Value &queryjson);
+
+    /**
+     * 功能：获取题目的一个测试数据文件（文件内容由 sender 按请求的范围流式发送）
+     * 权限：只允许管理员查询
+     */
+    Json::Value SelectProblemDataFile(Json::Value &queryjson, const TestDataSender &sender);
+
+    /**
+     * 功能：上传题目的测试数据（只需上传内容变化的文件，请求体由 receiver 写入暂存目录）
+     * 权限：只允许管理员上传
+     */
+    Json::Value UploadProblemData(Json::Value &uploadjson, const TestDataReceiver &receiver);
+
     /**
      * 功能：分页获取题目列表
      * 权限：所有用户均可查询
@@ -320,6 +346,24 @@ public:
      * 权限：只允许普通用户及以上使用
      */
     Json::Value GetJudgeCode(Json::Value judgejson);
+
+    /**
+     * 功能：获取判题服务的运行状态
+     * 权限：只允许管理员查询
+     */
+    Json::Value SelectJudgeStats(Json::Value &queryjson);
+
+    /**
+     * 功能：启用或关闭判题结果复用
+     * 权限：只允许管理员操作
+     */
+    Json::Value UpdateVerdictCache(Json::Value &updatejson);
+
+    /**
+     * 功能：按题目、用户和提交时间范围重新评测
+     * 权限：只允许管理员操作
+     */
+    Json::Value Rejudge(Json::Value &queryjson);
     // ------------------------------ 判题模块 End ------------------------------
 
     Control();
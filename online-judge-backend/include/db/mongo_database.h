@@ -9,6 +9,7 @@
 #include <mongocxx/uri.hpp>
 
 #include "constants/db.h"
+#include "judger/judge_result.h"
 
 using namespace std;
 
@@ -91,6 +92,13 @@ public:
      */
     bool UpdateUserProblemInfo(Json::Value &updatejson);
 
+    /**
+     * 功能：重新统计用户题目信息（用于重新评测之后按测评记录修正 Solves 和 ACNum）
+     * 传入：Json(List[{UserId, ProblemId}])
+     * 传出：bool
+     */
+    bool RecountUserProblemInfo(Json::Value &updatejson);
+
     /**
      * 功能：通过 UserId 获取用户名 NickName
      * 传入：string(UserId)
@@ -109,28 +117,31 @@ public:
     /**
      * 功能：查询题目信息（单条）
      * 传入：Json(ProblemId)
-     * Json(Result, Reason, _id, Title,Description, TimeLimit, MemoryLimit, JudgeNum, SubmitNum, ACNum, UserNickName,
-     * Tags)
+     * Json(Result, Reason, _id, Title,Description, TimeLimit, MemoryLimit, OutputLimit, JudgeNum, JudgeMode,
+     * CompareMode, CompareEpsilon, SubmitNum, ACNum, UserNickName, Tags)
      */
     Json::Value SelectProblemInfo(Json::Value &queryjson);
 
     /**
      * 功能：查询题目信息（管理员权限）
      * 传入：Json(ProblemId)
-     * 传出：Json(Result, Reason,_id, Title, Description, TimeLimit, MemoryLimit, UserNickName, JudgeNum, Tags)
+     * 传出：Json(Result, Reason,_id, Title, Description, TimeLimit, MemoryLimit, OutputLimit, UserNickName, JudgeNum,
+     * JudgeMode, CompareMode, CompareEpsilon, Tags)
      */
     Json::Value SelectProblemInfoByAdmin(Json::Value &queryjson);
 
     /**
      * 功能：插入题目（管理员权限）
-     * 传入：Json(Title, Description, TimeLimit, MemoryLimit, JudgeNum, Tags, UseNickName)
+     * 传入：Json(Title, Description, TimeLimit, MemoryLimit, OutputLimit, JudgeNum, JudgeMode, CompareMode,
+     * CompareEpsilon, Tags, UseNickName)
      * 传出：Json(Result, Reason, ProblemId)
      */
     Json::Value InsertProblem(Json::Value &insertjson);
 
     /**
      * 功能：更新题目信息（管理员权限）
-     * 传入：Json(ProblemId, Title, Description, TimeLimit, MemoryLimit, JudgeNum, Tags, UseNickName)
+     * 传入：Json(ProblemId, Title, Description, TimeLimit, MemoryLimit, OutputLimit, JudgeNum, JudgeMode,
+     * CompareMode, CompareEpsilon, Tags, UseNickName)
      * 传出：Json(Result, Reason)
      */
     Json::Value UpdateProblem(Json::Value &updatejson);
@@ -146,7 +157,7 @@ public:
      * 功能：分页获取题目列表
      * 传入：Json(Page, PageSize, SearchInfo{Id, Title, Tags[]})
      * 传出：Json((Result, Reason, ArrayInfo[ProblemId, Title, SubmitNum, CENum, ACNum, WANum, RENum,
-     * TLENum, MLENum, SENum, Tags]), TotalNum)
+     * TLENum, MLENum, SENum, OLENum, Tags]), TotalNum)
      */
     Json::Value SelectProblemList(Json::Value &queryjson);
 
@@ -154,7 +165,7 @@ public:
      * 功能：分页获取题目列表（管理员权限）
      * 传入：Json(Page, PageSize)
      * 传出：Json((Result, Reason, ArrayInfo[ProblemId, Title, SubmitNum, CENum, ACNum, WANum, RENum,
-     * TLENum, MLENum, SENum, Tags]), TotalNum)
+     * TLENum, MLENum, SENum, OLENum, Tags]), TotalNum)
      */
     Json::Value SelectProblemListByAdmin(Json::Value &queryjson);
 
@@ -164,6 +175,20 @@ public:
      * 传出：bool
      */
     bool UpdateProblemStatusNum(Json::Value &updatejson);
+
+    /**
+     * 功能：重新统计题目的状态数量（用于重新评测之后按测评记录修正）
+     * 传入：Json(ProblemIds[])
+     * 传出：bool
+     */
+    bool RecountProblemStatusNum(Json::Value &updatejson);
+
+    /**
+     * 功能：更新题目的测试用例数目（上传测试数据之后同步）
+     * 传入：Json(ProblemId, JudgeNum)
+     * 传出：bool
+     */
+    bool UpdateProblemJudgeNum(Json::Value &updatejson);
     // ------------------------------ 题目模块 End ------------------------------
 
     // ------------------------------ 标签模块 Start ------------------------------
@@ -466,11 +491,10 @@ public:
 
     /**
      * 功能：更新测评记录
-     * 传入：Json(SubmitId, Status, RunTime, RunMemory, Length, CompilerInfo, TestInfo[(Status, StandardInput,
-     * StandardOutput, PersonalOutput, RunTime, RunMemory)])
+     * 传入：JudgeResult（见 judger/judge_result.h）
      * 传出：bool
      */
-    bool UpdateStatusRecord(Json::Value &updatejson);
+    bool UpdateStatusRecord(const JudgeResult &result);
 
     /**
      * 功能：分页查询测评记录
@@ -492,6 +516,13 @@ public:
      * 传出：作者 UserId，如果不存在返回空字符串
      */
     std::string GetStatusRecordAuthorId(int64_t statusRecordId);
+
+    /**
+     * 功能：查询需要重新评测的测评记录
+     * 传入：Json(ProblemId, UserId, StartTime, EndTime)
+     * 传出：Json(List[{_id, ProblemId, UserId, Language, Code}], Total)
+     */
+    Json::Value SelectRejudgeRecords(Json::Value &queryjson);
     // ------------------------------ 测评记录模块 End ------------------------------
 
     // ------------------------------ Token 鉴权实现 Start ------------------------------
@@ -0,0 +1,75 @@
+#ifndef CASE_MEMO_H
+#define CASE_MEMO_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "judger/judge_result.h"
+
+/**
+ * 测试用例结果记忆头文件
+ *
+ * 以编译产物（编译缓存的键，由语言、编译器版本、编译选项和源代码决定）、评测参数（时间、内存和输出限制、比较模式和
+ * 误差、SPJ 版本）以及测试用例输入和标准答案的 SHA-256 的摘要作为键，保存单个测试用例的判定结果。
+ * 每次判题都会保存，只有重新评测时才查找：管理员修改部分测试用例后重新评测，只有内容变化或新增的测试用例需要运行。
+ * 系统错误不保存；超时和内存超限受评测机负载影响（重新评测常用于负载过高导致误判之后），同样不保存，重新评测时总是
+ * 重新运行。记忆只保存在内存中，总大小受 CASE_MEMO_MAX_BYTES 限制，超出后按最近最少使用的顺序淘汰。
+ */
+class CaseMemo {
+private:
+    struct Entry {
+        CaseResult result;                      // 测试用例的判定结果
+        std::string reason;                     // 运行时错误或系统错误的原因
+        long long judgens;                      // 运行和判定的耗时（纳秒）
+        long long bytes;                        // 估计占用的字节数
+        std::list<std::string>::iterator iter;  // 在 LRU 链表中的位置
+    };
+
+    std::unordered_map<std::string, Entry> entries;  // 记忆项
+    std::list<std::string> lru;                      // 最近使用的记忆项在前
+    long long total_bytes;                           // 记忆总大小
+    std::mutex memo_mutex;                           // 保护记忆的互斥锁
+
+    std::atomic<long long> hit_num;    // 命中次数
+    std::atomic<long long> miss_num;   // 未命中次数
+    std::atomic<long long> store_num;  // 保存次数
+    std::atomic<long long> saved_ns;   // 命中节省的运行和判定耗时之和（纳秒）
+
+    CaseMemo();
+
+    ~CaseMemo();
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static CaseMemo *GetInstance();
+
+    /**
+     * 功能：计算记忆键
+     * 传入：编译产物的键、评测参数、测试用例输入和标准答案的 SHA-256
+     * 传出：记忆键（SHA-256 十六进制字符串，编译产物的键为空时返回空字符串）
+     */
+    static std::string GetKey(const std::string &binarykey, const std::string &params, const std::string &inputhash,
+                              const std::string &outputhash);
+
+    // 查找测试用例的判定结果和错误原因，未命中时返回 false
+    bool Get(const std::string &key, CaseResult &result, std::string &reason);
+
+    /**
+     * 功能：保存测试用例的判定结果
+     * 传入：记忆键、判定结果、错误原因、运行和判定的耗时（纳秒）
+     */
+    void Store(const std::string &key, const CaseResult &result, const std::string &reason, long long judgens);
+
+    /**
+     * 功能：获取测试用例结果记忆的运行状态
+     * 传出：Json(EntryNum, TotalBytes, MaxBytes, HitNum, MissNum, StoreNum, SavedMs)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // CASE_MEMO_H
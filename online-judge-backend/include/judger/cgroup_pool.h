@@ -0,0 +1,53 @@
+#ifndef CGROUP_POOL_H
+#define CGROUP_POOL_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <mutex>
+#include <set>
+#include <string>
+
+/**
+ * 评测槽位 cgroup 池头文件
+ *
+ * 启用时在 CGROUP_ROOT 下为每个用到的评测 CPU 创建槽位 cgroup（cpuset.cpus 固定为该 CPU，沙箱进程不能再改变
+ * 自己的 CPU 绑定），以及空闲的沙箱启动器所在的 launcher cgroup。每次运行时的子 cgroup 由启动器创建和删除
+ * （见 judger/cgroup_sandbox.hpp）。cgroup v2 或所需的控制器不可用时不启用，测试用例按原方式运行和统计。
+ */
+class CgroupPool {
+private:
+    bool enabled;           // 是否可用
+    std::string error;      // 不可用的原因
+    std::set<int> slots;    // 已创建的槽位 cgroup（按 CPU 编号）
+    std::mutex pool_mutex;  // 保护槽位列表的互斥锁
+
+    std::atomic<long long> accounted_num;    // 使用 cgroup 统计的运行次数
+    std::atomic<long long> unaccounted_num;  // 请求使用 cgroup 但未能使用的运行次数
+    std::atomic<long long> oomkill_num;      // 被 memory.max 终止的次数
+
+    CgroupPool();
+
+    ~CgroupPool();
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static CgroupPool *GetInstance();
+
+    // 获取 CPU 对应的槽位 cgroup 目录（首次使用时创建，未启用、CPU 为 -1 或创建失败时返回空字符串）
+    std::string GetSlotPath(int cpu);
+
+    // 获取空闲的沙箱启动器所在的 cgroup 目录
+    static std::string GetHomePath();
+
+    // 记录一次请求使用 cgroup 的运行
+    void Record(bool accounted, bool oomkilled);
+
+    /**
+     * 功能：获取评测槽位 cgroup 池的运行状态
+     * 传出：Json(Enabled, Root, Error, SlotNum, AccountedNum, UnaccountedNum, OomKillNum)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // CGROUP_POOL_H
@@ -0,0 +1,132 @@
+#pragma once
+#include <fcntl.h>
+#include <sys/stat.h>
+#include <sys/vfs.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <fstream>
+#include <string>
+
+extern "C" {
+#include "judger/runner.h"
+}
+
+/**
+ * 沙箱 cgroup（cgroup v2，由 judge-launcher 在调用 run() 前后使用）
+ * 每次运行在评测槽位的 cgroup 下创建子 cgroup "run" 并把启动器移入，run() fork 的沙箱进程随之位于该 cgroup，
+ * 由 memory.max 和 pids.max 限制（pids.max 对 root 用户同样有效，RLIMIT_NPROC 则不然）；
+ * 运行结束后启动器移回空闲时所在的 cgroup，用 cpu.stat 的 usage_usec 和 memory.peak 替换 rusage 的统计，
+ * 终止残留的进程并删除子 cgroup。每个槽位同一时刻只运行一个测试用例，子 cgroup 的名称固定。
+ */
+namespace cgroup_sandbox {
+
+// 沙箱进程所在的 cgroup
+struct SandboxCgroup {
+    std::string slot;   // 评测槽位的 cgroup 目录（为空表示不使用 cgroup）
+    std::string home;   // 启动器空闲时所在的 cgroup 目录
+    int64_t memorymax;  // memory.max（字节，-1 表示不限）
+    int64_t pidsmax;    // pids.max（-1 表示不限）
+};
+
+// 写入 cgroup 接口文件
+inline bool WriteFile(const std::string& path, const std::string& value) {
+    int fd = open(path.data(), O_WRONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    bool success = write(fd, value.data(), value.size()) == (ssize_t)value.size();
+    close(fd);
+    return success;
+}
+
+// 读取 "键 值" 格式的接口文件（cpu.stat、memory.events）中的值，不存在时返回 -1
+inline long long ReadKey(const std::string& path, const std::string& key) {
+    std::ifstream infile(path);
+    std::string name;
+    long long value;
+    while (infile >> name >> value) {
+        if (name == key) {
+            return value;
+        }
+    }
+    return -1;
+}
+
+// 读取只有一个值的接口文件（memory.peak），不存在时返回 -1
+inline long long ReadValue(const std::string& path) {
+    std::ifstream infile(path);
+    long long value;
+    return infile >> value ? value : -1;
+}
+
+// 位于 tmpfs 上的文件占用的内存（tmpfs 的页面计入写入者所在 cgroup 的内存）
+inline long long ShmemSize(const char* path) {
+    struct statfs fs;
+    struct stat st;
+    const long TMPFS_MAGIC = 0x01021994;
+    if (path == nullptr || statfs(path, &fs) != 0 || fs.f_type != TMPFS_MAGIC || stat(path, &st) != 0) {
+        return 0;
+    }
+    return (long long)st.st_blocks * 512;
+}
+
+// 删除子 cgroup（有残留的进程时先全部终止）
+inline void Remove(const std::string& path) {
+    if (rmdir(path.data()) == 0 || errno == ENOENT) {
+        return;
+    }
+    // 用户程序创建后没有退出的子进程不会被沙箱库终止，在这里一并终止
+    WriteFile(path + "/cgroup.kill", "1");
+    for (int i = 0; i < 100 && rmdir(path.data()) != 0 && errno == EBUSY; i++) {
+        usleep(1000);
+    }
+}
+
+// 创建本次运行的子 cgroup 并将当前进程移入，失败时返回 false（按不使用 cgroup 的方式运行）
+inline bool Enter(const SandboxCgroup& cgroup) {
+    std::string runpath = cgroup.slot + "/run";
+    // 上次运行异常结束（启动器崩溃）时留下的子 cgroup
+    Remove(runpath);
+    if (mkdir(runpath.data(), 0755) != 0) {
+        return false;
+    }
+    // 不使用交换分区，超出 memory.max 时直接终止
+    WriteFile(runpath + "/memory.swap.max", "0");
+    if ((cgroup.memorymax > 0 && !WriteFile(runpath + "/memory.max", std::to_string(cgroup.memorymax))) ||
+        (cgroup.pidsmax > 0 && !WriteFile(runpath + "/pids.max", std::to_string(cgroup.pidsmax))) ||
+        !WriteFile(runpath + "/cgroup.procs", std::to_string(getpid()))) {
+        Remove(runpath);
+        return false;
+    }
+    return true;
+}
+
+/**
+ * 功能：将当前进程移出子 cgroup，用 cgroup 的统计替换运行结果中的 CPU 时间和内存，并删除子 cgroup
+ * 传入：沙箱 cgroup、沙箱配置、运行结果
+ * 传出：是否使用了 cgroup 的统计、是否被 memory.max 终止
+ */
+inline bool Leave(const SandboxCgroup& cgroup, const struct config& conf, struct result& res, bool& oomkilled) {
+    std::string runpath = cgroup.slot + "/run";
+    WriteFile(cgroup.home + "/cgroup.procs", std::to_string(getpid()));
+    long long usage = ReadKey(runpath + "/cpu.stat", "usage_usec");
+    long long peak = ReadValue(runpath + "/memory.peak");
+    oomkilled = ReadKey(runpath + "/memory.events", "oom_kill") > 0;
+    Remove(runpath);
+
+    if (oomkilled) {
+        res.result = MEMORY_LIMIT_EXCEEDED;
+    }
+    if (usage < 0 || peak < 0) {
+        return false;
+    }
+    // 输出文件位于 tmpfs 时其页面同样计入峰值，按运行结束时的大小扣除（输出文件只会增长，扣除后不会高估）
+    peak -= ShmemSize(conf.output_path) + ShmemSize(conf.error_path);
+    res.cpu_time = (int)(usage / 1000);
+    res.memory = peak > 0 ? (long)peak : 0;
+    return true;
+}
+
+}  // namespace cgroup_sandbox
@@ -0,0 +1,81 @@
+#ifndef COMPILE_CACHE_H
+#define COMPILE_CACHE_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <list>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 编译缓存头文件
+ *
+ * 以源代码、语言、编译器版本和编译选项的摘要作为键，缓存编译产物和编译信息（compileinfo.txt），
+ * 重复提交或重判相同代码时直接从缓存恢复，编译错误同样会被缓存。
+ * 缓存目录总大小受 COMPILE_CACHE_MAX_BYTES 限制，超出后按最近最少使用的顺序淘汰。
+ */
+class CompileCache {
+private:
+    struct Entry {
+        long long size;                         // 缓存项占用的字节数
+        std::list<std::string>::iterator iter;  // 在 LRU 链表中的位置
+    };
+
+    std::string cache_path;                          // 缓存目录
+    std::unordered_map<std::string, Entry> entries;  // 缓存项
+    std::list<std::string> lru;                      // 最近使用的缓存项在前
+    long long total_bytes;                           // 缓存总大小
+    std::mutex cache_mutex;                          // 保护缓存索引的互斥锁
+
+    std::unordered_map<std::string, std::string> versions;  // 编译器版本信息（按查询命令缓存）
+    std::mutex version_mutex;                               // 保护编译器版本信息的互斥锁
+
+    std::atomic<long long> hit_num;   // 命中次数
+    std::atomic<long long> miss_num;  // 未命中次数
+
+    CompileCache();
+
+    ~CompileCache();
+
+    // 获取编译器版本信息（执行一次查询命令后缓存结果）
+    std::string GetCompilerVersion(const std::string &versioncmd);
+
+    // 淘汰缓存项直到总大小不超过上限，返回需要删除的目录（需持有 cache_mutex）
+    std::vector<std::string> Evict();
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static CompileCache *GetInstance();
+
+    /**
+     * 功能：计算缓存键
+     * 传入：语言、输出编译器版本的命令、编译选项、源代码
+     * 传出：缓存键（SHA-256 十六进制字符串）
+     */
+    std::string GetKey(const std::string &language, const std::string &versioncmd, const std::string &flags,
+                       const std::string &source);
+
+    /**
+     * 功能：从缓存恢复编译结果到运行目录
+     * 传入：缓存键、运行目录、是否使用硬链接（否则复制文件）
+     * 传出：bool（是否命中）
+     */
+    bool Restore(const std::string &key, const std::string &runpath, bool hardlink);
+
+    /**
+     * 功能：保存编译结果到缓存
+     * 传入：缓存键、运行目录、需要缓存的编译产物（相对运行目录的路径，不存在的会被忽略）
+     */
+    void Store(const std::string &key, const std::string &runpath, const std::vector<std::string> &artifacts);
+
+    /**
+     * 功能：获取编译缓存的运行状态
+     * 传出：Json(EntryNum, TotalBytes, MaxBytes, HitNum, MissNum)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // COMPILE_CACHE_H
@@ -0,0 +1,67 @@
+#ifndef COMPILE_GOVERNOR_H
+#define COMPILE_GOVERNOR_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+
+/**
+ * 编译准入控制头文件
+ *
+ * 未命中编译缓存的编译在启动编译器之前需要先申请准入：同时运行的编译数不超过编译工作线程数，
+ * 且系统可用内存（扣除已准入编译的预估内存）和 1 分钟平均负载都满足条件时才允许开始，
+ * 避免多个 g++ -O2 或 javac 同时运行占满内存，或与正在计时的测试用例争抢 CPU。
+ * 没有正在运行的编译时总是准入，保证编译阶段在资源紧张时仍能逐个推进。
+ */
+class CompileGovernor {
+private:
+    int active_num;                         // 正在运行的编译数
+    long long active_bytes;                 // 正在运行的编译的预估内存之和
+    int cpu_num;                            // 在线 CPU 数（用于换算负载阈值）
+    std::mutex governor_mutex;              // 保护准入状态的互斥锁
+    std::condition_variable governor_cond;  // 等待准入的条件变量
+
+    std::atomic<long long> admit_num;         // 准入次数
+    std::atomic<long long> wait_num;          // 需要等待才准入的次数
+    std::atomic<long long> memory_defer_num;  // 因可用内存不足而推迟的次数
+    std::atomic<long long> load_defer_num;    // 因负载过高而推迟的次数
+    std::atomic<long long> forced_num;        // 资源不满足、但没有正在运行的编译而直接准入的次数
+    std::atomic<long long> wait_us;           // 等待准入的总时间（微秒）
+    std::atomic<long long> max_wait_us;       // 等待准入的最长时间（微秒）
+
+    CompileGovernor();
+
+    ~CompileGovernor();
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static CompileGovernor *GetInstance();
+
+    // 获取编译一份代码的预估内存（按语言区分）
+    static long long EstimateMemory(const std::string &language);
+
+    // 获取系统可用内存（/proc/meminfo 中的 MemAvailable，无法获取时返回 -1）
+    static long long GetAvailableMemory();
+
+    /**
+     * 功能：申请编译准入（阻塞直到准入）
+     * 传入：编程语言
+     * 传出：本次编译的预估内存（编译结束后传给 Release）
+     */
+    long long Acquire(const std::string &language);
+
+    // 编译结束，释放准入
+    void Release(long long bytes);
+
+    /**
+     * 功能：获取编译准入控制的运行状态
+     * 传出：Json(ActiveNum, MaxActiveNum, AvailableBytes, LoadAverage, AdmitNum, WaitNum, MemoryDeferNum, LoadDeferNum,
+     * ForcedNum, AvgWaitUs, MaxWaitUs)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // COMPILE_GOVERNOR_H
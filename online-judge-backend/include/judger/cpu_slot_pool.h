@@ -0,0 +1,43 @@
+#ifndef CPU_SLOT_POOL_H
+#define CPU_SLOT_POOL_H
+
+#include <condition_variable>
+#include <mutex>
+#include <vector>
+
+/**
+ * 评测 CPU 槽位池头文件
+ *
+ * 每个评测槽位独占一个 CPU 核心，同一时刻不会有两个沙箱进程被绑定到同一个核心上，
+ * 从而保证并行评测时运行时间的稳定。
+ */
+class CpuSlotPool {
+private:
+    std::vector<int> free_cpus;         // 当前空闲的 CPU 编号
+    int total_num;                      // 可用于评测的 CPU 总数
+    std::mutex pool_mutex;              // 保护空闲 CPU 列表的互斥锁
+    std::condition_variable pool_cond;  // 等待空闲 CPU 的条件变量
+
+    CpuSlotPool();
+
+    ~CpuSlotPool();
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static CpuSlotPool *GetInstance();
+
+    /**
+     * 功能：申请评测 CPU
+     * 传入：最多申请的 CPU 数目
+     * 传出：申请到的 CPU 编号（至少一个；没有可用于评测的 CPU 时返回空列表，表示不绑定 CPU）
+     */
+    std::vector<int> Acquire(int maxnum);
+
+    // 归还评测 CPU
+    void Release(const std::vector<int> &cpus);
+
+    // 将当前线程绑定到指定的 CPU 上（之后 fork 出的沙箱进程会继承该绑定）
+    static bool BindCurrentThread(int cpu);
+};
+
+#endif  // CPU_SLOT_POOL_H
@@ -0,0 +1,47 @@
+#ifndef JUDGE_RESULT_H
+#define JUDGE_RESULT_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * 判题结果头文件
+ *
+ * 判题机产生的结果直接以数值保存运行时间和内存，并移动（而不是复制）给判题服务和数据库层，
+ * 由 MoDB::UpdateStatusRecord 直接编码为 BSON。测评记录中的格式保持不变（"123MS"、"12MB"、"456B"），
+ * 只在编码时生成。
+ */
+
+// 单个测试用例的判题结果
+struct CaseResult {
+    int status = 0;                  // 测试用例状态
+    int runtime = 0;                 // 运行时间（毫秒）
+    long long runmemory = 0;         // 运行内存（字节）
+    std::string standardinput;       // 标准输入预览
+    int64_t standardinputsize = 0;   // 标准输入的完整大小
+    std::string standardinputhash;   // 标准输入的 SHA-256
+    std::string standardoutput;      // 标准答案预览
+    int64_t standardoutputsize = 0;  // 标准答案的完整大小
+    std::string standardoutputhash;  // 标准答案的 SHA-256
+    std::string personaloutput;      // 用户输出预览
+    int64_t personaloutputsize = 0;  // 用户输出的完整大小
+    std::string personaloutputhash;  // 用户输出的 SHA-256
+    int64_t mismatchline = 0;        // 答案错误时第一个不一致的行号（从 1 开始，0 表示没有）
+    int64_t mismatchcolumn = 0;      // 答案错误时第一个不一致的列号（从 1 开始，0 表示没有）
+};
+
+// 一次提交的判题结果
+struct JudgeResult {
+    std::string statusrecordid;         // 测评记录 ID
+    int status = 0;                     // 判题状态
+    int runtime = 0;                    // 最大运行时间（毫秒）
+    long long runmemory = 0;            // 最大运行内存（字节）
+    int64_t length = 0;                 // 代码长度（字节）
+    std::string compilerinfo;           // 编译信息或错误原因
+    std::vector<CaseResult> testinfo;   // 各测试用例的结果（按编号排列）
+    std::vector<long long> trace;       // 判题阶段耗时（纳秒，见 judger/judge_trace.h）
+    std::vector<long long> tracecases;  // 各测试用例的沙箱运行和判定耗时（纳秒）
+};
+
+#endif  // JUDGE_RESULT_H
@@ -0,0 +1,130 @@
+#ifndef JUDGE_TRACE_H
+#define JUDGE_TRACE_H
+
+#include <json/json.h>
+
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * 判题阶段耗时头文件
+ *
+ * 每次提交的判题过程按阶段记录耗时（纳秒，单调时钟），写入测评记录的 Trace（按阶段编号排列的数组）和
+ * TraceCases（每个测试用例依次为沙箱运行和判定的耗时）字段；判题结束后再按语言和题目汇总为直方图，
+ * 用于定位耗时最多的阶段和发现性能退化。
+ */
+
+// 判题阶段（编号即 Trace 数组中的下标，只在末尾追加新的阶段）
+enum JudgeStage {
+    STAGE_QUEUE,       // 在判题队列中等待
+    STAGE_WORKSPACE,   // 签出评测工作区
+    STAGE_SOURCE,      // 写入源代码
+    STAGE_SPJ,         // 获取 SPJ
+    STAGE_ADMISSION,   // 等待编译准入
+    STAGE_COMPILE,     // 编译（包括从编译缓存中恢复，不包括等待准入）
+    STAGE_RUN_QUEUE,   // 在运行队列中等待
+    STAGE_EXECUTE,     // 运行阶段（并行评测时为实际经过的时间）
+    STAGE_RUN,         // 各测试用例在沙箱中运行的耗时之和
+    STAGE_COMPARE,     // 各测试用例判定结果（比较输出或运行 SPJ）的耗时之和
+    STAGE_RECORD,      // 写入测评记录（此阶段及之后的阶段在写入测评记录时尚未结束，只计入直方图）
+    STAGE_STATISTICS,  // 更新题目和用户的统计信息
+    STAGE_TOTAL,       // 从进入判题队列到判题完成
+    STAGE_COUNT
+};
+
+// 一次提交的判题阶段耗时
+class JudgeTrace {
+public:
+    JudgeTrace();
+
+    // 单调时钟的当前时间（纳秒）
+    static long long Now();
+
+    // 获取阶段名称
+    static const char *GetStageName(int stage);
+
+    // 清空记录的耗时
+    void Reset();
+
+    // 累加阶段耗时
+    void Add(JudgeStage stage, long long ns);
+
+    long long Get(JudgeStage stage) const;
+
+    // 设置测试用例数目（测试用例编号从 1 开始）
+    void SetCaseNum(int casenum);
+
+    // 记录单个测试用例的沙箱运行和判定耗时，并计入 STAGE_RUN 和 STAGE_COMPARE
+    void SetCase(int index, long long runns, long long comparens);
+
+    // 写入测评记录的阶段耗时（STAGE_RECORD 之前的阶段）
+    std::vector<long long> GetRecordStages() const;
+
+    // 写入测评记录的测试用例耗时（每个测试用例两项：沙箱运行、判定）
+    std::vector<long long> GetRecordCases() const;
+
+private:
+    long long stages_[STAGE_COUNT];        // 各阶段耗时
+    std::vector<long long> caseruns_;      // 各测试用例的沙箱运行耗时
+    std::vector<long long> casecompares_;  // 各测试用例的判定耗时
+};
+
+/**
+ * 判题阶段耗时统计
+ *
+ * 按语言和题目分别为每个阶段维护以 2 为底的对数直方图（第 i 个桶统计 [2^i, 2^(i+1)) 纳秒的次数），
+ * 查询时给出次数、平均值、最大值和由桶上界估计的分位数。题目数超过上限后新的题目不再单独统计。
+ */
+class JudgeTraceStats {
+private:
+    // 单个阶段的直方图
+    struct Histogram {
+        long long count;
+        long long sum;
+        long long max;
+        std::vector<long long> buckets;
+    };
+
+    // 一组提交（同一语言或同一题目）的各阶段直方图
+    struct StageHistograms {
+        long long submitnum;
+        std::vector<Histogram> stages;
+    };
+
+    std::map<std::string, StageHistograms> languages;  // 按语言统计
+    std::map<std::string, StageHistograms> problems;   // 按题目统计
+    long long dropped_problem_num;                     // 因题目数达到上限而没有按题目统计的提交数
+    std::mutex stats_mutex;                            // 保护统计数据的互斥锁
+
+    JudgeTraceStats();
+
+    ~JudgeTraceStats();
+
+    // 创建空的各阶段直方图
+    static StageHistograms NewHistograms();
+
+    // 将一次提交计入各阶段直方图
+    static void Merge(StageHistograms &histograms, const JudgeTrace &trace);
+
+    // 各阶段直方图转换为 Json
+    static Json::Value ToJson(const StageHistograms &histograms);
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static JudgeTraceStats *GetInstance();
+
+    // 记录一次提交的判题阶段耗时
+    void Record(const std::string &language, const std::string &problemid, const JudgeTrace &trace);
+
+    /**
+     * 功能：获取判题阶段耗时统计
+     * 传入：题目 ID（为空时不返回按题目的统计）
+     * 传出：Json(Stages, Languages, ProblemNum, DroppedProblemNum, Problem)，其中每组统计为
+     * Json(SubmitNum, 阶段名称: Json(Count, AvgNs, MaxNs, P50Ns, P90Ns, P99Ns, Buckets))
+     */
+    Json::Value GetStats(const std::string &problemid);
+};
+
+#endif  // JUDGE_TRACE_H
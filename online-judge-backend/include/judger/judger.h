@@ -3,31 +3,72 @@
 
 #include <json/json.h>
 
+#include <memory>
 #include <string>
+#include <vector>
 
 #include "constants/judge.h"
+#include "judger/judge_result.h"
+#include "judger/judge_trace.h"
+#include "judger/output_comparator.h"
+#include "judger/testdata_cache.h"
+#include "judger/zygote.h"
+
+// 评测槽位（RunProgram 中并行运行测试用例的单位）
+struct JudgeSlot {
+    int cpu;                         // 绑定的 CPU（-1 表示不绑定）
+    int launcher;                    // 签出的沙箱启动器（-1 表示在本进程内调用 run()）
+    std::string cgroup;              // 槽位的 cgroup 目录（为空表示不使用 cgroup，只用于由启动器运行的测试用例）
+    std::unique_ptr<Zygote> zygote;  // 解释器 zygote（未启用或启动失败时为空）
+};
 
 // 判题机
 class Judger {
 public:
     Judger();
 
+    // 判题中途抛出异常或未调用 Done 时，在析构时归还评测工作区
+    ~Judger();
+
+    Judger(const Judger &) = delete;
+
+    Judger &operator=(const Judger &) = delete;
+
     /**
      * 功能：判题函数
-     * 传入数据：Json(SubmitId, ProblemId, JudgeNum, Code, Language, TimeLimit, MemoryLimit)
-     * 传出数据：Json(Status, RunTime, RunMemory, Length, CompilerInfo, TestInfo(Status, StandardOutput, PersonalOutput,
-     * RunTime, RunMemory))
+     * 传入数据：Json(SubmitId, ProblemId, JudgeNum, JudgeMode, CompareMode, CompareEpsilon, Code, Language, TimeLimit,
+     * MemoryLimit, OutputLimit, EnqueueTime, Rejudge)
+     * 传出数据：JudgeResult（见 judger/judge_result.h）
      */
-    Json::Value Run(Json::Value &runjson);
+    JudgeResult Run(Json::Value &runjson);
+
+    /**
+     * 功能：编译阶段（数据初始化、签出评测工作区并编译），与 Execute 分开调用时由判题服务在不同的线程中执行
+     * 传入数据：同 Run
+     * 传出数据：bool（返回 false 表示判题已经结束，如编译错误或系统错误，直接调用 Done 获取结果）
+     */
+    bool Compile(Json::Value &runjson);
+
+    // 运行阶段：运行并判定所有测试用例，返回判题结果
+    JudgeResult Execute();
+
+    JudgeResult Done();  // 返回结果（归还评测工作区，结果移动给调用者，只能调用一次）
+
+    JudgeTrace &GetTrace();  // 获取判题阶段耗时（判题服务在判题机之外的阶段同样记录在其中）
 
 private:
     // 数据初始化
     bool Init(Json::Value &initjson);
 
-    bool CompileSPJ();  // 编译 SPJ 文件
+    bool CompileSPJ();  // 获取 SPJ 文件（已在修改题目时编译）
 
     bool GetCompilationFailed();  // 获取编译失败的原因
 
+    // 在运行目录中执行编译命令（优先使用编译缓存，可选使用预编译头），只有编译器无法启动时返回 false
+    bool CompileWithCache(const std::vector<std::string> &command, const std::string &versioncmd,
+                          const std::vector<std::string> &artifacts, bool hardlink,
+                          const std::vector<std::string> &pchcommand = {}, bool pchforced = false);
+
     // -----编译-----
     bool CompileC();  // 编译 C
 
@@ -59,37 +100,58 @@ private:
 
     bool RunProgram(struct config *conf);  // 运行程序
 
-    void JudgmentResult(struct result *res, std::string &index);  // 判断结果
+    // 运行单个测试用例（依次尝试槽位的 zygote、沙箱启动器，最后在本进程内运行）
+    void RunCase(struct config *conf, int index, struct result *res, JudgeSlot *slot);
+
+    CaseResult JudgmentResult(struct result *res, const std::string &index);  // 判断单个测试用例结果（可并行调用）
 
-    Json::Value Done();  // 返回结果
+    std::string GetCaseReason(int status, const std::string &index);  // 获取运行时错误或系统错误的原因（可并行调用）
+
+    void MergeResult(CaseResult &caseresult, const std::string &reason);  // 合并单个测试用例结果
+
+    void SkipResult();  // 记录被跳过的测试用例
 
 private:
-    Json::Value m_resjson;  // 存储运行结果的 Json
+    JudgeResult m_judgeresult;  // 判题结果
 
-    std::string RUN_PATH;   // 运行的路径
-    std::string DATA_PATH;  // 存储数据的路径
-    bool m_isspj;           // 是否有 SPJ 文件
+    std::string RUN_PATH;     // 运行的路径（签出的评测工作区）
+    int m_workspace;          // 评测工作区槽位编号
+    std::string DATA_PATH;    // 存储数据的路径
+    bool m_isspj;             // 是否有 SPJ 文件
+    std::string m_spjpath;    // SPJ 可执行文件（本次判题使用的版本）
+    bool m_usezygote;         // 是否由 zygote 运行测试用例（Python2/Python3）
+    bool m_rejudge;           // 是否为重新评测（使用测试用例结果记忆，只运行变化或新增的测试用例）
+    std::string m_binarykey;  // 编译产物的键（编译缓存的键，为空表示不使用测试用例结果记忆）
+
+    std::shared_ptr<const TestData> m_testdata;  // 题目测试数据（从测试数据缓存中获取）
 
     std::string m_statusrecordid;  // 运行 ID
     std::string m_problemid;       // 题目 ID
     int m_judgenum;                // 测试用例数目
+    bool m_stoponfailure;          // 是否遇到首个失败的测试用例即停止评测（ICPC 模式）
+    CompareMode m_comparemode;     // 输出比较模式
+    double m_compareepsilon;       // 浮点数比较的误差（FLOAT 比较模式）
     std::string m_code;            // 代码
 
-    int m_result;            // 运行结果
-    std::string m_reason;    // 错误原因
-    std::string m_command;   // 命令（中间变量）
-    std::string m_language;  // 测评语言
+    int m_result;               // 运行结果
+    std::string m_reason;       // 错误原因
+    std::string m_command;      // 命令（中间变量）
+    std::string m_compileinfo;  // 编译信息（编译时捕获的编译器输出或从编译缓存中恢复）
+    std::string m_language;     // 测评语言
 
-    std::string m_length;  // 代码文件长度
+    long long m_length;  // 代码文件长度（字节）
 
     int m_timelimit;     // 时间限制
     long m_memorylimit;  // 空间限制
+    long m_outputlimit;  // 输出限制（单个测试用例的标准输出和标准错误输出分别计算）
 
     int m_maxtimelimit;     // 最大时间限制
     long m_maxmemorylimie;  // 最大空间限制
 
     int m_runtime;     // 运行时间
     long m_runmemory;  // 运行空间
+
+    JudgeTrace m_trace;  // 判题阶段耗时
 };
 
 #endif
@@ -0,0 +1,59 @@
+#ifndef JVM_CDS_H
+#define JVM_CDS_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * JVM 类数据共享（CDS）头文件
+ *
+ * 判题服务启动时在后台线程中为 JDK 核心类生成 CDS 归档：先用固定的启动参数运行一个使用常见输入输出和集合类的
+ * 预热程序，记录加载的 JDK 类列表，再以同样的参数生成归档（按 java -version 和启动参数的摘要存放在
+ * JVM_CDS_PATH/<摘要>/ 中）。之后的 Java 运行直接映射归档中的类数据，省去类的解析和校验，
+ * 配合固定的启动参数（串行 GC、单处理器、不写 hsperfdata）减少计入用户的启动时间和后台线程的 CPU 时间。
+ * 归档生成完成前（或生成失败时）Java 照常运行，只是不使用归档。
+ */
+class JvmCds {
+private:
+    enum class State { IDLE, BUILDING, READY, FAILED };
+
+    State state;               // 归档状态
+    std::string archive_path;  // 归档文件的绝对路径（READY 时有效）
+    long long build_us;        // 生成归档的耗时（微秒）
+    std::mutex state_mutex;    // 保护归档状态的互斥锁
+
+    std::atomic<long long> hit_num;   // 使用归档运行的次数
+    std::atomic<long long> miss_num;  // 未使用归档运行的次数
+
+    JvmCds();
+
+    ~JvmCds();
+
+    // 生成归档（在后台线程中执行）
+    void Build();
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static JvmCds *GetInstance();
+
+    // 在后台开始生成归档（已经开始或已经完成时直接返回）
+    void Prepare();
+
+    /**
+     * 功能：获取 Java 运行时的固定启动参数
+     * 传出：启动参数（归档可用时包含使用归档的参数）
+     */
+    std::vector<std::string> GetLaunchArgs();
+
+    /**
+     * 功能：获取 CDS 归档的运行状态
+     * 传出：Json(State, ArchivePath, BuildUs, HitNum, MissNum)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // JVM_CDS_H
@@ -0,0 +1,81 @@
+#ifndef LAUNCHER_POOL_H
+#define LAUNCHER_POOL_H
+
+#include <json/json.h>
+#include <sys/types.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "judger/cgroup_sandbox.hpp"
+
+extern "C" {
+#include "judger/runner.h"
+}
+
+/**
+ * 沙箱启动器池头文件
+ *
+ * 启动时通过 posix_spawn（不复制后端进程的页表）启动固定数目的 judge-launcher 进程，每个评测槽位签出一个，
+ * 由它调用沙箱库的 run()，沙箱进程从单线程的小进程中 fork，fork 的开销不再随后端进程的内存增长。
+ * 启动器不可用（可执行文件缺失、异常退出）时返回失败，由判题机在本进程内直接调用 run()；
+ * 异常退出的启动器在下次使用时重新启动。
+ */
+class LauncherPool {
+private:
+    struct Launcher {
+        pid_t pid;  // 启动器进程 ID（-1 表示未运行）
+        int fd;     // 与启动器通信的套接字
+    };
+
+    std::vector<Launcher> launchers;  // 全部启动器
+    std::vector<int> free_launchers;  // 空闲启动器编号
+    std::string launcher_path;        // 启动器可执行文件路径（与后端可执行文件位于同一目录）
+    std::mutex pool_mutex;            // 保护空闲启动器列表的互斥锁
+
+    std::atomic<long long> run_num;       // 由启动器运行的次数
+    std::atomic<long long> fallback_num;  // 启动器不可用、在本进程内运行的次数
+    std::atomic<long long> spawn_num;     // 启动（包括重新启动）启动器的次数
+    std::atomic<long long> crash_num;     // 启动器异常退出的次数
+
+    LauncherPool();
+
+    ~LauncherPool();
+
+    // 启动单个启动器
+    bool Spawn(Launcher &launcher);
+
+    // 停止单个启动器
+    void Stop(Launcher &launcher);
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static LauncherPool *GetInstance();
+
+    /**
+     * 功能：签出一个启动器
+     * 传出：启动器编号（-1 表示没有空闲的启动器或未启用启动器）
+     */
+    int Acquire();
+
+    // 归还启动器
+    void Release(int id);
+
+    /**
+     * 功能：由启动器运行沙箱
+     * 传入：启动器编号、绑定的 CPU（-1 表示不绑定）、沙箱 cgroup（slot 为空表示不使用）、沙箱配置
+     * 传出：是否由启动器完成运行（失败时 res 未填写，需要在本进程内调用 run()）、运行结果
+     */
+    bool Run(int id, int cpu, const cgroup_sandbox::SandboxCgroup &cgroup, const struct config *conf,
+             struct result *res);
+
+    /**
+     * 功能：获取启动器池的运行状态
+     * 传出：Json(LauncherNum, FreeNum, RunNum, FallbackNum, SpawnNum, CrashNum)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // LAUNCHER_POOL_H
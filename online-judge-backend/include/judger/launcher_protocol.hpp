@@ -0,0 +1,181 @@
+#pragma once
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdint>
+#include <cstring>
+#include <deque>
+#include <string>
+
+#include "judger/cgroup_sandbox.hpp"
+
+extern "C" {
+#include "judger/runner.h"
+}
+
+/**
+ * 沙箱启动器通信协议
+ * 后端与 judge-launcher 之间通过 UNIX 套接字交换数据：请求为 4 字节长度加序列化的沙箱配置和沙箱 cgroup
+ * （整数按本机字节序，字符串以 4 字节长度为前缀，空指针的长度为 UINT32_MAX），结果为原样的 Response
+ */
+namespace launcher_protocol {
+
+constexpr uint32_t NULL_STRING = UINT32_MAX;
+
+// 运行结果
+struct Response {
+    struct result res;  // 沙箱库的运行结果（使用 cgroup 时 CPU 时间和内存取自 cgroup 的统计）
+    int32_t accounted;  // 是否使用了 cgroup 的统计
+    int32_t oomkilled;  // 是否被 cgroup 的 memory.max 终止
+};
+
+inline void PutInt(std::string& data, int64_t value) { data.append((const char*)&value, sizeof(value)); }
+
+inline void PutString(std::string& data, const char* value) {
+    uint32_t len = value == nullptr ? NULL_STRING : (uint32_t)strlen(value);
+    data.append((const char*)&len, sizeof(len));
+    if (value != nullptr) {
+        data.append(value, len);
+    }
+}
+
+inline bool GetInt(const std::string& data, size_t& pos, int64_t& value) {
+    if (pos + sizeof(value) > data.size()) {
+        return false;
+    }
+    memcpy(&value, data.data() + pos, sizeof(value));
+    pos += sizeof(value);
+    return true;
+}
+
+// 字符串保存在 storage 中（deque 追加元素时不会使已有元素的地址失效）
+inline bool GetString(const std::string& data, size_t& pos, std::deque<std::string>& storage, char*& value) {
+    uint32_t len;
+    if (pos + sizeof(len) > data.size()) {
+        return false;
+    }
+    memcpy(&len, data.data() + pos, sizeof(len));
+    pos += sizeof(len);
+    if (len == NULL_STRING) {
+        value = nullptr;
+        return true;
+    }
+    if (pos + len > data.size()) {
+        return false;
+    }
+    storage.emplace_back(data, pos, len);
+    value = (char*)storage.back().data();
+    pos += len;
+    return true;
+}
+
+// 序列化沙箱配置（cpu 为启动器运行时绑定的 CPU，-1 表示不绑定；cgroup.slot 为空表示不使用 cgroup）
+inline std::string EncodeRequest(int cpu, const cgroup_sandbox::SandboxCgroup& cgroup, const struct config& conf) {
+    std::string data;
+    PutString(data, cgroup.slot.data());
+    PutString(data, cgroup.home.data());
+    for (int64_t value : {(int64_t)cpu, cgroup.memorymax, cgroup.pidsmax, (int64_t)conf.max_cpu_time,
+                          (int64_t)conf.max_real_time, (int64_t)conf.max_memory, (int64_t)conf.max_stack,
+                          (int64_t)conf.max_process_number, (int64_t)conf.max_output_size,
+                          (int64_t)conf.memory_limit_check_only, (int64_t)conf.uid, (int64_t)conf.gid}) {
+        PutInt(data, value);
+    }
+    for (const char* value : {conf.exe_path, conf.input_path, conf.output_path, conf.error_path, conf.log_path,
+                              conf.seccomp_rule_name}) {
+        PutString(data, value);
+    }
+    // args 和 env 以空指针结尾
+    for (int i = 0; i < ARGS_MAX_NUMBER && conf.args[i] != nullptr; i++) {
+        PutString(data, conf.args[i]);
+    }
+    PutString(data, nullptr);
+    for (int i = 0; i < ENV_MAX_NUMBER && conf.env[i] != nullptr; i++) {
+        PutString(data, conf.env[i]);
+    }
+    PutString(data, nullptr);
+    return data;
+}
+
+// 反序列化沙箱配置
+inline bool DecodeRequest(const std::string& data, int& cpu, cgroup_sandbox::SandboxCgroup& cgroup,
+                          struct config& conf, std::deque<std::string>& storage) {
+    size_t pos = 0;
+    char *slot, *home;
+    if (!GetString(data, pos, storage, slot) || !GetString(data, pos, storage, home) || slot == nullptr ||
+        home == nullptr) {
+        return false;
+    }
+    int64_t values[12];
+    for (int64_t& value : values) {
+        if (!GetInt(data, pos, value)) {
+            return false;
+        }
+    }
+    conf = {};
+    cpu = (int)values[0];
+    cgroup = {slot, home, values[1], values[2]};
+    conf.max_cpu_time = (int)values[3];
+    conf.max_real_time = (int)values[4];
+    conf.max_memory = (long)values[5];
+    conf.max_stack = (long)values[6];
+    conf.max_process_number = (int)values[7];
+    conf.max_output_size = (long)values[8];
+    conf.memory_limit_check_only = (int)values[9];
+    conf.uid = (uid_t)values[10];
+    conf.gid = (gid_t)values[11];
+    for (char** value : {&conf.exe_path, &conf.input_path, &conf.output_path, &conf.error_path, &conf.log_path,
+                         &conf.seccomp_rule_name}) {
+        if (!GetString(data, pos, storage, *value)) {
+            return false;
+        }
+    }
+    for (char** list : {conf.args, conf.env}) {
+        int maxnum = list == conf.args ? ARGS_MAX_NUMBER : ENV_MAX_NUMBER;
+        for (int i = 0;; i++) {
+            if (i == maxnum || !GetString(data, pos, storage, list[i])) {
+                return false;
+            }
+            if (list[i] == nullptr) {
+                break;
+            }
+        }
+    }
+    return pos == data.size();
+}
+
+// 写入全部数据（对端关闭时返回 false，不产生 SIGPIPE）
+inline bool WriteAll(int fd, const void* data, size_t len) {
+    const char* p = (const char*)data;
+    while (len > 0) {
+        ssize_t n = send(fd, p, len, MSG_NOSIGNAL);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+// 读取全部数据（对端关闭时返回 false）
+inline bool ReadAll(int fd, void* data, size_t len) {
+    char* p = (char*)data;
+    while (len > 0) {
+        ssize_t n = read(fd, p, len);
+        if (n < 0 && errno == EINTR) {
+            continue;
+        }
+        if (n <= 0) {
+            return false;
+        }
+        p += n;
+        len -= n;
+    }
+    return true;
+}
+
+}  // namespace launcher_protocol
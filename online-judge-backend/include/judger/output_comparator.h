@@ -0,0 +1,90 @@
+#ifndef OUTPUT_COMPARATOR_H
+#define OUTPUT_COMPARATOR_H
+
+#include <cstddef>
+#include <string>
+
+#include "constants/judge.h"
+
+/**
+ * 输出比较器头文件
+ *
+ * 通过 mmap 映射标准答案和用户输出，先按块用 memcmp 比较公共前缀（glibc 的 memcmp 使用 SIMD 实现），
+ * 只有在出现差异时才回退到差异所在的行（或单词）按比较模式逐字节比较，不需要把文件读入内存，
+ * 也不会在遇到输出中的 '\0' 时提前结束。
+ *
+ * 浮点数误差、忽略大小写、行乱序和 yes/no 等常见的特殊判题也作为比较模式在判题进程内完成，
+ * 不需要为每个测试用例启动外部 SPJ 进程，外部 SPJ 只用于真正需要自定义逻辑的题目。
+ */
+
+// 只读映射的文件
+class MappedFile {
+public:
+    MappedFile() : data_(""), size_(0) {}
+
+    ~MappedFile();
+
+    MappedFile(const MappedFile &) = delete;
+
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    // 映射文件，文件不存在或无法读取时返回 false 并按空文件处理（populate 为 true 时预先读入全部页面）
+    bool Open(const std::string &path, bool populate = false);
+
+    // 将映射的页面锁定在内存中，避免被换出（受 RLIMIT_MEMLOCK 限制，失败时返回 false）
+    bool Lock();
+
+    const char *Data() const { return data_; }
+
+    size_t Size() const { return size_; }
+
+private:
+    const char *data_;
+    size_t size_;
+};
+
+// 比较模式
+enum class CompareMode {
+    EXACT,            // 逐字节完全一致
+    TRAILING,         // 忽略每行行末的空白字符和文件末尾的空行（默认）
+    LINE,             // 按行比较，忽略每行首尾的空白字符和文件末尾的空行
+    TOKEN,            // 按空白字符分隔的单词比较，忽略空白字符的数量和换行位置
+    TOKEN_CASELESS,   // 按单词比较，忽略大小写
+    FLOAT,            // 按单词比较，两个单词都是数字时允许绝对误差或相对误差不超过 epsilon
+    UNORDERED_LINES,  // 忽略行的顺序（每行忽略行末空白字符，忽略空行）
+    YES_NO            // 按单词比较，忽略大小写，用户输出的每个单词必须是 yes 或 no
+};
+
+// 比较结果
+struct CompareResult {
+    bool equal;     // 是否一致
+    size_t line;    // 第一个不一致的位置在用户输出中的行号（从 1 开始，一致时为 0）
+    size_t column;  // 第一个不一致的位置在用户输出中的列号（从 1 开始，一致时为 0）
+};
+
+class OutputComparator {
+public:
+    // 将比较模式名称（见 constants::judge::COMPARE_MODE_*）转换为比较模式，无法识别时使用默认模式
+    static CompareMode ParseMode(const std::string &name);
+
+    // 获取比较模式的名称（与 ParseMode 互逆，用于规范化题目中保存的比较模式）
+    static const char *ModeName(CompareMode mode);
+
+    /**
+     * 功能：比较内存中的标准答案和用户输出
+     * 传入：标准答案、用户输出、比较模式、浮点数比较的误差（只用于 FLOAT 模式）
+     * 传出：比较结果
+     */
+    static CompareResult Compare(const char *expected, size_t expectedlen, const char *actual, size_t actuallen,
+                                 CompareMode mode, double epsilon = constants::judge::COMPARE_FLOAT_EPSILON);
+
+    /**
+     * 功能：比较标准答案文件和用户输出文件
+     * 传入：标准答案路径、用户输出路径、比较模式、浮点数比较的误差
+     * 传出：比较结果（用户输出文件不存在时按空输出比较，标准答案不存在时视为不一致）
+     */
+    static CompareResult CompareFiles(const std::string &expectedpath, const std::string &actualpath,
+                                      CompareMode mode, double epsilon = constants::judge::COMPARE_FLOAT_EPSILON);
+};
+
+#endif  // OUTPUT_COMPARATOR_H
@@ -0,0 +1,79 @@
+#ifndef PCH_CACHE_H
+#define PCH_CACHE_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+/**
+ * 预编译头缓存头文件
+ *
+ * 为 C++ 提交中常见的头文件组合（<bits/stdc++.h> 和常用 STL 头文件）按编译器版本和编译选项维护预编译头，
+ * 存放在 PCH_CACHE_PATH/<摘要> 中，编译器升级或编译选项变化后摘要随之变化并重新生成。
+ * 预编译头在后台线程中生成（先生成到临时目录再 rename），生成完成前的提交照常编译，不会被阻塞。
+ *
+ * 提交的 #include 与某个头文件组合匹配时：
+ * - <bits/stdc++.h>：通过 -I 让 g++ 在查找该头文件时先找到同名的 .gch，语义与不使用预编译头完全相同；
+ * - 常用 STL 头文件：通过 -include 预先包含整个组合，可能引入提交中未包含的名字，编译失败时回退为普通编译。
+ */
+class PchCache {
+public:
+    // 预编译头的使用方式
+    struct Usage {
+        std::vector<std::string> args;  // 追加的编译选项（不使用预编译头时为空）
+        bool forced;                    // 是否通过 -include 强制包含（编译失败时需要回退为普通编译）
+    };
+
+private:
+    enum class State { BUILDING, READY, FAILED };
+
+    std::unordered_map<std::string, State> states;  // 各预编译头的状态（按摘要）
+    std::mutex state_mutex;                         // 保护 states 的互斥锁
+
+    std::string compiler_path;  // g++ 的实际路径（用于检测编译器升级）
+
+    std::atomic<long long> hit_num;         // 使用预编译头编译的次数
+    std::atomic<long long> miss_num;        // 未使用预编译头编译的次数
+    std::atomic<long long> fallback_num;    // 强制包含后编译失败、回退为普通编译的次数
+    std::atomic<long long> build_num;       // 生成预编译头的次数
+    std::atomic<long long> build_fail_num;  // 生成预编译头失败的次数
+    std::atomic<long long> hit_total_us;    // 使用预编译头时的总编译耗时（微秒）
+    std::atomic<long long> miss_total_us;   // 未使用预编译头时的总编译耗时（微秒）
+
+    PchCache();
+
+    ~PchCache();
+
+    // 在后台线程中生成预编译头
+    void Build(const std::string &key, const std::string &header, const std::string &flags, bool bits);
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static PchCache *GetInstance();
+
+    /**
+     * 功能：根据提交的源代码选择可用的预编译头（尚未生成时在后台开始生成）
+     * 传入：编译选项（必须与生成预编译头时的选项一致）、源代码
+     * 传出：预编译头的使用方式
+     */
+    Usage Select(const std::string &flags, const std::string &source);
+
+    /**
+     * 功能：记录一次 C++ 编译的耗时
+     * 传入：是否使用了预编译头、是否回退为普通编译、耗时（微秒）
+     */
+    void Record(bool hit, bool fallback, long long us);
+
+    /**
+     * 功能：获取预编译头缓存的运行状态
+     * 传出：Json(ReadyNum, HitNum, MissNum, FallbackNum, BuildNum, BuildFailNum, AvgCompileUsWithPch,
+     * AvgCompileUsWithoutPch)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // PCH_CACHE_H
@@ -0,0 +1,55 @@
+#ifndef SPJ_CACHE_H
+#define SPJ_CACHE_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <mutex>
+#include <string>
+
+/**
+ * SPJ 缓存头文件
+ *
+ * 在创建或修改题目时编译 SPJ（spj.cpp），编译产物按源代码、编译器版本和编译选项的摘要存放在
+ * SPJ_CACHE_PATH/<摘要> 中（先编译到临时文件再 rename，保证可见的文件总是完整的），
+ * 题目数据目录中的 spj 是指向该版本的符号链接，同样通过 rename 原子替换。
+ * 判题时只解析符号链接并执行已经编译好的 SPJ，不会在判题的关键路径上编译。
+ */
+class SpjCache {
+private:
+    std::mutex build_mutex;  // 串行化编译，避免同时编译相同的 SPJ
+
+    std::atomic<long long> build_num;  // 编译次数
+    std::atomic<long long> reuse_num;  // 复用已有编译产物的次数
+    std::atomic<long long> fail_num;   // 编译失败次数
+
+    SpjCache();
+
+    ~SpjCache();
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static SpjCache *GetInstance();
+
+    /**
+     * 功能：编译题目的 SPJ 并将题目数据目录中的 spj 指向编译产物（没有 spj.cpp 时删除 spj）
+     * 传入：题目 ID、数据目录（以 / 结尾，为空时使用题目当前的数据目录；提交新的数据版本时为新版本目录）
+     * 传出：是否成功，编译失败时 compileinfo 为编译器输出
+     */
+    bool Build(const std::string &problemid, std::string &compileinfo, const std::string &datapath = "");
+
+    /**
+     * 功能：获取题目当前版本的 SPJ 可执行文件
+     * 传入：题目 ID、数据目录（为空时使用题目当前的数据目录）
+     * 传出：SPJ 可执行文件的绝对路径（符号链接已解析），题目没有 SPJ 时返回空字符串
+     */
+    std::string Resolve(const std::string &problemid, const std::string &datapath = "");
+
+    /**
+     * 功能：获取 SPJ 缓存的运行状态
+     * 传出：Json(BuildNum, ReuseNum, FailNum)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // SPJ_CACHE_H
@@ -0,0 +1,59 @@
+#ifndef SUBPROCESS_H
+#define SUBPROCESS_H
+
+#include <string>
+#include <vector>
+
+/**
+ * 子进程工具头文件
+ *
+ * 以参数数组直接启动编译器、SPJ 等子进程（vfork + execve，不经过 /bin/sh 和 timeout），
+ * 在子进程中设置工作目录和资源限制，超出实际运行时间后杀死整个进程组，
+ * 标准错误输出（可选合并标准输出）通过管道读入有上限的缓冲区，不再写入文件后读回。
+ */
+
+// 子进程选项
+struct SubprocessOptions {
+    std::string workdir;           // 工作目录（为空时不切换）
+    std::string stdinpath;         // 标准输入文件（为空时为 /dev/null）
+    std::string stdoutpath;        // 标准输出文件（为空时为 /dev/null）
+    bool mergestdout = false;      // 是否将标准输出也读入捕获缓冲区（忽略 stdoutpath）
+    int timeout = -1;              // 实际运行时间限制（毫秒，-1 表示不限）
+    long long cpulimit = -1;       // CPU 时间限制（秒，-1 表示不限）
+    long long memorylimit = -1;    // 地址空间限制（字节，-1 表示不限）
+    long long outputlimit = -1;    // 单个文件的大小限制（字节，-1 表示不限）
+    size_t maxcapture = 64 << 10;  // 捕获缓冲区上限（超出的部分读出后丢弃）
+};
+
+// 子进程运行结果
+struct SubprocessResult {
+    bool started = false;    // 是否成功启动（可执行文件不存在等情况为 false）
+    bool timedout = false;   // 是否因超出实际运行时间被杀死
+    int status = 0;          // waitpid 得到的状态
+    std::string output;      // 捕获的输出
+    bool truncated = false;  // 捕获的输出是否被截断
+
+    // 是否正常退出且退出码为 0
+    bool Success() const;
+
+    // 是否正常退出（退出码可以不为 0），未启动、超时或被信号杀死时为 false
+    bool Exited() const;
+};
+
+class Subprocess {
+public:
+    /**
+     * 功能：运行子进程并等待其结束
+     * 传入：参数数组（argv[0] 不含 / 时在 PATH 中查找）、子进程选项
+     * 传出：运行结果
+     */
+    static SubprocessResult Run(const std::vector<std::string> &argv, const SubprocessOptions &options = {});
+
+    // 按空白字符拆分编译选项（选项中不含引号和转义）
+    static std::vector<std::string> Split(const std::string &flags);
+
+    // 将参数数组拼接为便于阅读的命令（用于日志和缓存键，不用于执行）
+    static std::string Join(const std::vector<std::string> &argv);
+};
+
+#endif  // SUBPROCESS_H
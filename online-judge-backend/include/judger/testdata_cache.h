@@ -0,0 +1,136 @@
+#ifndef TESTDATA_CACHE_H
+#define TESTDATA_CACHE_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "judger/output_comparator.h"
+#include "judger/testdata_pack.h"
+
+/**
+ * 测试数据缓存头文件
+ *
+ * 按题目缓存 mmap 映射（并尽量 mlock 锁定）的测试数据，判题时标准答案和标准输入直接从映射中读取，
+ * 沙箱通过路径打开的输入文件也始终命中已锁定的页缓存。缓存项以题目数据目录（解析符号链接后的版本目录）的修改时间
+ * 作为版本，版本目录中有清单时直接使用其中的哈希，不再重新计算。每份测试数据在释放前一直登记使用其版本目录
+ * （见 TestDataStore::AcquireVersion），期间提交新版本也不会删除它。题目数据更新或删除时由 ProblemService 主动失效，
+ * 总大小超过上限后按最近最少使用的顺序淘汰。
+ * 测试用例打包存放时，加载时将其流式导出到内存文件系统中（沙箱只能按路径打开标准输入），再像单独存放的文件一样映射。
+ * 导出目录由同一数据版本的全部测试数据共享，超过缓存上限而不缓存的题目也只导出一次：最近使用的导出目录在
+ * TESTDATA_EXTRACT_MAX_BYTES 以内保留，淘汰后在最后一个使用者释放时删除。导出失败或文件大小与清单不一致时，
+ * 测试数据标记为不完整且不缓存，判题结果为系统错误。
+ */
+
+// 从数据包导出的测试用例目录（由同一数据版本的测试数据共享，最后一个引用释放时删除）
+struct TestDataExtraction {
+    ~TestDataExtraction();
+
+    std::string datapath;  // 数据目录（版本目录）
+    std::string casepath;  // 导出目录（以 / 结尾）
+    long long bytes;       // 导出的字节数
+    bool done;             // 是否已完成导出
+    bool ok;               // 是否全部导出成功
+    std::mutex mutex;      // 串行化导出，同一版本并发加载时只导出一次
+};
+
+// 一个题目的全部测试数据（只读，判题期间由判题机持有，缓存失效不影响正在进行的判题）
+struct TestData {
+    ~TestData();
+
+    long long version;                                 // 数据版本（数据目录的修改时间，纳秒）
+    std::string datapath;                              // 数据目录（以 / 结尾，符号链接已解析为版本目录）
+    std::string casepath;                              // 测试用例文件所在的目录（打包存放时为导出目录）
+    std::shared_ptr<TestDataExtraction> extraction;    // 测试用例的导出目录（单独存放时为空）
+    bool acquired;                                     // 是否登记了版本目录的使用（释放时取消登记）
+    bool complete;                                     // 测试用例是否完整（为 false 时不能用于判题）
+    std::vector<std::unique_ptr<MappedFile>> inputs;   // 标准输入，下标从 1 开始
+    std::vector<std::unique_ptr<MappedFile>> outputs;  // 标准答案，下标从 1 开始
+    std::vector<bool> hasoutput;                       // 标准答案文件是否存在
+    std::vector<std::string> inputhashes;              // 标准输入的 SHA-256
+    std::vector<std::string> outputhashes;             // 标准答案的 SHA-256
+    long long bytes;                                   // 映射的总字节数
+    bool locked;                                       // 是否已全部锁定在内存中
+};
+
+class TestDataCache {
+private:
+    struct Entry {
+        std::shared_ptr<const TestData> data;   // 测试数据
+        std::list<std::string>::iterator iter;  // 在 LRU 链表中的位置
+    };
+
+    struct ExtractionEntry {
+        std::shared_ptr<TestDataExtraction> extraction;  // 导出目录
+        std::list<std::string>::iterator iter;           // 在导出目录 LRU 链表中的位置
+    };
+
+    std::unordered_map<std::string, Entry> entries;  // 缓存项（按题目 ID）
+    std::list<std::string> lru;                      // 最近使用的题目在前
+    long long total_bytes;                           // 缓存总大小
+    std::mutex cache_mutex;                          // 保护缓存和保留的导出目录的互斥锁
+
+    std::unordered_map<std::string, ExtractionEntry> extractions;  // 保留的导出目录（按题目 ID，只保留最近的版本）
+    std::list<std::string> extract_lru;                            // 最近使用的导出目录在前
+    long long extract_bytes;                                       // 保留的导出目录总大小
+
+    std::atomic<long long> hit_num;           // 命中次数
+    std::atomic<long long> miss_num;          // 未命中次数
+    std::atomic<long long> lock_fail_num;     // mlock 失败次数
+    std::atomic<long long> invalidate_num;    // 主动失效次数
+    std::atomic<long long> extract_seq;       // 导出目录序号
+    std::atomic<long long> extract_num;       // 从数据包导出测试用例的次数
+    std::atomic<long long> extract_fail_num;  // 导出失败的次数
+    std::atomic<long long> extract_hit_num;   // 复用已导出目录的次数
+    std::atomic<long long> incomplete_num;    // 加载到不完整测试数据的次数
+
+    TestDataCache();
+
+    ~TestDataCache();
+
+    // 从磁盘加载一个题目的测试数据
+    std::shared_ptr<const TestData> Load(const std::string &problemid, const std::string &datapath, int judgenum,
+                                         long long version, bool acquired);
+
+    // 获取数据版本的导出目录，尚未导出时从数据包导出（同一版本只导出一次）
+    std::shared_ptr<TestDataExtraction> Extract(const std::string &problemid, const std::string &datapath,
+                                                const TestDataPack &pack);
+
+    // 移除保留的导出目录（需持有 cache_mutex，使用者释放后才真正删除）
+    void DropExtraction(const std::string &problemid);
+
+    // 获取数据目录的版本（目录的修改时间，目录不存在时返回 -1）
+    static long long GetPathVersion(const std::string &datapath);
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static TestDataCache *GetInstance();
+
+    // 获取题目数据的版本（数据目录的修改时间，目录不存在时返回 -1）
+    static long long GetVersion(const std::string &problemid);
+
+    /**
+     * 功能：获取题目的测试数据（未命中或版本不一致时重新加载）
+     * 传入：题目 ID、测试用例数目
+     * 传出：测试数据（缺失的文件按空文件处理，缺失的标准答案记录在 hasoutput 中；complete 为 false 时不能用于判题）
+     */
+    std::shared_ptr<const TestData> Get(const std::string &problemid, int judgenum);
+
+    // 使题目的测试数据缓存失效（题目更新或删除时调用）
+    void Invalidate(const std::string &problemid);
+
+    /**
+     * 功能：获取测试数据缓存的运行状态
+     * 传出：Json(EntryNum, TotalBytes, MaxBytes, HitNum, MissNum, LockFailNum, InvalidateNum, IncompleteNum,
+     * ExtractEntryNum, ExtractBytes, ExtractNum, ExtractFailNum, ExtractHitNum)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // TESTDATA_CACHE_H
@@ -0,0 +1,134 @@
+#ifndef TESTDATA_PACK_H
+#define TESTDATA_PACK_H
+
+#include <stdint.h>
+
+#include <functional>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "judger/output_comparator.h"
+
+/**
+ * 测试数据包头文件
+ *
+ * 一个数据版本的全部测试用例打包为单个文件（版本目录中的 TESTDATA_PACK_NAME），避免判题和复制数据时逐个打开
+ * 大量小文件。文件开头是固定大小的头部和索引，之后是各文件的数据：
+ *   PackHeader（64 字节）| PackEntry × capacity（每项 128 字节，前 entrynum 项有效）| 数据（每项按 64 字节对齐）
+ * 索引记录文件名、数据的偏移和大小、原始大小、SHA-256 以及是否经过 zstd 压缩（每个文件单独压缩，
+ * 压缩后收益不足时按原样存放）。所有整数均为小端序。
+ * 读取时 mmap 整个文件：未压缩的文件可以直接随机访问，压缩的文件按块流式解压。
+ */
+
+constexpr char PACK_MAGIC[8] = {'O', 'J', 'P', 'A', 'C', 'K', '\0', '\0'};  // 文件头标识
+constexpr uint32_t PACK_FORMAT_VERSION = 1;                                   // 格式版本
+constexpr uint32_t PACK_FLAG_ZSTD = 1;                                        // 数据经过 zstd 压缩
+
+// 文件头部
+struct PackHeader {
+    char magic[8];        // 文件头标识 PACK_MAGIC
+    uint32_t version;     // 格式版本
+    uint32_t entrynum;    // 有效的索引项数目
+    uint32_t capacity;    // 索引项的数目（写入时预留）
+    uint32_t reserved0;   // 保留
+    uint64_t dataoffset;  // 数据区的起始偏移
+    uint64_t filesize;    // 文件总大小
+    char reserved[24];    // 保留
+};
+
+// 索引项
+struct PackEntry {
+    char name[32];        // 文件名（以 '\0' 结尾）
+    uint64_t offset;      // 数据的偏移
+    uint64_t storedsize;  // 存放的字节数（压缩后）
+    uint64_t rawsize;     // 原始字节数
+    uint32_t flags;       // PACK_FLAG_*
+    uint32_t reserved0;   // 保留
+    char hash[64];        // 原始内容的 SHA-256（十六进制）
+};
+
+static_assert(sizeof(PackHeader) == 64, "PackHeader must be 64 bytes");
+static_assert(sizeof(PackEntry) == 128, "PackEntry must be 128 bytes");
+
+// 测试数据包的只读视图
+class TestDataPack {
+public:
+    // 映射并校验数据包，文件不存在或格式错误时返回 false
+    bool Open(const std::string &path);
+
+    // 查找文件的索引项，不存在时返回 nullptr
+    const PackEntry *Find(const std::string &name) const;
+
+    // 全部索引项（按写入顺序）
+    std::vector<const PackEntry *> Entries() const;
+
+    /**
+     * 功能：顺序读取一个文件原始内容的一段（压缩的文件从头按块解压，跳过偏移之前的部分），判题时用它导出测试用例，
+     * 管理员下载测试用例时用它按范围发送
+     * 传入：文件名、偏移、最大长度、接收数据块的回调（返回 false 时停止）
+     * 传出：是否完整读取（偏移超出文件大小时不调用回调）
+     */
+    bool Stream(const std::string &name, size_t offset, size_t length,
+                const std::function<bool(const char *, size_t)> &sink) const;
+
+    // 读取一个文件原始内容的一段（未压缩的文件直接从映射中复制）
+    bool Read(const std::string &name, size_t offset, size_t length, std::string &content) const;
+
+    // 将一个文件的原始内容写到指定路径
+    bool Extract(const std::string &name, const std::string &path) const;
+
+    // 数据包的映射（复制索引项时直接拷贝存放的字节）
+    const char *Data() const { return file_.Data(); }
+
+    size_t Size() const { return file_.Size(); }
+
+private:
+    MappedFile file_;                                    // 整个数据包的映射
+    const PackEntry *entries_ = nullptr;                 // 索引
+    uint32_t entrynum_ = 0;                              // 有效的索引项数目
+    std::unordered_map<std::string, uint32_t> indexes_;  // 文件名到索引项的映射
+};
+
+// 测试数据包的写入器（写入版本目录中尚未发布的新文件，不需要原子替换）
+class TestDataPackWriter {
+public:
+    TestDataPackWriter() = default;
+
+    ~TestDataPackWriter();
+
+    TestDataPackWriter(const TestDataPackWriter &) = delete;
+
+    TestDataPackWriter &operator=(const TestDataPackWriter &) = delete;
+
+    // 创建数据包并预留 capacity 个索引项
+    bool Open(const std::string &path, uint32_t capacity);
+
+    /**
+     * 功能：加入一个文件
+     * 传入：文件名、源文件路径、原始内容的 SHA-256（为空时计算）、是否尝试压缩
+     */
+    bool AddFile(const std::string &name, const std::string &srcpath, const std::string &hash, bool compress);
+
+    // 从另一个数据包原样复制一个文件（不重新压缩），以 newname 加入（测试用例重新编号时与原文件名不同）
+    bool CopyEntry(const TestDataPack &pack, const std::string &name, const std::string &newname);
+
+    // 写入头部和索引并关闭文件
+    bool Finish();
+
+private:
+    // 追加一个索引项，数据已写入 offset 处
+    bool AddEntry(const std::string &name, uint64_t storedsize, uint64_t rawsize, uint32_t flags,
+                  const std::string &hash);
+
+    // 在当前位置写入数据
+    bool Write(const char *data, size_t size);
+
+    int fd_ = -1;                     // 数据包的文件描述符
+    uint32_t capacity_ = 0;           // 预留的索引项数目
+    uint64_t offset_ = 0;             // 下一个文件的写入位置
+    uint64_t dataoffset_ = 0;         // 数据区的起始偏移
+    std::vector<PackEntry> entries_;  // 已加入的索引项
+};
+
+#endif  // TESTDATA_PACK_H
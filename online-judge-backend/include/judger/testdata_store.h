@@ -0,0 +1,135 @@
+#ifndef TESTDATA_STORE_H
+#define TESTDATA_STORE_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+
+/**
+ * 测试数据存储头文件
+ *
+ * 题目数据按版本存放在 PROBLEM_DATA_PREFIX/<题目 ID>@<版本>/ 中，PROBLEM_DATA_PREFIX/<题目 ID> 是指向当前版本的
+ * 符号链接。每个版本目录中有一份清单 manifest.json，记录每个测试用例输入和标准答案的大小和 SHA-256。
+ * 上传时只需传入内容变化的文件：先写入暂存目录，提交时与当前版本的清单比较，未变化的文件以硬链接复用，
+ * 生成新的版本目录后通过 rename 符号链接原子切换，正在判题的提交继续使用已解析的旧版本目录。
+ * 保留当前和上一个版本，更早的版本在提交时删除；判题通过 AcquireVersion 登记正在使用的版本目录，
+ * 仍被使用的版本推迟到最后一个使用者释放时删除。引入版本目录之前的题目数据目录视为版本 0，
+ * 第一次提交时迁移为版本目录。
+ * 测试用例默认打包为版本目录中的单个数据包（见 judger/testdata_pack.h），SPJ 源文件和编译产物的链接单独存放。
+ */
+class TestDataStore {
+private:
+    std::mutex commit_mutex;  // 串行化提交，同一时刻只有一个提交在生成和切换数据版本
+
+    std::mutex version_mutex;                           // 保护版本目录的使用登记
+    std::unordered_map<std::string, int> version_refs;  // 正在使用的版本目录及其使用者数目
+    std::unordered_set<std::string> retired_paths;      // 已被替换、等待最后一个使用者释放后删除的版本目录
+
+    std::atomic<long long> staging_seq;    // 暂存目录序号
+    std::atomic<long long> commit_num;     // 生成新版本的提交次数
+    std::atomic<long long> unchanged_num;  // 内容未变化、未生成新版本的提交次数
+    std::atomic<long long> written_num;    // 写入新版本的文件数
+    std::atomic<long long> written_bytes;  // 写入新版本的字节数
+    std::atomic<long long> reused_num;     // 从上一个版本复用的文件数
+    std::atomic<long long> deferred_num;   // 因仍在使用而推迟删除的版本数
+
+    TestDataStore();
+
+    ~TestDataStore();
+
+    // 计算文件的大小和 SHA-256（文件不存在时返回 false）
+    static bool HashFile(const std::string &path, long long &size, std::string &hash);
+
+    // 删除已被替换的版本目录，仍在使用时推迟到最后一个使用者释放时删除
+    void RetireVersion(const std::string &datapath);
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static TestDataStore *GetInstance();
+
+    // 题目 ID 是否合法（只允许数字，避免拼接出数据目录之外的路径）
+    static bool IsValidProblemId(const std::string &problemid);
+
+    // 是否为可上传的测试数据文件名（<序号>.in、<序号>.out 或 spj.cpp，序号不超过 TESTDATA_MAX_CASES）
+    static bool IsDataFileName(const std::string &name);
+
+    /**
+     * 功能：解析题目当前版本的数据目录
+     * 传入：题目 ID
+     * 传出：数据目录（以 / 结尾，符号链接已解析为版本目录），题目数据不存在时返回 false
+     */
+    static bool Resolve(const std::string &problemid, std::string &datapath);
+
+    /**
+     * 功能：解析题目当前版本的数据目录并登记使用，登记期间该版本目录不会被之后的提交删除
+     * 传入：题目 ID
+     * 传出：同 Resolve，返回 true 时使用完毕后必须调用 ReleaseVersion
+     */
+    bool AcquireVersion(const std::string &problemid, std::string &datapath);
+
+    // 取消版本目录的使用登记，已被替换的版本在最后一个使用者释放时删除
+    void ReleaseVersion(const std::string &datapath);
+
+    /**
+     * 功能：读取数据目录的清单（没有清单的旧数据目录按文件内容生成，版本为 0）
+     * 传出：Json(Version, JudgeNum, Packed, Cases[Index, InputSize, InputHash, OutputSize, OutputHash],
+     * SPJ(Size, Hash))，缺失的文件大小为 0、哈希为空字符串，没有 SPJ 时 SPJ 为 null
+     */
+    static Json::Value LoadManifest(const std::string &datapath);
+
+    // 获取数据目录中一个文件的原始大小（测试用例在数据包中时从索引获取），文件不存在时返回 -1
+    static long long GetFileSize(const std::string &datapath, const std::string &name);
+
+    /**
+     * 功能：顺序读取数据目录中一个文件的一段内容（测试用例在数据包中时从数据包读取，不整体读入内存）
+     * 传入：数据目录、文件名、偏移、最大长度、接收数据块的回调（返回 false 时停止）
+     * 传出：是否成功，文件不存在时返回 false
+     */
+    static bool StreamFile(const std::string &datapath, const std::string &name, size_t offset, size_t length,
+                           const std::function<bool(const char *, size_t)> &sink);
+
+    // 读取数据目录中一个文件的一段内容
+    static bool ReadFile(const std::string &datapath, const std::string &name, size_t offset, size_t length,
+                         std::string &content);
+
+    // 截取测试数据的预览（不超过 TESTINFO_PREVIEW_BYTES 字节和 TESTINFO_PREVIEW_LINES 行，不截断 UTF-8 字符）
+    static std::string Preview(const char *data, size_t size);
+
+    // 获取题目当前版本的清单，题目数据不存在时返回 null
+    Json::Value GetManifest(const std::string &problemid);
+
+    // 创建上传使用的暂存目录（与数据目录位于同一文件系统，提交时直接 rename），失败时返回空字符串
+    std::string CreateStaging(const std::string &problemid);
+
+    // 删除暂存目录
+    void RemoveStaging(const std::string &stagingpath);
+
+    /**
+     * 功能：将暂存目录中的文件提交为题目数据的新版本
+     * 传入：Json(ProblemId, JudgeNum, BaseVersion, RemoveSPJ, Packed, CaseMap)，暂存目录（只需包含变化的文件）
+     * BaseVersion 可选，与当前版本不一致时拒绝提交；RemoveSPJ 为 true 时新版本不包含 SPJ；
+     * CaseMap 可选，为长度 JudgeNum 的数组，第 i 项是新版本第 i + 1 个测试用例复用的当前版本测试用例序号
+     * （0 表示新增），未指定时按相同序号复用，删除或调整测试用例的顺序时只需上传新增或修改的文件；
+     * Packed 可选（默认 TESTDATA_PACK_ENABLED），与当前版本的存放方式不同时即使内容不变也生成新版本
+     * 传出：是否成功，resultjson 为 Json(Changed, Version, JudgeNum, WrittenNum, ReusedNum, CompilerInfo)，
+     * 内容没有变化时不生成新版本，版本冲突时 resultjson 中 Conflict 为 true，SPJ 编译失败时仍然提交并返回 CompilerInfo
+     */
+    bool Commit(const Json::Value &commitjson, const std::string &stagingpath, Json::Value &resultjson,
+                std::string &error);
+
+    // 删除题目的全部数据版本
+    bool Remove(const std::string &problemid);
+
+    /**
+     * 功能：获取测试数据存储的运行状态
+     * 传出：Json(CommitNum, UnchangedNum, WrittenNum, WrittenBytes, ReusedNum, InUseNum, DeferredNum)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // TESTDATA_STORE_H
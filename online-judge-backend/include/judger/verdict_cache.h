@@ -0,0 +1,85 @@
+#ifndef VERDICT_CACHE_H
+#define VERDICT_CACHE_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+
+#include "judger/judge_result.h"
+
+/**
+ * 判题结果复用头文件
+ *
+ * 以代码、语言、题目 ID、测试数据版本以及评测参数（测试用例数目、评测模式、比较模式和误差、时间、内存和输出限制）
+ * 的摘要作为键，缓存已完成的判题结果。同一份代码在测试数据未变化时再次提交（反复提交、多个账号提交同一模板），
+ * 直接以缓存的结果生成新的测评记录，不再编译和运行。系统错误不缓存。
+ * 缓存只保存在内存中，总大小受 VERDICT_CACHE_MAX_BYTES 限制，超出后按最近最少使用的顺序淘汰；
+ * 管理员可以在运行时关闭（关闭时清空缓存）。
+ */
+class VerdictCache {
+private:
+    struct Entry {
+        std::shared_ptr<const JudgeResult> result;  // 判题结果
+        long long judgens;                          // 得到该结果的判题耗时（纳秒，不包括排队）
+        long long bytes;                            // 估计占用的字节数
+        std::list<std::string>::iterator iter;      // 在 LRU 链表中的位置
+    };
+
+    std::unordered_map<std::string, Entry> entries;  // 缓存项
+    std::list<std::string> lru;                      // 最近使用的缓存项在前
+    long long total_bytes;                           // 缓存总大小
+    std::mutex cache_mutex;                          // 保护缓存的互斥锁
+
+    std::atomic<bool> enabled;         // 是否启用
+    std::atomic<long long> hit_num;    // 命中次数
+    std::atomic<long long> miss_num;   // 未命中次数
+    std::atomic<long long> store_num;  // 保存次数
+    std::atomic<long long> saved_ns;   // 命中节省的判题耗时之和（纳秒）
+
+    VerdictCache();
+
+    ~VerdictCache();
+
+    // 估计判题结果占用的字节数
+    static long long EstimateBytes(const JudgeResult &result);
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static VerdictCache *GetInstance();
+
+    /**
+     * 功能：计算缓存键
+     * 传入：判题任务 Json(ProblemId, JudgeNum, JudgeMode, CompareMode, CompareEpsilon, Code, Language, TimeLimit,
+     * MemoryLimit, OutputLimit)
+     * 传出：缓存键（SHA-256 十六进制字符串，题目数据目录不存在时返回空字符串）
+     */
+    static std::string GetKey(const Json::Value &taskjson);
+
+    // 是否启用
+    bool IsEnabled();
+
+    // 启用或关闭（关闭时清空缓存）
+    void SetEnabled(bool enable);
+
+    // 查找判题结果（命中时累计节省的判题耗时），未启用或未命中时返回空指针
+    std::shared_ptr<const JudgeResult> Get(const std::string &key);
+
+    /**
+     * 功能：保存判题结果
+     * 传入：缓存键、判题结果、得到该结果的判题耗时（纳秒）
+     */
+    void Store(const std::string &key, const JudgeResult &result, long long judgens);
+
+    /**
+     * 功能：获取判题结果复用的运行状态
+     * 传出：Json(Enabled, EntryNum, TotalBytes, MaxBytes, HitNum, MissNum, StoreNum, SavedMs)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // VERDICT_CACHE_H
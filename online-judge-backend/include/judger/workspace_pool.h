@@ -0,0 +1,71 @@
+#ifndef WORKSPACE_POOL_H
+#define WORKSPACE_POOL_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <vector>
+
+/**
+ * 评测工作区池头文件
+ *
+ * 启动时在 RUN_PATH_PREFIX 下预先创建固定数目的工作区槽位（有权限时每个槽位挂载一个独立的 tmpfs，
+ * 挂载大小即槽位的大小上限），判题机签出一个槽位作为运行目录，判题结束后直接通过 openat/unlinkat 清空并归还，
+ * 不再为每次提交通过 system() 执行 mkdir 和 rm -rf。
+ * 只有槽位是独立挂载的 tmpfs 时大小上限才真正生效（写满后程序收到 ENOSPC）；没有权限挂载时（非 root）上限不生效，
+ * 只在清理时统计超出上限的次数（OverQuotaNum），启动时输出警告，运行状态中 QuotaEnforced 为 false。
+ */
+class WorkspacePool {
+private:
+    struct Slot {
+        std::string path;  // 槽位路径（以 / 结尾）
+        int dirfd;         // 槽位目录的文件描述符
+    };
+
+    std::vector<Slot> slots;            // 全部槽位
+    std::vector<int> free_slots;        // 空闲槽位编号
+    bool is_tmpfs;                      // 槽位是否位于 tmpfs 上
+    bool quota_enforced;                // 大小上限是否生效（每个槽位都是独立挂载的 tmpfs）
+    std::mutex pool_mutex;              // 保护空闲槽位列表的互斥锁
+    std::condition_variable pool_cond;  // 等待空闲槽位的条件变量
+
+    std::atomic<long long> checkout_num;   // 签出次数
+    std::atomic<long long> checkout_ns;    // 签出累计耗时（纳秒）
+    std::atomic<long long> clean_ns;       // 清理累计耗时（纳秒）
+    std::atomic<long long> overquota_num;  // 清理时发现超出大小上限的次数（上限不生效时只能事后统计）
+
+    WorkspacePool();
+
+    ~WorkspacePool();
+
+    // 初始化单个槽位（创建目录、按需挂载 tmpfs 并清空残留文件）
+    bool InitSlot(const std::string &path);
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static WorkspacePool *GetInstance();
+
+    /**
+     * 功能：签出一个工作区槽位（没有空闲槽位时阻塞等待）
+     * 传出：槽位编号（-1 表示没有可用的槽位）
+     */
+    int Acquire();
+
+    // 获取槽位路径（以 / 结尾）
+    std::string GetPath(int slot);
+
+    // 清空并归还工作区槽位
+    void Release(int slot);
+
+    /**
+     * 功能：获取工作区池的运行状态
+     * 传出：Json(SlotNum, FreeNum, IsTmpfs, QuotaEnforced, QuotaBytes, CheckoutNum, AvgCheckoutUs, AvgCleanUs,
+     * OverQuotaNum)
+     */
+    Json::Value GetStats();
+};
+
+#endif  // WORKSPACE_POOL_H
@@ -0,0 +1,58 @@
+#ifndef ZYGOTE_H
+#define ZYGOTE_H
+
+#include <sys/types.h>
+
+#include <string>
+
+extern "C" {
+#include "judger/runner.h"
+}
+
+/**
+ * 解释器 zygote 头文件
+ *
+ * 每个评测槽位只启动一次解释器（Python2/Python3），由这个已完成启动的解释器进程为每个测试用例 fork 出子进程，
+ * 子进程重定向标准输入输出、设置与沙箱相同的资源限制并加载相同的 seccomp 规则后运行用户程序，
+ * 运行时间和内存只统计子进程本身，不包括各测试用例共享的解释器启动开销。
+ *
+ * zygote 进程启动前同样设置沙箱的栈大小、进程数、用户和组等限制；zygote 启动失败或中途退出时，
+ * 判题机对剩余的测试用例回退到按冷启动方式运行。
+ */
+class Zygote {
+public:
+    Zygote();
+
+    ~Zygote();
+
+    Zygote(const Zygote &) = delete;
+
+    Zygote &operator=(const Zygote &) = delete;
+
+    /**
+     * 功能：启动 zygote 进程
+     * 传入：沙箱配置（exe_path 为解释器，args[1] 为字节码文件，以及环境变量、栈大小、进程数、用户和组、seccomp 规则）
+     * 传出：是否启动成功
+     */
+    bool Start(const struct config *conf);
+
+    /**
+     * 功能：运行单个测试用例
+     * 传入：沙箱配置（输入输出路径、时间和空间限制）
+     * 传出：是否运行成功（失败时 zygote 不再可用，res 未填写）、运行结果（与沙箱的 run 函数一致）
+     */
+    bool Run(const struct config *conf, struct result *res);
+
+private:
+    // 读取 zygote 上报的一行，超时（毫秒，-1 表示不限）或 zygote 退出时返回 false
+    bool ReadLine(std::string &line, int timeout);
+
+    // 停止 zygote 进程
+    void Stop();
+
+    pid_t pid_;           // zygote 进程 ID
+    int fd_;              // 与 zygote 通信的套接字
+    std::string buffer_;  // 已读取但未处理的上报数据
+};
+
+#endif  // ZYGOTE_H
@@ -0,0 +1,134 @@
+#ifndef JUDGE_SERVICE_H
+#define JUDGE_SERVICE_H
+
+#include <json/json.h>
+
+#include <atomic>
+#include <condition_variable>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <set>
+#include <string>
+#include <thread>
+#include <unordered_set>
+#include <utility>
+#include <vector>
+
+#include "judger/judger.h"
+
+/**
+ * 判题服务类头文件
+ *
+ * 提交的代码先写入判题队列，由独立的判题工作线程池异步完成判题，
+ * HTTP 工作线程只负责插入测评记录并入队，不再被判题阻塞。
+ *
+ * 判题分为编译和运行两个阶段：编译工作线程从判题队列中取出任务完成编译（未命中编译缓存时先申请准入），
+ * 编译通过的提交进入有界的运行队列，由判题工作线程运行测试用例。两个阶段在不同提交之间流水进行，
+ * 运行队列已满时编译工作线程等待。
+ *
+ * 管理员可以按题目、用户和提交时间范围重新评测。重新评测的任务先进入单独的队列，由送入线程在判题队列较空时
+ * 按固定的间隔逐个送入判题队列；判题时使用测试用例结果记忆（见 judger/case_memo.h），只运行变化或新增的测试用例。
+ * 重新评测只更新测评记录，一批任务全部完成后再按测评记录批量修正题目和用户的统计信息。
+ */
+class JudgeService {
+private:
+    // 编译完成、等待运行的提交
+    struct RunTask {
+        Json::Value taskjson;            // 判题任务
+        std::unique_ptr<Judger> judger;  // 已完成编译的判题机（持有评测工作区）
+        long long enqueuetime;           // 进入运行队列的时间（纳秒，单调时钟）
+    };
+
+    std::deque<Json::Value> task_queue;        // 判题任务队列
+    std::mutex queue_mutex;                    // 保护判题任务队列的互斥锁
+    std::condition_variable queue_cond;        // 判题任务队列的条件变量
+    std::vector<std::thread> compile_workers;  // 编译工作线程
+    std::vector<std::thread> workers;          // 判题工作线程
+    bool stopping;                             // 是否正在停止判题服务
+
+    std::deque<RunTask> run_queue;           // 运行队列
+    std::mutex run_mutex;                    // 保护运行队列的互斥锁
+    std::condition_variable run_cond;        // 运行队列非空的条件变量
+    std::condition_variable run_space_cond;  // 运行队列未满的条件变量
+    bool run_stopping;                       // 编译阶段是否已经结束（运行队列不会再有新的提交）
+
+    std::atomic<int> compiling_num;       // 正在编译的任务数
+    std::atomic<int> running_num;         // 正在判题的任务数
+    std::atomic<long long> finished_num;  // 已完成的判题任务数
+    std::atomic<long long> rejected_num;  // 因队列已满被拒绝的提交数
+    std::atomic<long long> reused_num;    // 复用判题结果的提交数
+
+    std::deque<Json::Value> rejudge_queue;                            // 等待送入判题队列的重新评测任务
+    std::unordered_set<std::string> rejudge_records;                  // 尚未完成重新评测的测评记录 ID（用于去重）
+    std::set<std::string> rejudge_problems;                           // 本批重新评测涉及的题目
+    std::set<std::pair<std::string, std::string>> rejudge_userprobs;  // 本批重新评测涉及的用户和题目
+    std::mutex rejudge_mutex;                                         // 保护重新评测状态的互斥锁
+    std::condition_variable rejudge_cond;                             // 重新评测队列的条件变量
+    std::thread rejudge_feeder;                                       // 重新评测的送入线程
+    bool rejudge_stopping;                                            // 是否正在停止送入
+    std::atomic<long long> rejudged_num;                              // 已完成的重新评测任务数
+
+    JudgeService();
+
+    ~JudgeService();
+
+    // 编译工作线程的主循环
+    void CompileLoop();
+
+    // 判题工作线程的主循环
+    void WorkerLoop();
+
+    // 重新评测送入线程的主循环
+    void RejudgeLoop();
+
+    // 完成一个重新评测任务，一批任务全部完成后批量修正题目和用户的统计信息
+    void FinishRejudge(const Json::Value &taskjson);
+
+    // 根据判题结果更新测评记录、题目和用户的状态信息，并记录判题阶段耗时和保存判题结果（trace 为空表示复用的判题结果）
+    void FinishTask(Json::Value &taskjson, const JudgeResult &result, JudgeTrace *trace);
+
+public:
+    // 局部静态特性的方式实现单实例模式
+    static JudgeService *GetInstance();
+
+    // 判题队列是否已满
+    bool IsQueueFull();
+
+    // 记录一次因队列已满被拒绝的提交（调用方根据 IsQueueFull 拒绝提交时调用）
+    void RecordRejected();
+
+    /**
+     * 功能：将判题任务加入判题队列（记录入队时间 EnqueueTime）；可以复用判题结果时直接完成判题，不进入队列
+     * 传入：Json(StatusRecordId, ProblemId, UserId, JudgeNum, JudgeMode, CompareMode, CompareEpsilon, Code, Language,
+     * TimeLimit, MemoryLimit, OutputLimit)
+     * 传出：bool（队列已满时返回 false）
+     */
+    bool PushTask(Json::Value &taskjson);
+
+    /**
+     * 功能：获取判题服务的运行状态
+     * 传入：题目 ID（不为空时在 Trace 中返回该题目的判题阶段耗时统计）
+     * 传出：Json(WorkerNum, CompileWorkerNum, QueueCapacity, QueueLength, RunQueueCapacity, RunQueueLength,
+     * CompilingNum, RunningNum, FinishedNum, RejectedNum, ReusedNum, CompileGovernor, CompileCache, Workspace,
+     * TestDataCache, TestDataStore, SpjCache, PchCache, JvmCds, Launcher, Cgroup, Trace, VerdictCache, CaseMemo,
+     * Rejudge)
+     */
+    Json::Value GetJudgeStats(const std::string &problemid = "");
+
+    /**
+     * 功能：启用或关闭判题结果复用
+     * 传入：Json(Enabled)
+     * 传出：判题结果复用的运行状态
+     */
+    Json::Value UpdateVerdictCache(Json::Value &updatejson);
+
+    /**
+     * 功能：重新评测（按提交时间先后加入重新评测队列，已在队列中的测评记录不重复加入）
+     * 传入：Json(ProblemId, UserId, StartTime, EndTime)（至少指定一项）
+     * 传出：Json(MatchedNum, QueuedNum, SkippedNum, PendingNum)
+     */
+    Json::Value Rejudge(Json::Value &queryjson);
+};
+
+#endif  // JUDGE_SERVICE_H
@@ -3,9 +3,20 @@
 
 #include <json/json.h>
 
+#include <functional>
+#include <string>
+
 /**
  * 题目服务类头文件
  */
+
+// 测试数据上传的接收函数：将请求体中的文件写入暂存目录，失败时返回 false 并设置错误信息
+using TestDataReceiver = std::function<bool(const std::string &stagingpath, std::string &error)>;
+
+// 测试数据文件的发送函数：按文件大小设置响应，由 HTTP 层按请求的范围从数据目录流式读取文件内容，
+// 数据目录已通过 AcquireVersion 登记使用，响应结束后由发送方调用 ReleaseVersion
+using TestDataSender = std::function<void(const std::string &datapath, const std::string &name, long long size)>;
+
 class ProblemService {
 private:
     ProblemService();
@@ -31,6 +42,18 @@ public:
     // 删除题目（管理员权限）
     Json::Value DeleteProblem(Json::Value &deletejson);
 
+    // 获取题目测试数据的清单（管理员权限）
+    Json::Value GetProblemDataManifest(Json::Value &queryjson);
+
+    // 分页获取题目测试用例的信息（管理员权限，只包含大小、哈希和预览）
+    Json::Value SelectProblemDataCases(Json::Value &queryjson);
+
+    // 获取题目的一个测试数据文件（管理员权限，文件内容由 sender 流式发送）
+    Json::Value SelectProblemDataFile(Json::Value &queryjson, const TestDataSender &sender);
+
+    // 上传题目的测试数据（管理员权限，只需上传内容变化的文件）
+    Json::Value UploadProblemData(Json::Value &uploadjson, const TestDataReceiver &receiver);
+
     // 分页获取题目列表
     Json::Value SelectProblemList(Json::Value &queryjson);
 
@@ -39,6 +62,9 @@ public:
 
     // 更新题目的状态数量
     bool UpdateProblemStatusNum(Json::Value &updatejson);
+
+    // 按测评记录重新统计题目的状态数量
+    bool RecountProblemStatusNum(Json::Value &updatejson);
 };
 
 #endif  // PROBLEM_SERVICE_H
\ No newline at end of file
@@ -3,6 +3,8 @@
 
 #include <json/json.h>
 
+#include "judger/judge_result.h"
+
 /**
  * 提交记录服务类头文件
  */
@@ -24,11 +26,14 @@ public:
     // 插入查询记录
     std::string InsertStatusRecord(Json::Value &insertjson);
 
-    // 更新测评信息返回测评结果
-    bool UpdateStatusRecord(Json::Value &updatejson);
+    // 将判题结果写入测评记录
+    bool UpdateStatusRecord(const JudgeResult &result);
 
     // 获取状态记录的作者 UserId
     std::string GetStatusRecordAuthorId(int64_t statusRecordId);
+
+    // 查询需要重新评测的测评记录
+    Json::Value SelectRejudgeRecords(Json::Value &queryjson);
 };
 
 #endif  // STATUS_RECORD_SERVICE_H
\ No newline at end of file
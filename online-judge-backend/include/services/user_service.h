@@ -51,6 +51,9 @@ public:
     // 更新用户题目信息（用于用户提交代码后更新题目完成情况）
     bool UpdateUserProblemInfo(Json::Value &updatejson);
 
+    // 按测评记录重新统计用户题目信息
+    bool RecountUserProblemInfo(Json::Value &updatejson);
+
     // 用户修改密码
     Json::Value UpdateUserPassword(Json::Value &updatejson);
 
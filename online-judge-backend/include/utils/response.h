@@ -258,6 +258,24 @@ inline Json::Value ProblemDataInvalid(const std::string &message = "题目数据
     return Fail(error_code::PROBLEM_DATA_INVALID, message);
 }
 
+/**
+ * SPJ 编译失败响应
+ * @param data Json(ProblemId, CompilerInfo)
+ */
+inline Json::Value ProblemSpjCompileFailed(const Json::Value &data,
+                                           const std::string &message = "题目已保存，但 SPJ 编译失败！") {
+    return Fail(error_code::PROBLEM_SPJ_COMPILE_FAILED, message, data);
+}
+
+/**
+ * 题目数据版本冲突响应
+ * @param data Json(Conflict, Version)
+ */
+inline Json::Value ProblemDataConflict(const Json::Value &data,
+                                       const std::string &message = "题目数据已被修改，请刷新后重试！") {
+    return Fail(error_code::PROBLEM_DATA_CONFLICT, message, data);
+}
+
 // -------------------- 题解模块专用响应 --------------------
 /**
  * 题解不存在响应
@@ -328,6 +346,13 @@ inline Json::Value JudgeServiceUnavailable(const std::string &message = "判题
     return Fail(error_code::JUDGE_SERVICE_UNAVAILABLE, message);
 }
 
+/**
+ * 判题队列已满响应
+ */
+inline Json::Value JudgeQueueFull(const std::string &message = "当前提交过多，请稍后再试！") {
+    return Fail(error_code::JUDGE_QUEUE_FULL, message);
+}
+
 }  // namespace response
 
 #endif  // RESPONSE_H
@@ -0,0 +1,78 @@
+/**
+ * 沙箱启动器
+ *
+ * 由后端通过 posix_spawn 启动，从描述符 3 上的 UNIX 套接字接收沙箱配置，调用沙箱库的 run() 并返回运行结果。
+ * 启动器是单线程的小进程，沙箱库从这里 fork 沙箱进程时需要复制的页表很小，且不随后端进程（MongoDB 连接池、
+ * Redis 连接、各线程的栈）的内存增长而变大。每次运行前将启动器绑定到请求中的 CPU，沙箱进程继承该绑定；
+ * 请求中带有评测槽位的 cgroup 时，启动器在 fork 沙箱进程之前移入该 cgroup，运行结束后再移出。
+ * 后端退出或关闭套接字时启动器随之退出。
+ */
+#include <sched.h>
+#include <signal.h>
+#include <sys/prctl.h>
+#include <unistd.h>
+
+#include <deque>
+#include <string>
+
+#include "judger/launcher_protocol.hpp"
+
+using namespace std;
+
+// 通信套接字的描述符
+static const int SOCKET_FD = 3;
+
+// 绑定到指定的 CPU（-1 表示解除绑定）
+static void BindCpu(int cpu) {
+    cpu_set_t set;
+    CPU_ZERO(&set);
+    if (cpu < 0) {
+        long num = sysconf(_SC_NPROCESSORS_CONF);
+        for (long i = 0; i < num && i < CPU_SETSIZE; i++) {
+            CPU_SET(i, &set);
+        }
+    } else {
+        CPU_SET(cpu, &set);
+    }
+    sched_setaffinity(0, sizeof(set), &set);
+}
+
+int main() {
+    // 后端异常退出时不留下启动器（在此之前已经退出的情况由读取套接字时的文件结束处理）
+    prctl(PR_SET_PDEATHSIG, SIGKILL);
+
+    while (true) {
+        uint32_t len;
+        string request;
+        if (!launcher_protocol::ReadAll(SOCKET_FD, &len, sizeof(len))) {
+            return 0;
+        }
+        request.resize(len);
+        if (!launcher_protocol::ReadAll(SOCKET_FD, &request[0], len)) {
+            return 0;
+        }
+
+        int cpu;
+        cgroup_sandbox::SandboxCgroup cgroup;
+        struct config conf;
+        deque<string> storage;
+        launcher_protocol::Response response = {};
+        if (launcher_protocol::DecodeRequest(request, cpu, cgroup, conf, storage)) {
+            BindCpu(cpu);
+            // 移入评测槽位的 cgroup 后再 fork 沙箱进程，失败时按不使用 cgroup 的方式运行
+            bool incgroup = !cgroup.slot.empty() && cgroup_sandbox::Enter(cgroup);
+            run(&conf, &response.res);
+            if (incgroup) {
+                bool oomkilled = false;
+                response.accounted = cgroup_sandbox::Leave(cgroup, conf, response.res, oomkilled);
+                response.oomkilled = oomkilled;
+            }
+        } else {
+            response.res.error = INVALID_CONFIG;
+            response.res.result = SYSTEM_ERROR;
+        }
+        if (!launcher_protocol::WriteAll(SOCKET_FD, &response, sizeof(response))) {
+            return 0;
+        }
+    }
+}
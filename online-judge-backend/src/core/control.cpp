@@ -2,10 +2,11 @@
 
 #include <iostream>
 
-#include "judger/judger.h"
+#include "constants/judge.h"
 #include "services/announcement_service.h"
 #include "services/comment_service.h"
 #include "services/discuss_service.h"
+#include "services/judge_service.h"
 #include "services/problem_service.h"
 #include "services/solution_service.h"
 #include "services/status_record_service.h"
@@ -237,6 +238,58 @@ Json::Value Control::DeleteProblem(Json::Value &deletejson) {
     return ProblemService::GetInstance()->DeleteProblem(deletejson);
 }
 
+/**
+ * 功能：获取题目测试数据的清单
+ * 权限：只允许管理员查询
+ */
+Json::Value Control::GetProblemDataManifest(Json::Value &queryjson) {
+    // 如果不是管理员，无权查询题目数据
+    bool is_administrator = UserService::GetInstance()->IsAdministrator(queryjson);
+    if (!is_administrator) {
+        return response::Forbidden();
+    }
+    return ProblemService::GetInstance()->GetProblemDataManifest(queryjson);
+}
+
+/**
+ * 功能：分页获取题目测试用例的信息
+ * 权限：只允许管理员查询
+ */
+Json::Value Control::SelectProblemDataCases(Json::Value &queryjson) {
+    // 如果不是管理员，无权查询题目数据
+    bool is_administrator = UserService::GetInstance()->IsAdministrator(queryjson);
+    if (!is_administrator) {
+        return response::Forbidden();
+    }
+    return ProblemService::GetInstance()->SelectProblemDataCases(queryjson);
+}
+
+/**
+ * 功能：获取题目的一个测试数据文件
+ * 权限：只允许管理员查询
+ */
+Json::Value Control::SelectProblemDataFile(Json::Value &queryjson, const TestDataSender &sender) {
+    // 如果不是管理员，无权查询题目数据
+    bool is_administrator = UserService::GetInstance()->IsAdministrator(queryjson);
+    if (!is_administrator) {
+        return response::Forbidden();
+    }
+    return ProblemService::GetInstance()->SelectProblemDataFile(queryjson, sender);
+}
+
+/**
+ * 功能：上传题目的测试数据
+ * 权限：只允许管理员上传
+ */
+Json::Value Control::UploadProblemData(Json::Value &uploadjson, const TestDataReceiver &receiver) {
+    // 如果不是管理员，无权上传题目数据（此时请求体尚未读取）
+    bool is_administrator = UserService::GetInstance()->IsAdministrator(uploadjson);
+    if (!is_administrator) {
+        return response::Forbidden();
+    }
+    return ProblemService::GetInstance()->UploadProblemData(uploadjson, receiver);
+}
+
 /**
  * 功能：分页获取题目列表
  * 权限：所有用户均可查询
@@ -741,7 +794,11 @@ Json::Value Control::GetJudgeCode(Json::Value judgejson) {
     judgejson["ProblemTitle"] = problemjson["data"]["Title"];
     judgejson["TimeLimit"] = problemjson["data"]["TimeLimit"];
     judgejson["MemoryLimit"] = problemjson["data"]["MemoryLimit"];
+    judgejson["OutputLimit"] = problemjson["data"]["OutputLimit"];
     judgejson["JudgeNum"] = problemjson["data"]["JudgeNum"];
+    judgejson["JudgeMode"] = problemjson["data"]["JudgeMode"];
+    judgejson["CompareMode"] = problemjson["data"]["CompareMode"];
+    judgejson["CompareEpsilon"] = problemjson["data"]["CompareEpsilon"];
 
     // 添加状态记录
     // 传入：Json(ProblemId, UserId, UserNickName, ProblemTitle, Language, Code);
@@ -754,6 +811,12 @@ Json::Value Control::GetJudgeCode(Json::Value judgejson) {
     insertjson["Language"] = judgejson["Language"];
     insertjson["Code"] = judgejson["Code"];
 
+    // 判题队列已满时直接拒绝，避免产生无法判题的测评记录
+    if (JudgeService::GetInstance()->IsQueueFull()) {
+        JudgeService::GetInstance()->RecordRejected();
+        return response::JudgeQueueFull();
+    }
+
     // 获取插入的状态记录 ID，即 StatusRecordId
     string status_record_id = StatusRecordService::GetInstance()->InsertStatusRecord(insertjson);
     // 如果插入失败，返回错误信息
@@ -761,58 +824,78 @@ Json::Value Control::GetJudgeCode(Json::Value judgejson) {
         return response::Fail(error_code::INTERNAL_ERROR, "系统出错！");
     }
 
-    // 运行代码
-    // Json(StatusRecordId, ProblemId, JudgeNum, Code, Language, TimeLimit, MemoryLimit)
-    Json::Value runjson;
-    runjson["Code"] = judgejson["Code"];
-    runjson["StatusRecordId"] = status_record_id;
-    runjson["ProblemId"] = judgejson["ProblemId"];
-    runjson["Language"] = judgejson["Language"];
-    runjson["JudgeNum"] = judgejson["JudgeNum"];
-    runjson["TimeLimit"] = judgejson["TimeLimit"];
-    runjson["MemoryLimit"] = judgejson["MemoryLimit"];
-
-    // 创建判题对象
-    Judger judger;
-    Json::Value json = judger.Run(runjson);
-
-    // 判题结束后，需要更新测评记录的状态信息，并且更新题目和用户的状态信息
-
-    /**
-     * 更新测评记录
-     * 传入：Json(StatusRecordId, Status, RunTime, RunMemory, Length, CompilerInfo,
-     * TestInfo[(Status, RunTime, RunMemory, StandardInput, StandardOutput, PersonalOutput)])
-     * 传出：bool
-     */
-    StatusRecordService::GetInstance()->UpdateStatusRecord(json);
-
-    /**
-     * 更新题目状态
-     * 传入：Json(ProblemId, Status)
-     * 传出：bool
-     */
-    Json::Value updatejson;
-    updatejson["ProblemId"] = judgejson["ProblemId"];
-    updatejson["Status"] = json["Status"];
-    ProblemService::GetInstance()->UpdateProblemStatusNum(updatejson);
-
-    /**
-     * 更新用户题目状态
-     * 传入：Json(UserId, ProblemId, Status)
-     * 传出：bool （是否为该题目的第一次 AC）
-     */
-    updatejson["UserId"] = judgejson["UserId"];
-    bool is_first_ac = UserService::GetInstance()->UpdateUserProblemInfo(updatejson);
+    // 构造判题任务，交由判题工作线程异步判题（相同代码可以复用已有的判题结果时直接完成）
+    // Json(StatusRecordId, ProblemId, UserId, JudgeNum, JudgeMode, CompareMode, CompareEpsilon, Code, Language,
+    // TimeLimit, MemoryLimit, OutputLimit)
+    Json::Value taskjson;
+    taskjson["Code"] = judgejson["Code"];
+    taskjson["StatusRecordId"] = status_record_id;
+    taskjson["ProblemId"] = judgejson["ProblemId"];
+    taskjson["UserId"] = judgejson["UserId"];
+    taskjson["Language"] = judgejson["Language"];
+    taskjson["JudgeNum"] = judgejson["JudgeNum"];
+    taskjson["JudgeMode"] = judgejson["JudgeMode"];
+    taskjson["CompareMode"] = judgejson["CompareMode"];
+    taskjson["CompareEpsilon"] = judgejson["CompareEpsilon"];
+    taskjson["TimeLimit"] = judgejson["TimeLimit"];
+    taskjson["MemoryLimit"] = judgejson["MemoryLimit"];
+    taskjson["OutputLimit"] = judgejson["OutputLimit"];
+
+    if (!JudgeService::GetInstance()->PushTask(taskjson)) {
+        // 入队失败（检查队列后的短时间内队列被占满），将测评记录标记为系统错误
+        JudgeResult result;
+        result.statusrecordid = status_record_id;
+        result.status = constants::judge::STATUS_SYSTEM_ERROR;
+        result.compilerinfo = "判题队列已满，请重新提交";
+        StatusRecordService::GetInstance()->UpdateStatusRecord(result);
+        return response::JudgeQueueFull();
+    }
+
+    // 立即返回测评记录 ID，判题结果通过查询测评记录获取
     Json::Value data;
-    if (is_first_ac) {
-        data["IsFirstAC"] = true;
-    } else {
-        data["IsFirstAC"] = false;
-    }
-    data["Status"] = json["Status"];
-    data["CompilerInfo"] = json["CompilerInfo"];
+    data["Status"] = constants::judge::STATUS_PENDING_JUDGING;
     data["StatusRecordId"] = status_record_id;
-    return response::Success("判题完成", data);
+    return response::Success("提交成功，正在判题", data);
+}
+
+/**
+ * 功能：获取判题服务的运行状态
+ * 权限：只允许管理员查询
+ */
+Json::Value Control::SelectJudgeStats(Json::Value &queryjson) {
+    // 如果不是管理员，无权查询判题服务状态
+    bool is_administrator = UserService::GetInstance()->IsAdministrator(queryjson);
+    if (!is_administrator) {
+        return response::Forbidden();
+    }
+    // 指定题目 ID 时同时返回该题目的判题阶段耗时统计
+    return response::Success("查询成功", JudgeService::GetInstance()->GetJudgeStats(queryjson["ProblemId"].asString()));
+}
+
+/**
+ * 功能：启用或关闭判题结果复用
+ * 权限：只允许管理员操作
+ */
+Json::Value Control::UpdateVerdictCache(Json::Value &updatejson) {
+    // 如果不是管理员，无权设置判题结果复用
+    bool is_administrator = UserService::GetInstance()->IsAdministrator(updatejson);
+    if (!is_administrator) {
+        return response::Forbidden();
+    }
+    return JudgeService::GetInstance()->UpdateVerdictCache(updatejson);
+}
+
+/**
+ * 功能：按题目、用户和提交时间范围重新评测
+ * 权限：只允许管理员操作
+ */
+Json::Value Control::Rejudge(Json::Value &queryjson) {
+    // 如果不是管理员，无权重新评测
+    bool is_administrator = UserService::GetInstance()->IsAdministrator(queryjson);
+    if (!is_administrator) {
+        return response::Forbidden();
+    }
+    return JudgeService::GetInstance()->Rejudge(queryjson);
 }
 // ------------------------------ 判题模块 End ------------------------------
 
@@ -823,6 +906,9 @@ Control::Control() {
 
     // 初始化用户权限
     UserService::GetInstance()->InitUserAuthority();
+
+    // 启动判题服务（创建判题工作线程）
+    JudgeService::GetInstance();
 }
 
 Control::~Control() {
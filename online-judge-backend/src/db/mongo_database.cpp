@@ -1,18 +1,27 @@
 #include "db/mongo_database.h"
 
+#include <bsoncxx/builder/basic/array.hpp>
+#include <bsoncxx/builder/basic/document.hpp>
 #include <bsoncxx/builder/stream/array.hpp>
 #include <bsoncxx/builder/stream/document.hpp>
 #include <bsoncxx/builder/stream/helpers.hpp>
 #include <bsoncxx/json.hpp>
 #include <cstdint>
+#include <cstdlib>
 #include <ctime>
 #include <iostream>
+#include <map>
 #include <mongocxx/client.hpp>
+#include <mongocxx/model/update_one.hpp>
+#include <mongocxx/model/write.hpp>
 #include <mongocxx/pipeline.hpp>
+#include <set>
+#include <vector>
 
 #include "constants/db.h"
 #include "constants/judge.h"
 #include "constants/user.h"
+#include "judger/output_comparator.h"
 #include "utils/id_generator.hpp"  // 唯一 ID 生成器
 #include "utils/response.h"        // 统一响应工具
 
@@ -594,6 +603,78 @@ bool MoDB::UpdateUserProblemInfo(Json::Value &updatejson) {
     }
 }
 
+/**
+ * 功能：重新统计用户题目信息
+ * @name RecountUserProblemInfo
+ * @brief 按测评记录重新判断用户是否通过了题目，批量修正 Solves 和 ACNum（重新评测不改变提交数，SubmitNum 保持不变）
+ * @param updatejson Json(List[{UserId, ProblemId}])
+ * @return bool
+ */
+bool MoDB::RecountUserProblemInfo(Json::Value &updatejson) {
+    try {
+        // 提取需要修正的用户和题目
+        set<pair<int64_t, int64_t>> pairs;
+        set<int64_t> userids, problemids;
+        for (const Json::Value &item : updatejson["List"]) {
+            int64_t userid = stoll(item["UserId"].asString());
+            int64_t problemid = stoll(item["ProblemId"].asString());
+            pairs.insert({userid, problemid});
+            userids.insert(userid);
+            problemids.insert(problemid);
+        }
+        if (pairs.empty()) {
+            return true;
+        }
+        bsoncxx::builder::basic::array userarray, problemarray;
+        for (int64_t userid : userids) {
+            userarray.append(userid);
+        }
+        for (int64_t problemid : problemids) {
+            problemarray.append(problemid);
+        }
+
+        // 获取数据库连接
+        auto client = pool.acquire();
+        mongocxx::collection usercoll = (*client)[DATABASE_NAME][COLLECTION_USERS];
+        mongocxx::collection statusrecordcoll = (*client)[DATABASE_NAME][COLLECTION_STATUS_RECORDS];
+
+        // 查询这些用户在这些题目上通过的测评记录，按用户和题目分组
+        mongocxx::pipeline pipe;
+        pipe.match(make_document(kvp("UserId", make_document(kvp("$in", userarray.extract()))),
+                                 kvp("ProblemId", make_document(kvp("$in", problemarray.extract()))),
+                                 kvp("Status", constants::judge::STATUS_ACCEPTED)));
+        pipe.group(make_document(kvp("_id", make_document(kvp("UserId", "$UserId"), kvp("ProblemId", "$ProblemId")))));
+        set<pair<int64_t, int64_t>> solved;
+        Json::Reader reader;
+        mongocxx::cursor cursor = statusrecordcoll.aggregate(pipe);
+        for (auto doc : cursor) {
+            Json::Value tmpjson;
+            reader.parse(bsoncxx::to_json(doc), tmpjson);
+            solved.insert({tmpjson["_id"]["UserId"].asInt64(), tmpjson["_id"]["ProblemId"].asInt64()});
+        }
+
+        // 通过的题目不在 Solves 中时加入，未通过的题目在 Solves 中时移除，ACNum 随之增减（条件更新，可以重复执行）
+        vector<mongocxx::model::write> writes;
+        for (const auto &item : pairs) {
+            if (solved.count(item)) {
+                writes.emplace_back(mongocxx::model::update_one(
+                    make_document(kvp("_id", item.first), kvp("Solves", make_document(kvp("$ne", item.second)))),
+                    make_document(kvp("$push", make_document(kvp("Solves", item.second))),
+                                  kvp("$inc", make_document(kvp("ACNum", 1))))));
+            } else {
+                writes.emplace_back(mongocxx::model::update_one(
+                    make_document(kvp("_id", item.first), kvp("Solves", item.second)),
+                    make_document(kvp("$pull", make_document(kvp("Solves", item.second))),
+                                  kvp("$inc", make_document(kvp("ACNum", -1))))));
+            }
+        }
+        usercoll.bulk_write(writes);
+        return true;
+    } catch (const std::exception &e) {
+        return false;
+    }
+}
+
 /**
  * 功能：通过 UserId 获取用户名 NickName
  * @name GetNickNameByUserId
@@ -695,8 +776,8 @@ Json::Value MoDB::UpdateUserPassword(Json::Value &updatejson) {
  * @name SelectProblemInfo
  * @brief 查询指定题目的信息
  * @param queryjson Json(ProblemId)
- * @return Json(success, code, message, data(_id, Title, Description, TimeLimit, MemoryLimit, JudgeNum, SubmitNum,
- * ACNum, UserNickName, Tags[]))
+ * @return Json(success, code, message, data(_id, Title, Description, TimeLimit, MemoryLimit, OutputLimit, JudgeNum,
+ * JudgeMode, CompareMode, CompareEpsilon, SubmitNum, ACNum, UserNickName, Tags[]))
  */
 Json::Value MoDB::SelectProblemInfo(Json::Value &queryjson) {
     try {
@@ -711,8 +792,9 @@ Json::Value MoDB::SelectProblemInfo(Json::Value &queryjson) {
         mongocxx::pipeline pipe;
         pipe.match({make_document(kvp("_id", problemid))});
 
-        document << "Title" << 1 << "Description" << 1 << "TimeLimit" << 1 << "MemoryLimit" << 1 << "JudgeNum" << 1
-                 << "SubmitNum" << 1 << "ACNum" << 1 << "UserNickName" << 1 << "Tags" << 1;
+        document << "Title" << 1 << "Description" << 1 << "TimeLimit" << 1 << "MemoryLimit" << 1 << "OutputLimit" << 1
+                 << "JudgeNum" << 1 << "JudgeMode" << 1 << "CompareMode" << 1 << "CompareEpsilon" << 1 << "SubmitNum"
+                 << 1 << "ACNum" << 1 << "UserNickName" << 1 << "Tags" << 1;
         pipe.project(document.view());
 
         Json::Reader reader;
@@ -740,8 +822,8 @@ Json::Value MoDB::SelectProblemInfo(Json::Value &queryjson) {
  * @name SelectProblemInfoByAdmin
  * @brief 查询指定题目的信息（管理员权限）
  * @param queryjson Json(ProblemId)
- * @return Json(success, code, message, data(_id, Title, Description, TimeLimit, MemoryLimit, UserNickName, JudgeNum,
- * Tags[]))
+ * @return Json(success, code, message, data(_id, Title, Description, TimeLimit, MemoryLimit, OutputLimit, UserNickName,
+ * JudgeNum, JudgeMode, CompareMode, CompareEpsilon, Tags[]))
  */
 Json::Value MoDB::SelectProblemInfoByAdmin(Json::Value &queryjson) {
     try {
@@ -756,8 +838,9 @@ Json::Value MoDB::SelectProblemInfoByAdmin(Json::Value &queryjson) {
         mongocxx::pipeline pipe;
         pipe.match({make_document(kvp("_id", problemid))});
 
-        document << "Title" << 1 << "Description" << 1 << "TimeLimit" << 1 << "MemoryLimit" << 1 << "JudgeNum" << 1
-                 << "UserNickName" << 1 << "Tags" << 1;
+        document << "Title" << 1 << "Description" << 1 << "TimeLimit" << 1 << "MemoryLimit" << 1 << "OutputLimit" << 1
+                 << "JudgeNum" << 1 << "JudgeMode" << 1 << "CompareMode" << 1 << "CompareEpsilon" << 1 << "UserNickName"
+                 << 1 << "Tags" << 1;
         pipe.project(document.view());
 
         Json::Reader reader;
@@ -783,7 +866,8 @@ Json::Value MoDB::SelectProblemInfoByAdmin(Json::Value &queryjson) {
  * 权限：只允许管理员插入
  * @name InsertProblem
  * @brief 插入新题目
- * @param insertjson Json(Title, Description, TimeLimit, MemoryLimit, JudgeNum, UserNickName, Tags[])
+ * @param insertjson Json(Title, Description, TimeLimit, MemoryLimit, OutputLimit, JudgeNum, JudgeMode, CompareMode,
+ * CompareEpsilon, UserNickName, Tags[])
  * @return Json(success, code, message, data(ProblemId))
  */
 Json::Value MoDB::InsertProblem(Json::Value &insertjson) {
@@ -798,6 +882,25 @@ Json::Value MoDB::InsertProblem(Json::Value &insertjson) {
                                                                : insertjson["MemoryLimit"].asInt();
         int judgenum = insertjson["JudgeNum"].isString() ? stoi(insertjson["JudgeNum"].asString())
                                                          : insertjson["JudgeNum"].asInt();
+        // 评测模式，只有明确指定 ICPC 时才遇错即停，否则评测全部测试用例
+        string judgemode = insertjson["JudgeMode"].asString() == constants::judge::JUDGE_MODE_ICPC
+                               ? constants::judge::JUDGE_MODE_ICPC
+                               : constants::judge::JUDGE_MODE_OI;
+        // 输出比较模式，无法识别时使用默认的忽略行末空白字符
+        CompareMode mode = OutputComparator::ParseMode(insertjson["CompareMode"].asString());
+        string comparemode = OutputComparator::ModeName(mode);
+        // 浮点数比较的误差，未设置或不合法时使用默认值
+        Json::Value &epsilonjson = insertjson["CompareEpsilon"];
+        double compareepsilon = epsilonjson.isString() ? atof(epsilonjson.asCString()) : epsilonjson.asDouble();
+        if (!(compareepsilon > 0 && compareepsilon <= 1)) {
+            compareepsilon = constants::judge::COMPARE_FLOAT_EPSILON;
+        }
+        // 输出限制（MB），未设置或不合法时使用默认值
+        Json::Value &outputjson = insertjson["OutputLimit"];
+        int outputlimit = outputjson.isString() ? atoi(outputjson.asCString()) : outputjson.asInt();
+        if (outputlimit <= 0 || outputlimit > constants::judge::MAX_OUTPUT_LIMIT_MB) {
+            outputlimit = constants::judge::DEFAULT_OUTPUT_LIMIT_MB;
+        }
         string usernickname = insertjson["UserNickName"].asString();
 
         // 获取数据库连接
@@ -806,9 +909,11 @@ Json::Value MoDB::InsertProblem(Json::Value &insertjson) {
 
         bsoncxx::builder::stream::document document{};
         auto in_array = document << "_id" << problemid << "Title" << title.data() << "Description" << description.data()
-                                 << "TimeLimit" << timelimit << "MemoryLimit" << memorylimit << "JudgeNum" << judgenum
+                                 << "TimeLimit" << timelimit << "MemoryLimit" << memorylimit << "OutputLimit"
+                                 << outputlimit << "JudgeNum" << judgenum << "JudgeMode" << judgemode.data()
+                                 << "CompareMode" << comparemode.data() << "CompareEpsilon" << compareepsilon
                                  << "SubmitNum" << 0 << "CENum" << 0 << "ACNum" << 0 << "WANum" << 0 << "RENum" << 0
-                                 << "TLENum" << 0 << "MLENum" << 0 << "SENum" << 0 << "UserNickName"
+                                 << "TLENum" << 0 << "MLENum" << 0 << "SENum" << 0 << "OLENum" << 0 << "UserNickName"
                                  << usernickname.data() << "Tags" << open_array;
         // 插入标签数组
         for (int i = 0; i < insertjson["Tags"].size(); i++) {
@@ -833,7 +938,8 @@ Json::Value MoDB::InsertProblem(Json::Value &insertjson) {
  * 功能：更新题目信息（管理员权限）
  * @name UpdateProblem
  * @brief 更新指定题目的信息
- * @param updatejson Json(ProblemId, Title, Description, TimeLimit, MemoryLimit, JudgeNum, UserNickName, Tags[])
+ * @param updatejson Json(ProblemId, Title, Description, TimeLimit, MemoryLimit, OutputLimit, JudgeNum, JudgeMode,
+ * CompareMode, CompareEpsilon, UserNickName, Tags[])
  * @return Json(success, code, message, data(Result))
  */
 Json::Value MoDB::UpdateProblem(Json::Value &updatejson) {
@@ -845,6 +951,25 @@ Json::Value MoDB::UpdateProblem(Json::Value &updatejson) {
         int timelimit = stoi(updatejson["TimeLimit"].asString());
         int memorylimit = stoi(updatejson["MemoryLimit"].asString());
         int judgenum = stoi(updatejson["JudgeNum"].asString());
+        // 评测模式，只有明确指定 ICPC 时才遇错即停，否则评测全部测试用例
+        string judgemode = updatejson["JudgeMode"].asString() == constants::judge::JUDGE_MODE_ICPC
+                               ? constants::judge::JUDGE_MODE_ICPC
+                               : constants::judge::JUDGE_MODE_OI;
+        // 输出比较模式，无法识别时使用默认的忽略行末空白字符
+        CompareMode mode = OutputComparator::ParseMode(updatejson["CompareMode"].asString());
+        string comparemode = OutputComparator::ModeName(mode);
+        // 浮点数比较的误差，未设置或不合法时使用默认值
+        Json::Value &epsilonjson = updatejson["CompareEpsilon"];
+        double compareepsilon = epsilonjson.isString() ? atof(epsilonjson.asCString()) : epsilonjson.asDouble();
+        if (!(compareepsilon > 0 && compareepsilon <= 1)) {
+            compareepsilon = constants::judge::COMPARE_FLOAT_EPSILON;
+        }
+        // 输出限制（MB），未设置或不合法时使用默认值
+        Json::Value &outputjson = updatejson["OutputLimit"];
+        int outputlimit = outputjson.isString() ? atoi(outputjson.asCString()) : outputjson.asInt();
+        if (outputlimit <= 0 || outputlimit > constants::judge::MAX_OUTPUT_LIMIT_MB) {
+            outputlimit = constants::judge::DEFAULT_OUTPUT_LIMIT_MB;
+        }
         string usernickname = updatejson["UserNickName"].asString();
 
         // 获取数据库连接
@@ -854,8 +979,9 @@ Json::Value MoDB::UpdateProblem(Json::Value &updatejson) {
         bsoncxx::builder::stream::document document{};
         auto in_array = document << "$set" << open_document << "Title" << title.data() << "Description"
                                  << description.data() << "TimeLimit" << timelimit << "MemoryLimit" << memorylimit
-                                 << "JudgeNum" << judgenum << "UserNickName" << usernickname.data() << "Tags"
-                                 << open_array;
+                                 << "OutputLimit" << outputlimit << "JudgeNum" << judgenum << "JudgeMode"
+                                 << judgemode.data() << "CompareMode" << comparemode.data() << "CompareEpsilon"
+                                 << compareepsilon << "UserNickName" << usernickname.data() << "Tags" << open_array;
         // 插入标签数组
         for (int i = 0; i < updatejson["Tags"].size(); i++) {
             string tag = updatejson["Tags"][i].asString();
@@ -918,7 +1044,7 @@ Json::Value MoDB::DeleteProblem(Json::Value &deletejson) {
  * @brief 分页查询题目列表
  * @param queryjson Json(Page, PageSize, SearchInfo(Id, Title, Tags[]))
  * @return Json(success, code, message, data(List[{_id, Title, SubmitNum, CENum, ACNum, WANum, RENum,
- * TLENum, MLENum, SENum, Tags}], Total))
+ * TLENum, MLENum, SENum, OLENum, Tags}], Total))
  */
 Json::Value MoDB::SelectProblemList(Json::Value &queryjson) {
     try {
@@ -980,7 +1106,7 @@ Json::Value MoDB::SelectProblemList(Json::Value &queryjson) {
         pipe.limit(pagesize);
         // 进行
         document << "Title" << 1 << "SubmitNum" << 1 << "CENum" << 1 << "ACNum" << 1 << "WANum" << 1 << "RENum" << 1
-                 << "TLENum" << 1 << "MLENum" << 1 << "SENum" << 1 << "Tags" << 1;
+                 << "TLENum" << 1 << "MLENum" << 1 << "SENum" << 1 << "OLENum" << 1 << "Tags" << 1;
         pipe.project(document.view());
 
         Json::Value list(Json::arrayValue);
@@ -1003,7 +1129,7 @@ Json::Value MoDB::SelectProblemList(Json::Value &queryjson) {
  * @brief 分页查询题目列表（管理员权限）
  * @param queryjson Json(Page, PageSize)
  * @return Json(success, code, message, data(List[{_id, Title, SubmitNum, CENum, ACNum, WANum, RENum,
- * TLENum, MLENum, SENum, Tags}], Total))
+ * TLENum, MLENum, SENum, OLENum, Tags}], Total))
  */
 Json::Value MoDB::SelectProblemListByAdmin(Json::Value &queryjson) {
     try {
@@ -1075,7 +1201,7 @@ Json::Value MoDB::SelectProblemListByAdmin(Json::Value &queryjson) {
         pipe.limit(pagesize);
         // 进行（<< "ProblemId" << "$_id"）
         document << "Title" << 1 << "SubmitNum" << 1 << "CENum" << 1 << "ACNum" << 1 << "WANum" << 1 << "RENum" << 1
-                 << "TLENum" << 1 << "MLENum" << 1 << "SENum" << 1 << "Tags" << 1;
+                 << "TLENum" << 1 << "MLENum" << 1 << "SENum" << 1 << "OLENum" << 1 << "Tags" << 1;
         pipe.project(document.view());
 
         Json::Value list(Json::arrayValue);
@@ -1091,6 +1217,28 @@ Json::Value MoDB::SelectProblemListByAdmin(Json::Value &queryjson) {
     }
 }
 
+// 判题状态对应的题目状态数量字段（等待评测等没有对应字段的状态返回空指针）
+static const char *GetStatusNumField(int status) {
+    if (status == constants::judge::STATUS_COMPILE_ERROR) {
+        return constants::judge::FIELD_COMPILE_ERROR;
+    } else if (status == constants::judge::STATUS_ACCEPTED) {
+        return constants::judge::FIELD_ACCEPTED;
+    } else if (status == constants::judge::STATUS_WRONG_ANSWER) {
+        return constants::judge::FIELD_WRONG_ANSWER;
+    } else if (status == constants::judge::STATUS_RUNTIME_ERROR) {
+        return constants::judge::FIELD_RUNTIME_ERROR;
+    } else if (status == constants::judge::STATUS_TIME_LIMIT_EXCEEDED) {
+        return constants::judge::FIELD_TIME_LIMIT_EXCEEDED;
+    } else if (status == constants::judge::STATUS_MEMORY_LIMIT_EXCEEDED) {
+        return constants::judge::FIELD_MEMORY_LIMIT_EXCEEDED;
+    } else if (status == constants::judge::STATUS_SYSTEM_ERROR) {
+        return constants::judge::FIELD_SYSTEM_ERROR;
+    } else if (status == constants::judge::STATUS_OUTPUT_LIMIT_EXCEEDED) {
+        return constants::judge::FIELD_OUTPUT_LIMIT_EXCEEDED;
+    }
+    return nullptr;
+}
+
 /**
  * 功能：更新题目的状态数量
  * @name UpdateProblemStatusNum
@@ -1105,22 +1253,7 @@ bool MoDB::UpdateProblemStatusNum(Json::Value &updatejson) {
         int status = stoi(updatejson["Status"].asString());
 
         // 根据判题状态选择更新对应的字段
-        const char *status_field = nullptr;
-        if (status == constants::judge::STATUS_COMPILE_ERROR) {
-            status_field = constants::judge::FIELD_COMPILE_ERROR;
-        } else if (status == constants::judge::STATUS_ACCEPTED) {
-            status_field = constants::judge::FIELD_ACCEPTED;
-        } else if (status == constants::judge::STATUS_WRONG_ANSWER) {
-            status_field = constants::judge::FIELD_WRONG_ANSWER;
-        } else if (status == constants::judge::STATUS_RUNTIME_ERROR) {
-            status_field = constants::judge::FIELD_RUNTIME_ERROR;
-        } else if (status == constants::judge::STATUS_TIME_LIMIT_EXCEEDED) {
-            status_field = constants::judge::FIELD_TIME_LIMIT_EXCEEDED;
-        } else if (status == constants::judge::STATUS_MEMORY_LIMIT_EXCEEDED) {
-            status_field = constants::judge::FIELD_MEMORY_LIMIT_EXCEEDED;
-        } else if (status == constants::judge::STATUS_SYSTEM_ERROR) {
-            status_field = constants::judge::FIELD_SYSTEM_ERROR;
-        }
+        const char *status_field = GetStatusNumField(status);
 
         // 如果状态字段无效，则返回 false
         if (status_field == nullptr) {
@@ -1142,6 +1275,99 @@ bool MoDB::UpdateProblemStatusNum(Json::Value &updatejson) {
         return false;
     }
 }
+
+/**
+ * 功能：重新统计题目的状态数量
+ * @name RecountProblemStatusNum
+ * @brief 按测评记录重新统计题目的提交数和各状态数量，批量写回（用于重新评测之后修正）
+ * @param updatejson Json(ProblemIds[])
+ * @return bool
+ */
+bool MoDB::RecountProblemStatusNum(Json::Value &updatejson) {
+    try {
+        // 提取题目 ID，每个题目各状态的测评记录数初始为 0
+        map<int64_t, map<int, int64_t>> counts;
+        bsoncxx::builder::basic::array problemarray;
+        for (const Json::Value &id : updatejson["ProblemIds"]) {
+            int64_t problemid = stoll(id.asString());
+            if (counts.emplace(problemid, map<int, int64_t>()).second) {
+                problemarray.append(problemid);
+            }
+        }
+        if (counts.empty()) {
+            return true;
+        }
+
+        // 获取数据库连接
+        auto client = pool.acquire();
+        mongocxx::collection problemcoll = (*client)[DATABASE_NAME][COLLECTION_PROBLEMS];
+        mongocxx::collection statusrecordcoll = (*client)[DATABASE_NAME][COLLECTION_STATUS_RECORDS];
+
+        // 按题目和状态分组统计测评记录数
+        mongocxx::pipeline pipe;
+        pipe.match(make_document(kvp("ProblemId", make_document(kvp("$in", problemarray.extract())))));
+        pipe.group(make_document(kvp("_id", make_document(kvp("ProblemId", "$ProblemId"), kvp("Status", "$Status"))),
+                                 kvp("Count", make_document(kvp("$sum", 1)))));
+        Json::Reader reader;
+        mongocxx::cursor cursor = statusrecordcoll.aggregate(pipe);
+        for (auto doc : cursor) {
+            Json::Value tmpjson;
+            reader.parse(bsoncxx::to_json(doc), tmpjson);
+            counts[tmpjson["_id"]["ProblemId"].asInt64()][tmpjson["_id"]["Status"].asInt()] =
+                tmpjson["Count"].asInt64();
+        }
+
+        // 提交数为有对应字段的各状态数量之和，与 UpdateProblemStatusNum 的计数方式一致
+        // 统计之后、写回之前完成的提交会被覆盖，下一次重新统计时修正
+        vector<mongocxx::model::write> writes;
+        for (auto &item : counts) {
+            bsoncxx::builder::basic::document fields{};
+            int64_t submitnum = 0;
+            for (int status = constants::judge::STATUS_PENDING_JUDGING;
+                 status <= constants::judge::STATUS_OUTPUT_LIMIT_EXCEEDED; status++) {
+                const char *status_field = GetStatusNumField(status);
+                if (status_field == nullptr) {
+                    continue;
+                }
+                fields.append(kvp(std::string(status_field), item.second[status]));
+                submitnum += item.second[status];
+            }
+            fields.append(kvp("SubmitNum", submitnum));
+            writes.emplace_back(mongocxx::model::update_one(make_document(kvp("_id", item.first)),
+                                                            make_document(kvp("$set", fields.extract()))));
+        }
+        problemcoll.bulk_write(writes);
+        return true;
+    } catch (const std::exception &e) {
+        return false;
+    }
+}
+
+/**
+ * 功能：更新题目的测试用例数目
+ * @name UpdateProblemJudgeNum
+ * @brief 上传测试数据改变了测试用例数目时，同步到题目信息中（判题按题目信息中的数目读取测试数据）
+ * @param updatejson Json(ProblemId, JudgeNum)
+ * @return bool
+ */
+bool MoDB::UpdateProblemJudgeNum(Json::Value &updatejson) {
+    try {
+        // 提取题目 ID 和测试用例数目
+        int64_t problemid = stoll(updatejson["ProblemId"].asString());
+        int judgenum = updatejson["JudgeNum"].asInt();
+
+        // 获取数据库连接
+        auto client = pool.acquire();
+        mongocxx::collection problemcoll = (*client)[DATABASE_NAME][COLLECTION_PROBLEMS];
+
+        // 执行更新操作
+        auto update_doc = make_document(kvp("$set", make_document(kvp("JudgeNum", judgenum))));
+        auto result = problemcoll.update_one({make_document(kvp("_id", problemid))}, update_doc.view());
+        return static_cast<bool>(result && result->matched_count() > 0);
+    } catch (const std::exception &e) {
+        return false;
+    }
+}
 // ------------------------------ 题目模块 End ------------------------------
 
 // ------------------------------ 标签模块 Start ------------------------------
@@ -3655,48 +3881,57 @@ string MoDB::InsertStatusRecord(Json::Value &insertjson) {
 /**
  * 功能：更新测评记录
  * @name UpdateStatusRecord
- * @brief 更新指定测评记录的状态和测试信息
- * @param updatejson Json(StatusRecordId, Status, RunTime, RunMemory, Length, CompilerInfo, TestInfo[{Status,
- * StandardInput, StandardOutput, PersonalOutput, RunTime, RunMemory}])
+ * @brief 将判题结果直接编码为 BSON 更新指定的测评记录
+ * @param result 判题结果（见 judger/judge_result.h），运行时间、内存和代码长度按原有格式（"123MS"、"12MB"、"456B"）
+ * 写入；测试用例的输入输出只是预览，另附完整大小和 SHA-256；Trace 和 TraceCases 为判题阶段耗时
+ * （见 judger/judge_trace.h）
  * @return bool 更新是否成功
  */
-bool MoDB::UpdateStatusRecord(Json::Value &updatejson) {
-    Json::Value resjson;
+bool MoDB::UpdateStatusRecord(const JudgeResult &result) {
     try {
-        // 获取测评记录 ID 和更新内容
-        int64_t submitid = stoll(updatejson["StatusRecordId"].asString());
-        int status = stoi(updatejson["Status"].asString());
-        string runtime = updatejson["RunTime"].asString();
-        string runmemory = updatejson["RunMemory"].asString();
-        string length = updatejson["Length"].asString();
-        string complierinfo = updatejson["CompilerInfo"].asString();
+        // 获取测评记录 ID
+        int64_t submitid = stoll(result.statusrecordid);
 
         // 更新测评记录
         auto client = pool.acquire();
         mongocxx::collection statusrecordcoll = (*client)[DATABASE_NAME][COLLECTION_STATUS_RECORDS];
         bsoncxx::builder::stream::document document{};
-        auto in_array = document << "$set" << open_document << "Status" << status << "RunTime" << runtime.data()
-                                 << "RunMemory" << runmemory.data() << "Length" << length.data() << "CompilerInfo"
-                                 << complierinfo.data() << "TestInfo" << open_array;
-
-        // 构造测试信息数组
-        for (int i = 0; i < updatejson["TestInfo"].size(); i++) {
-            int teststatus = stoi(updatejson["TestInfo"][i]["Status"].asString());
-            string standardinput = updatejson["TestInfo"][i]["StandardInput"].asString();
-            string standardoutput = updatejson["TestInfo"][i]["StandardOutput"].asString();
-            string personaloutput = updatejson["TestInfo"][i]["PersonalOutput"].asString();
-            string testruntime = updatejson["TestInfo"][i]["RunTime"].asString();
-            string testrunmemory = updatejson["TestInfo"][i]["RunMemory"].asString();
-            in_array = in_array << open_document << "Status" << teststatus << "StandardInput" << standardinput
-                                << "StandardOutput" << standardoutput << "PersonalOutput" << personaloutput << "RunTime"
-                                << testruntime << "RunMemory" << testrunmemory << close_document;
+        auto in_array = document << "$set" << open_document << "Status" << result.status << "RunTime"
+                                 << to_string(result.runtime) + "MS" << "RunMemory"
+                                 << to_string(result.runmemory / 1024 / 1024) + "MB" << "Length"
+                                 << to_string(result.length) + "B" << "CompilerInfo" << result.compilerinfo << "Trace"
+                                 << open_array;
+
+        // 判题阶段耗时（纳秒，按阶段编号排列）和各测试用例的沙箱运行、判定耗时
+        for (long long ns : result.trace) {
+            in_array = in_array << (int64_t)ns;
+        }
+        in_array = in_array << close_array << "TraceCases" << open_array;
+        for (long long ns : result.tracecases) {
+            in_array = in_array << (int64_t)ns;
+        }
+        in_array = in_array << close_array << "TestInfo" << open_array;
+
+        // 构造测试信息数组（字符串直接写入 BSON，不再经过中间的 Json 和临时字符串）
+        for (const CaseResult &testinfo : result.testinfo) {
+            in_array = in_array << open_document << "Status" << testinfo.status << "StandardInput"
+                                << testinfo.standardinput << "StandardInputSize" << testinfo.standardinputsize
+                                << "StandardInputHash" << testinfo.standardinputhash << "StandardOutput"
+                                << testinfo.standardoutput << "StandardOutputSize" << testinfo.standardoutputsize
+                                << "StandardOutputHash" << testinfo.standardoutputhash << "PersonalOutput"
+                                << testinfo.personaloutput << "PersonalOutputSize" << testinfo.personaloutputsize
+                                << "PersonalOutputHash" << testinfo.personaloutputhash << "RunTime"
+                                << to_string(testinfo.runtime) + "MS" << "RunMemory"
+                                << to_string(testinfo.runmemory / 1024 / 1024) + "MB" << "MismatchLine"
+                                << testinfo.mismatchline << "MismatchColumn" << testinfo.mismatchcolumn
+                                << close_document;
         }
         bsoncxx::document::value doc = in_array << close_array << close_document << finalize;
 
         // 执行更新操作
-        auto result = statusrecordcoll.update_one({make_document(kvp("_id", submitid))}, doc.view());
+        auto updateresult = statusrecordcoll.update_one({make_document(kvp("_id", submitid))}, doc.view());
         // 返回更新结果
-        return static_cast<bool>(result->modified_count());
+        return static_cast<bool>(updateresult->modified_count());
     } catch (const std::exception &e) {
         return false;
     }
@@ -3749,6 +3984,64 @@ std::string MoDB::GetStatusRecordAuthorId(int64_t statusRecordId) {
         return "";
     }
 }
+
+/**
+ * 功能：查询需要重新评测的测评记录
+ * @name SelectRejudgeRecords
+ * @brief 按题目、用户和提交时间范围查询已完成评测的测评记录，按提交时间先后排列，最多返回 REJUDGE_MAX_RECORDS 条
+ * @param queryjson Json(ProblemId, UserId, StartTime, EndTime)（均可选，提交时间的格式为 "YYYY-MM-DD HH:MM:SS"）
+ * @return Json(success, code, message, data(List[{_id, ProblemId, UserId, Language, Code}], Total))
+ */
+Json::Value MoDB::SelectRejudgeRecords(Json::Value &queryjson) {
+    try {
+        // 构造查询条件（等待评测的记录仍在判题队列中，不重新评测）
+        bsoncxx::builder::basic::document filter{};
+        filter.append(kvp("Status", make_document(kvp("$ne", constants::judge::STATUS_PENDING_JUDGING))));
+        if (queryjson["ProblemId"].asString().size() > 0) {
+            filter.append(kvp("ProblemId", stoll(queryjson["ProblemId"].asString())));
+        }
+        if (queryjson["UserId"].asString().size() > 0) {
+            filter.append(kvp("UserId", stoll(queryjson["UserId"].asString())));
+        }
+        // 提交时间以固定格式的字符串保存，按字典序比较即按时间先后比较
+        bsoncxx::builder::basic::document timerange{};
+        if (queryjson["StartTime"].asString().size() > 0) {
+            timerange.append(kvp("$gte", queryjson["StartTime"].asString()));
+        }
+        if (queryjson["EndTime"].asString().size() > 0) {
+            timerange.append(kvp("$lte", queryjson["EndTime"].asString()));
+        }
+        if (!timerange.view().empty()) {
+            filter.append(kvp("SubmitTime", timerange.extract()));
+        }
+        bsoncxx::document::value filterdoc = filter.extract();
+
+        // 获取数据库连接
+        auto client = pool.acquire();
+        mongocxx::collection statusrecordcoll = (*client)[DATABASE_NAME][COLLECTION_STATUS_RECORDS];
+
+        // 获取总条数
+        int total = static_cast<int>(statusrecordcoll.count_documents(filterdoc.view()));
+
+        mongocxx::pipeline pipe;
+        pipe.match(filterdoc.view());
+        pipe.sort(make_document(kvp("SubmitTime", 1)));
+        pipe.limit(constants::judge::REJUDGE_MAX_RECORDS);
+        pipe.project(make_document(kvp("ProblemId", 1), kvp("UserId", 1), kvp("Language", 1), kvp("Code", 1)));
+
+        Json::Reader reader;
+        Json::Value list(Json::arrayValue);
+        mongocxx::cursor cursor = statusrecordcoll.aggregate(pipe);
+        for (auto doc : cursor) {
+            Json::Value jsonvalue;
+            reader.parse(bsoncxx::to_json(doc), jsonvalue);
+            list.append(jsonvalue);
+        }
+        return response::SuccessList(list, total);
+    } catch (const std::exception &e) {
+        return response::DatabaseError();
+    }
+}
 // ------------------------------ 测评记录模块 End ------------------------------
 
 // ------------------------------ Token 鉴权实现 Start ------------------------------
@@ -3,6 +3,7 @@
 #include <httplib/httplib.h>  // 使用 httplib 作为 HTTP 服务器库
 #include <json/json.h>        // 使用 JsonCpp 处理 JSON 数据
 
+#include <cstdlib>
 #include <fstream>  // C++17 文件系统库
 #include <iostream>
 #include <set>
@@ -12,6 +13,7 @@
 #include "constants/error_code.h"
 #include "constants/server.h"
 #include "core/control.h"
+#include "judger/testdata_store.h"  // 测试数据文件名校验
 #include "services/user_service.h"  // 用户服务（用于登录验证）
 #include "utils/json_utils.h"       // JSON 工具
 #include "utils/param_validator.h"  // 参数校验工具
@@ -52,6 +54,10 @@ void SetResponseStatus(const Json::Value &json, httplib::Response &res) {
         case error_code::STATUS_RECORD_NOT_FOUND:
             res.status = 404;
             break;
+        case error_code::RATE_LIMIT:
+        case error_code::JUDGE_QUEUE_FULL:
+            res.status = 429;
+            break;
         case error_code::INTERNAL_ERROR:
         case error_code::DATABASE_ERROR:
             res.status = 500;
@@ -513,6 +519,187 @@ void doDeleteProblem(const httplib::Request &req, httplib::Response &res) {
     res.set_content(resbody, "application/json; charset=utf-8");
 }
 
+/**
+ * 处理获取题目测试数据清单的请求（管理员权限）
+ */
+void doGetProblemDataManifest(const httplib::Request &req, httplib::Response &res) {
+    cout << "doGetProblemDataManifest start!!!" << endl;
+    Json::Value resjson;
+    // 请求参数校验（ProblemId 是必传参数）
+    string errMsg;
+    if (!validator::ParamValidator::CheckRequired(req, "ProblemId", &errMsg)) {
+        resjson = response::BadRequest(errMsg);
+    } else {
+        // 获取 Token 参数
+        string token = GetRequestToken(req);
+        // 获取题目 ID 参数
+        string problemid = req.get_param_value("ProblemId");
+        Json::Value queryjson;
+        queryjson["Token"] = token;
+        queryjson["ProblemId"] = problemid;
+        // 调用 Control 层处理获取题目测试数据清单逻辑
+        resjson = control.GetProblemDataManifest(queryjson);
+    }
+    cout << "doGetProblemDataManifest end!!!" << endl;
+    SetResponseStatus(resjson, res);
+    string resbody = JsonUtils::GetInstance()->JsonToString(resjson);
+    res.set_content(resbody, "application/json; charset=utf-8");
+}
+
+/**
+ * 处理分页获取题目测试用例信息的请求（管理员权限）
+ * 参数：ProblemId（必传）、Page、PageSize
+ */
+void doGetProblemDataCases(const httplib::Request &req, httplib::Response &res) {
+    cout << "doGetProblemDataCases start!!!" << endl;
+    Json::Value resjson;
+    // 请求参数校验（ProblemId 是必传参数）
+    string errMsg;
+    if (!validator::ParamValidator::CheckRequired(req, "ProblemId", &errMsg)) {
+        resjson = response::BadRequest(errMsg);
+    } else {
+        // 获取 Token 参数
+        string token = GetRequestToken(req);
+        Json::Value queryjson;
+        queryjson["Token"] = token;
+        queryjson["ProblemId"] = req.get_param_value("ProblemId");
+        queryjson["Page"] = req.get_param_value("Page");
+        queryjson["PageSize"] = req.get_param_value("PageSize");
+        // 调用 Control 层处理分页获取题目测试用例信息逻辑
+        resjson = control.SelectProblemDataCases(queryjson);
+    }
+    cout << "doGetProblemDataCases end!!!" << endl;
+    SetResponseStatus(resjson, res);
+    string resbody = JsonUtils::GetInstance()->JsonToString(resjson);
+    res.set_content(resbody, "application/json; charset=utf-8");
+}
+
+/**
+ * 处理获取题目单个测试数据文件的请求（管理员权限）
+ * 参数：ProblemId（必传）、File（必传，<序号>.in、<序号>.out 或 spj.cpp）
+ * 成功时响应体为文件的原始内容，支持 Range 请求（由 httplib 按范围调用内容提供函数），
+ * 内容按块从数据包或数据文件中读取，不整体读入内存；失败时响应体为 JSON
+ */
+void doGetProblemDataFile(const httplib::Request &req, httplib::Response &res) {
+    cout << "doGetProblemDataFile start!!!" << endl;
+    Json::Value resjson;
+    // 请求参数校验（ProblemId 和 File 是必传参数）
+    string errMsg;
+    const vector<string> requiredParams = {"ProblemId", "File"};
+    if (!validator::ParamValidator::CheckRequiredList(req, requiredParams, &errMsg)) {
+        resjson = response::BadRequest(errMsg);
+    } else {
+        // 获取 Token 参数
+        string token = GetRequestToken(req);
+        Json::Value queryjson;
+        queryjson["Token"] = token;
+        queryjson["ProblemId"] = req.get_param_value("ProblemId");
+        queryjson["File"] = req.get_param_value("File");
+        auto sender = [&res](const string &datapath, const string &name, long long size) {
+            res.set_header("Accept-Ranges", "bytes");
+            res.set_header("Content-Disposition", "attachment; filename=\"" + name + "\"");
+            // 版本目录在响应发送完毕（或连接中断）后释放登记
+            res.set_content_provider(
+                size, "application/octet-stream",
+                [datapath, name](size_t offset, size_t length, httplib::DataSink &sink) {
+                    return TestDataStore::StreamFile(datapath, name, offset, length,
+                                                     [&sink](const char *data, size_t size) {
+                                                         return sink.write(data, size);
+                                                     });
+                },
+                [datapath](bool) { TestDataStore::GetInstance()->ReleaseVersion(datapath); });
+        };
+        // 调用 Control 层处理获取题目测试数据文件逻辑
+        resjson = control.SelectProblemDataFile(queryjson, sender);
+    }
+    cout << "doGetProblemDataFile end!!!" << endl;
+    if (resjson["success"].asBool()) {
+        // 响应内容已由 sender 设置
+        return;
+    }
+    SetResponseStatus(resjson, res);
+    string resbody = JsonUtils::GetInstance()->JsonToString(resjson);
+    res.set_content(resbody, "application/json; charset=utf-8");
+}
+
+/**
+ * 处理上传题目测试数据的请求（管理员权限）
+ * 参数在 URL 中：ProblemId（必传）、JudgeNum、BaseVersion、RemoveSPJ、CaseMap、File
+ * CaseMap 为逗号分隔的当前版本测试用例序号，依次对应新版本的每个测试用例（0 表示新增），删除或移动测试用例时传入
+ * 请求体为 multipart/form-data 时每个字段是一个文件（字段名为 <序号>.in、<序号>.out 或 spj.cpp），
+ * 否则整个请求体是 File 参数指定的一个文件（不指定时请求体为空）。请求体不会整体读入内存，而是逐块写入暂存目录
+ */
+void doUploadProblemData(const httplib::Request &req, httplib::Response &res,
+                         const httplib::ContentReader &content_reader) {
+    cout << "doUploadProblemData start!!!" << endl;
+    Json::Value resjson;
+    // 请求参数校验（ProblemId 是必传参数）
+    string errMsg;
+    if (!validator::ParamValidator::CheckRequired(req, "ProblemId", &errMsg)) {
+        resjson = response::BadRequest(errMsg);
+    } else {
+        // 获取 Token 参数
+        string token = GetRequestToken(req);
+        Json::Value uploadjson;
+        uploadjson["Token"] = token;
+        uploadjson["ProblemId"] = req.get_param_value("ProblemId");
+        for (const char *param : {"JudgeNum", "BaseVersion", "CaseMap"}) {
+            if (req.has_param(param)) {
+                uploadjson[param] = req.get_param_value(param);
+            }
+        }
+        uploadjson["RemoveSPJ"] = req.get_param_value("RemoveSPJ") == "true";
+        string filename = req.get_param_value("File");
+
+        // 通过权限校验和题目检查之后才读取请求体
+        auto receiver = [&req, &content_reader, &filename](const string &stagingpath, string &error) {
+            ofstream outfile;
+            auto write = [&outfile](const char *data, size_t length) {
+                outfile.write(data, length);
+                return outfile.good();
+            };
+            bool received;
+            if (req.is_multipart_form_data()) {
+                received = content_reader(
+                    [&](const httplib::MultipartFormData &file) {
+                        outfile.close();
+                        if (!TestDataStore::IsDataFileName(file.name)) {
+                            error = "不支持的测试数据文件名：" + file.name;
+                            return false;
+                        }
+                        outfile.open(stagingpath + file.name, ios::binary | ios::trunc);
+                        return outfile.is_open();
+                    },
+                    write);
+            } else if (filename.empty()) {
+                // 不指定文件时请求体必须为空（只修改测试用例数目或删除 SPJ）
+                received = content_reader([](const char *, size_t length) { return length == 0; });
+            } else {
+                if (!TestDataStore::IsDataFileName(filename)) {
+                    error = "不支持的测试数据文件名：" + filename;
+                    return false;
+                }
+                outfile.open(stagingpath + filename, ios::binary | ios::trunc);
+                received = outfile.is_open() && content_reader(write);
+            }
+            outfile.close();
+            if (!received || outfile.fail()) {
+                if (error.empty()) {
+                    error = "测试数据接收失败";
+                }
+                return false;
+            }
+            return true;
+        };
+        // 调用 Control 层处理上传题目测试数据逻辑
+        resjson = control.UploadProblemData(uploadjson, receiver);
+    }
+    cout << "doUploadProblemData end!!!" << endl;
+    SetResponseStatus(resjson, res);
+    string resbody = JsonUtils::GetInstance()->JsonToString(resjson);
+    res.set_content(resbody, "application/json; charset=utf-8");
+}
+
 /**
  * 处理分页获取题目列表的请求
  */
@@ -1559,6 +1746,80 @@ void doJudgeCode(const httplib::Request &req, httplib::Response &res) {
     string resbody = JsonUtils::GetInstance()->JsonToString(resjson);
     res.set_content(resbody, "application/json; charset=utf-8");
 }
+
+/**
+ * 处理获取判题服务运行状态的请求（管理员权限）
+ */
+void doGetJudgeStats(const httplib::Request &req, httplib::Response &res) {
+    cout << "doGetJudgeStats start!!!" << endl;
+    Json::Value queryjson;
+    // 获取 Token 参数
+    string token = GetRequestToken(req);
+    queryjson["Token"] = token;
+    // 获取可选的 ProblemId 参数（返回该题目的判题阶段耗时统计）
+    queryjson["ProblemId"] = req.get_param_value("ProblemId");
+    // 调用 Control 层处理获取判题服务状态逻辑
+    Json::Value resjson = control.SelectJudgeStats(queryjson);
+    cout << "doGetJudgeStats end!!!" << endl;
+    SetResponseStatus(resjson, res);
+    string resbody = JsonUtils::GetInstance()->JsonToString(resjson);
+    res.set_content(resbody, "application/json; charset=utf-8");
+}
+
+/**
+ * 处理启用或关闭判题结果复用的请求（管理员权限）
+ */
+void doUpdateVerdictCache(const httplib::Request &req, httplib::Response &res) {
+    cout << "doUpdateVerdictCache start!!!" << endl;
+    Json::Value jsonvalue;
+    Json::Reader reader;
+    Json::Value resjson;
+    // 解析传入的 Json
+    if (!reader.parse(req.body, jsonvalue)) {
+        resjson = response::BadRequest("Invalid JSON format");
+    } else {
+        // 请求参数校验（Enabled 是必传参数）
+        string errMsg;
+        // 必传参数列表
+        const vector<string> requiredFields = {"Enabled"};
+        if (!validator::ParamValidator::CheckRequiredList(jsonvalue, requiredFields, &errMsg)) {
+            resjson = response::BadRequest(errMsg);
+        } else {
+            // 参数校验通过，继续处理
+            // 获取 Token 参数
+            string token = GetRequestToken(req);
+            jsonvalue["Token"] = token;
+            resjson = control.UpdateVerdictCache(jsonvalue);
+        }
+    }
+    cout << "doUpdateVerdictCache end!!!" << endl;
+    SetResponseStatus(resjson, res);
+    string resbody = JsonUtils::GetInstance()->JsonToString(resjson);
+    res.set_content(resbody, "application/json; charset=utf-8");
+}
+
+/**
+ * 处理重新评测的请求（管理员权限）
+ */
+void doRejudge(const httplib::Request &req, httplib::Response &res) {
+    cout << "doRejudge start!!!" << endl;
+    Json::Value jsonvalue;
+    Json::Reader reader;
+    Json::Value resjson;
+    // 解析传入的 Json（ProblemId、UserId、StartTime、EndTime 均为可选参数，至少指定一项）
+    if (!reader.parse(req.body, jsonvalue)) {
+        resjson = response::BadRequest("Invalid JSON format");
+    } else {
+        // 获取 Token 参数
+        string token = GetRequestToken(req);
+        jsonvalue["Token"] = token;
+        resjson = control.Rejudge(jsonvalue);
+    }
+    cout << "doRejudge end!!!" << endl;
+    SetResponseStatus(resjson, res);
+    string resbody = JsonUtils::GetInstance()->JsonToString(resjson);
+    res.set_content(resbody, "application/json; charset=utf-8");
+}
 // ------------------------------ 判题模块 End ------------------------------
 
 // ------------------------------ 图片模块 Start ------------------------------
@@ -1618,6 +1879,8 @@ void doGetImage(const httplib::Request &req, httplib::Response &res) {
 // ==================== 公开接口白名单（无需登录即可访问） ====================
 // API 前缀
 const string API = constants::server::API_PREFIX;
+// 测试数据上传接口（唯一允许超过 MAX_REQUEST_BODY_SIZE 的请求体）
+const string UPLOAD_API = API + "/admin/problem/data/upload";
 // 使用 set 存储，查询时间复杂度为 O(log n)
 const std::set<std::string> PUBLIC_API_WHITELIST = {
     // 用户模块
@@ -1680,8 +1943,8 @@ void HttpServer::Run() {
     // 设置工作线程数
     server.new_task_queue = [] { return new ThreadPool(constants::server::MAX_THREAD_COUNT); };
 
-    // 设置请求体大小限制
-    server.set_payload_max_length(constants::server::MAX_REQUEST_BODY_SIZE);
+    // 设置请求体大小限制（测试数据上传接口的上限，其他接口在请求前处理器中按 MAX_REQUEST_BODY_SIZE 限制）
+    server.set_payload_max_length(constants::server::MAX_UPLOAD_BODY_SIZE);
 
     // 设置读取超时时间
     server.set_read_timeout(constants::server::REQUEST_TIMEOUT_SECONDS, 0);
@@ -1700,6 +1963,16 @@ void HttpServer::Run() {
         //     return Server::HandlerResponse::Handled;
         // }
 
+        // 只有测试数据上传接口允许较大的请求体，其他接口在读取请求体之前按 Content-Length 拒绝
+        if (req.path != UPLOAD_API) {
+            unsigned long long length = strtoull(req.get_header_value("Content-Length").c_str(), nullptr, 10);
+            if (length > (unsigned long long)constants::server::MAX_REQUEST_BODY_SIZE ||
+                req.get_header_value("Transfer-Encoding") == "chunked") {
+                res.status = 413;
+                return Server::HandlerResponse::Handled;
+            }
+        }
+
         // 检查是否是公开接口（白名单）
         if (IsPublicApi(req.path)) {
             // 公开接口，无需登录验证，继续处理
@@ -1852,6 +2125,14 @@ void HttpServer::Run() {
     server.Post(API + "/admin/problem/edit", doEditProblem);
     // 删除题目（管理员权限）
     server.Delete(API + "/admin/problem/delete", doDeleteProblem);
+    // 获取题目测试数据的清单（管理员权限）
+    server.Get(API + "/admin/problem/data/manifest", doGetProblemDataManifest);
+    // 分页获取题目测试用例的信息（管理员权限）
+    server.Get(API + "/admin/problem/data/cases", doGetProblemDataCases);
+    // 获取题目的单个测试数据文件（管理员权限，支持 Range 请求）
+    server.Get(API + "/admin/problem/data/file", doGetProblemDataFile);
+    // 上传题目的测试数据（管理员权限，流式接收请求体，只需上传内容变化的文件）
+    server.Post(UPLOAD_API, doUploadProblemData);
     // 分页获取题目列表
     server.Post(API + "/problem/list", doGetProblemList);
     // 分页获取题目列表（管理员权限）
@@ -1937,8 +2218,14 @@ void HttpServer::Run() {
     // -------------------- 测评记录模块 End --------------------
 
     // -------------------- 判题模块 Start --------------------
-    // 返回判题信息
+    // 提交代码进行判题（异步判题，立即返回测评记录 ID）
     server.Post(API + "/judge/code", doJudgeCode);
+    // 获取判题服务运行状态（管理员权限）
+    server.Get(API + "/admin/judge/stats", doGetJudgeStats);
+    // 启用或关闭判题结果复用（管理员权限）
+    server.Post(API + "/admin/judge/verdict-cache", doUpdateVerdictCache);
+    // 按题目、用户和提交时间范围重新评测（管理员权限）
+    server.Post(API + "/admin/judge/rejudge", doRejudge);
     // -------------------- 判题模块 End --------------------
 
     // -------------------- 图片模块 Start --------------------
@@ -1956,6 +2243,7 @@ void HttpServer::Run() {
     cout << "Port: " << constants::server::PORT << endl;
     cout << "Thread Pool Size: " << constants::server::MAX_THREAD_COUNT << endl;
     cout << "Max Request Body: " << constants::server::MAX_REQUEST_BODY_SIZE / 1024 / 1024 << " MB" << endl;
+    cout << "Max Upload Body: " << constants::server::MAX_UPLOAD_BODY_SIZE / 1024 / 1024 << " MB" << endl;
     cout << "Request Timeout: " << constants::server::REQUEST_TIMEOUT_SECONDS << " s" << endl;
     cout << "========================================" << endl;
 
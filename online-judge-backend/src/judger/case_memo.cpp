@@ -0,0 +1,106 @@
+#include "judger/case_memo.h"
+
+#include "constants/judge.h"
+#include "utils/sha256.hpp"
+
+using namespace std;
+
+// 局部静态特性的方式实现单实例模式
+CaseMemo *CaseMemo::GetInstance() {
+    static CaseMemo case_memo;
+    return &case_memo;
+}
+
+// 计算记忆键
+string CaseMemo::GetKey(const string &binarykey, const string &params, const string &inputhash,
+                        const string &outputhash) {
+    if (binarykey.empty()) {
+        return "";
+    }
+    Sha256 sha;
+    // 各字段之间以 '\0' 分隔，避免拼接后产生歧义
+    sha.Update(binarykey).Update("", 1);
+    sha.Update(params).Update("", 1);
+    sha.Update(inputhash).Update("", 1);
+    sha.Update(outputhash);
+    return sha.HexDigest();
+}
+
+// 查找测试用例的判定结果
+bool CaseMemo::Get(const string &key, CaseResult &result, string &reason) {
+    if (key.empty()) {
+        return false;
+    }
+    lock_guard<mutex> lock(memo_mutex);
+    auto iter = entries.find(key);
+    if (iter == entries.end()) {
+        miss_num++;
+        return false;
+    }
+    // 移动到 LRU 链表头部
+    lru.splice(lru.begin(), lru, iter->second.iter);
+    hit_num++;
+    saved_ns += iter->second.judgens;
+    result = iter->second.result;
+    reason = iter->second.reason;
+    return true;
+}
+
+// 保存测试用例的判定结果
+void CaseMemo::Store(const string &key, const CaseResult &result, const string &reason, long long judgens) {
+    // 系统错误与提交的代码无关，不保存；超时和内存超限受评测机负载影响，重新评测时需要重新运行，同样不保存
+    if (key.empty() || result.status == constants::judge::STATUS_SYSTEM_ERROR ||
+        result.status == constants::judge::STATUS_TIME_LIMIT_EXCEEDED ||
+        result.status == constants::judge::STATUS_MEMORY_LIMIT_EXCEEDED) {
+        return;
+    }
+    long long bytes = sizeof(Entry) + key.size() + reason.size() + result.standardinput.size() +
+                      result.standardoutput.size() + result.personaloutput.size() + result.standardinputhash.size() +
+                      result.standardoutputhash.size() + result.personaloutputhash.size();
+    if (bytes > constants::judge::CASE_MEMO_MAX_BYTES) {
+        return;
+    }
+
+    lock_guard<mutex> lock(memo_mutex);
+    auto iter = entries.find(key);
+    if (iter != entries.end()) {
+        total_bytes -= iter->second.bytes;
+        lru.erase(iter->second.iter);
+        entries.erase(iter);
+    }
+    lru.push_front(key);
+    entries[key] = {result, reason, judgens, bytes, lru.begin()};
+    total_bytes += bytes;
+    store_num++;
+    // 超出上限时按最近最少使用的顺序淘汰
+    while (total_bytes > constants::judge::CASE_MEMO_MAX_BYTES && !lru.empty()) {
+        auto victim = entries.find(lru.back());
+        total_bytes -= victim->second.bytes;
+        entries.erase(victim);
+        lru.pop_back();
+    }
+}
+
+// 获取测试用例结果记忆的运行状态
+Json::Value CaseMemo::GetStats() {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(memo_mutex);
+        resjson["EntryNum"] = (Json::UInt64)entries.size();
+        resjson["TotalBytes"] = (Json::Int64)total_bytes;
+    }
+    resjson["MaxBytes"] = (Json::Int64)constants::judge::CASE_MEMO_MAX_BYTES;
+    resjson["HitNum"] = (Json::Int64)hit_num.load();
+    resjson["MissNum"] = (Json::Int64)miss_num.load();
+    resjson["StoreNum"] = (Json::Int64)store_num.load();
+    resjson["SavedMs"] = (Json::Int64)(saved_ns.load() / 1000000);
+    return resjson;
+}
+
+CaseMemo::CaseMemo() : total_bytes(0), hit_num(0), miss_num(0), store_num(0), saved_ns(0) {
+    // 构造函数实现
+}
+
+CaseMemo::~CaseMemo() {
+    // 析构函数实现
+}
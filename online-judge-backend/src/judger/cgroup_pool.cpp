@@ -0,0 +1,119 @@
+#include "judger/cgroup_pool.h"
+
+#include <sys/stat.h>
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+
+#include "constants/judge.h"
+#include "judger/cgroup_sandbox.hpp"
+
+using namespace std;
+
+// 判题使用的控制器
+static const char *CONTROLLERS = "+cpuset +memory +pids";
+
+// cgroup 中是否可用 cpuset、memory 和 pids 控制器
+static bool HasControllers(const string &path) {
+    ifstream infile(path + "/cgroup.controllers");
+    set<string> controllers;
+    string name;
+    while (infile >> name) {
+        controllers.insert(name);
+    }
+    return controllers.count("cpuset") && controllers.count("memory") && controllers.count("pids");
+}
+
+// 局部静态特性的方式实现单实例模式
+CgroupPool *CgroupPool::GetInstance() {
+    static CgroupPool cgroup_pool;
+    return &cgroup_pool;
+}
+
+// 获取 CPU 对应的槽位 cgroup 目录
+string CgroupPool::GetSlotPath(int cpu) {
+    if (!enabled || cpu < 0) {
+        return "";
+    }
+    string path = constants::judge::CGROUP_ROOT + string("/slot") + to_string(cpu);
+    lock_guard<mutex> lock(pool_mutex);
+    if (slots.count(cpu)) {
+        return path;
+    }
+    // 槽位 cgroup 中不放进程，每次运行的子 cgroup 继承它的 cpuset
+    if ((mkdir(path.data(), 0755) != 0 && errno != EEXIST) ||
+        !cgroup_sandbox::WriteFile(path + "/cpuset.cpus", to_string(cpu)) ||
+        !cgroup_sandbox::WriteFile(path + "/cgroup.subtree_control", "+memory +pids")) {
+        return "";
+    }
+    slots.insert(cpu);
+    return path;
+}
+
+// 获取空闲的沙箱启动器所在的 cgroup 目录
+string CgroupPool::GetHomePath() {
+    return constants::judge::CGROUP_ROOT + string("/launcher");
+}
+
+// 记录一次请求使用 cgroup 的运行
+void CgroupPool::Record(bool accounted, bool oomkilled) {
+    if (accounted) {
+        accounted_num++;
+    } else {
+        unaccounted_num++;
+    }
+    if (oomkilled) {
+        oomkill_num++;
+    }
+}
+
+// 获取评测槽位 cgroup 池的运行状态
+Json::Value CgroupPool::GetStats() {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        resjson["SlotNum"] = (Json::UInt64)slots.size();
+    }
+    resjson["Enabled"] = enabled;
+    resjson["Root"] = constants::judge::CGROUP_ROOT;
+    resjson["Error"] = error;
+    resjson["AccountedNum"] = (Json::Int64)accounted_num.load();
+    resjson["UnaccountedNum"] = (Json::Int64)unaccounted_num.load();
+    resjson["OomKillNum"] = (Json::Int64)oomkill_num.load();
+    return resjson;
+}
+
+CgroupPool::CgroupPool() : enabled(false), accounted_num(0), unaccounted_num(0), oomkill_num(0) {
+    // 构造函数实现
+    if (!constants::judge::CGROUP_ENABLED) {
+        error = "未启用";
+        return;
+    }
+    string root = constants::judge::CGROUP_ROOT;
+    string parent = root.substr(0, root.find_last_of('/'));
+    // 父 cgroup 可能还没有向子 cgroup 开放控制器（已开放时写入无副作用）
+    cgroup_sandbox::WriteFile(parent + "/cgroup.subtree_control", CONTROLLERS);
+    if (mkdir(root.data(), 0755) != 0 && errno != EEXIST) {
+        error = "无法创建 " + root + "：" + strerror(errno);
+        return;
+    }
+    if (!HasControllers(root)) {
+        error = "cgroup v2 不可用或父 cgroup 中缺少 cpuset、memory、pids 控制器";
+        return;
+    }
+    if (!cgroup_sandbox::WriteFile(root + "/cgroup.subtree_control", CONTROLLERS)) {
+        error = "无法在 " + root + " 中启用控制器";
+        return;
+    }
+    string home = GetHomePath();
+    if (mkdir(home.data(), 0755) != 0 && errno != EEXIST) {
+        error = "无法创建 " + home;
+        return;
+    }
+    enabled = true;
+}
+
+CgroupPool::~CgroupPool() {
+    // 析构函数实现
+}
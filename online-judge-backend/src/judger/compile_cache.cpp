@@ -0,0 +1,219 @@
+#include "judger/compile_cache.h"
+
+#include <algorithm>
+#include <filesystem>
+#include <functional>
+#include <thread>
+
+#include "constants/judge.h"
+#include "judger/subprocess.h"
+#include "utils/sha256.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// 获取目录下所有普通文件的总大小
+static long long GetDirSize(const fs::path &path) {
+    long long size = 0;
+    error_code ec;
+    for (auto iter = fs::recursive_directory_iterator(path, ec); !ec && iter != fs::recursive_directory_iterator();
+         iter.increment(ec)) {
+        if (iter->is_regular_file(ec)) {
+            size += iter->file_size(ec);
+        }
+    }
+    return size;
+}
+
+// 局部静态特性的方式实现单实例模式
+CompileCache *CompileCache::GetInstance() {
+    static CompileCache compile_cache;
+    return &compile_cache;
+}
+
+// 获取编译器版本信息
+string CompileCache::GetCompilerVersion(const string &versioncmd) {
+    lock_guard<mutex> lock(version_mutex);
+    auto iter = versions.find(versioncmd);
+    if (iter != versions.end()) {
+        return iter->second;
+    }
+    // 版本信息可能输出到标准输出或标准错误（如 java -version）
+    SubprocessOptions options;
+    options.mergestdout = true;
+    options.timeout = constants::judge::COMPILE_TIMEOUT;
+    string version = Subprocess::Run(Subprocess::Split(versioncmd), options).output;
+    versions[versioncmd] = version;
+    return version;
+}
+
+// 计算缓存键
+string CompileCache::GetKey(const string &language, const string &versioncmd, const string &flags,
+                            const string &source) {
+    string version = GetCompilerVersion(versioncmd);
+    Sha256 sha;
+    // 各字段之间以 '\0' 分隔，避免拼接后产生歧义
+    sha.Update(language).Update("", 1);
+    sha.Update(version).Update("", 1);
+    sha.Update(flags).Update("", 1);
+    sha.Update(source);
+    return sha.HexDigest();
+}
+
+// 从缓存恢复编译结果到运行目录
+bool CompileCache::Restore(const string &key, const string &runpath, bool hardlink) {
+    fs::path entrypath = cache_path + key;
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        auto iter = entries.find(key);
+        if (iter == entries.end()) {
+            miss_num++;
+            return false;
+        }
+        // 移动到 LRU 链表头部
+        lru.splice(lru.begin(), lru, iter->second.iter);
+    }
+
+    error_code ec;
+    for (auto iter = fs::recursive_directory_iterator(entrypath, ec); !ec && iter != fs::recursive_directory_iterator();
+         iter.increment(ec)) {
+        fs::path target = fs::path(runpath) / iter->path().lexically_relative(entrypath);
+        if (iter->is_directory(ec)) {
+            fs::create_directories(target, ec);
+        } else if (hardlink) {
+            fs::create_hard_link(iter->path(), target, ec);
+            if (ec) {
+                // 跨文件系统等无法硬链接的情况，退化为复制
+                ec.clear();
+                fs::copy_file(iter->path(), target, fs::copy_options::overwrite_existing, ec);
+            }
+        } else {
+            fs::copy_file(iter->path(), target, fs::copy_options::overwrite_existing, ec);
+        }
+        if (ec) {
+            break;
+        }
+    }
+    if (ec) {
+        // 缓存项在恢复过程中被淘汰，按未命中处理，由调用方重新编译
+        miss_num++;
+        return false;
+    }
+    // 更新目录的修改时间，重启后据此恢复 LRU 顺序
+    fs::last_write_time(entrypath, fs::file_time_type::clock::now(), ec);
+    hit_num++;
+    return true;
+}
+
+// 保存编译结果到缓存
+void CompileCache::Store(const string &key, const string &runpath, const vector<string> &artifacts) {
+    fs::path entrypath = cache_path + key;
+    // 先写入临时目录，再整体重命名，保证其他线程看到的缓存项总是完整的
+    fs::path tmppath = cache_path + ".tmp." + key + "." + to_string(hash<thread::id>{}(this_thread::get_id()));
+
+    error_code ec;
+    fs::remove_all(tmppath, ec);
+    fs::create_directories(tmppath, ec);
+    if (ec) {
+        return;
+    }
+
+    vector<string> files = artifacts;
+    files.push_back("compileinfo.txt");
+    for (auto &file : files) {
+        fs::path source = fs::path(runpath) / file;
+        if (!fs::exists(source, ec)) {
+            continue;
+        }
+        fs::copy(source, tmppath / file, fs::copy_options::recursive, ec);
+        if (ec) {
+            fs::remove_all(tmppath, ec);
+            return;
+        }
+    }
+    long long size = GetDirSize(tmppath);
+
+    fs::rename(tmppath, entrypath, ec);
+    if (ec) {
+        // 其他线程已经缓存了相同的键
+        fs::remove_all(tmppath, ec);
+        return;
+    }
+
+    vector<string> victims;
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        if (entries.count(key) == 0) {
+            lru.push_front(key);
+            entries[key] = {size, lru.begin()};
+            total_bytes += size;
+        }
+        victims = Evict();
+    }
+    for (auto &victim : victims) {
+        fs::remove_all(cache_path + victim, ec);
+    }
+}
+
+// 淘汰缓存项直到总大小不超过上限
+vector<string> CompileCache::Evict() {
+    vector<string> victims;
+    // 至少保留最近使用的一项
+    while (total_bytes > constants::judge::COMPILE_CACHE_MAX_BYTES && lru.size() > 1) {
+        string key = lru.back();
+        lru.pop_back();
+        total_bytes -= entries[key].size;
+        entries.erase(key);
+        victims.push_back(key);
+    }
+    return victims;
+}
+
+// 获取编译缓存的运行状态
+Json::Value CompileCache::GetStats() {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        resjson["EntryNum"] = (Json::UInt64)entries.size();
+        resjson["TotalBytes"] = (Json::Int64)total_bytes;
+    }
+    resjson["MaxBytes"] = (Json::Int64)constants::judge::COMPILE_CACHE_MAX_BYTES;
+    resjson["HitNum"] = (Json::Int64)hit_num.load();
+    resjson["MissNum"] = (Json::Int64)miss_num.load();
+    return resjson;
+}
+
+CompileCache::CompileCache()
+    : cache_path(constants::judge::COMPILE_CACHE_PATH), total_bytes(0), hit_num(0), miss_num(0) {
+    // 构造函数实现
+    // 扫描缓存目录，按修改时间恢复 LRU 顺序，并清理上次异常退出残留的临时目录
+    error_code ec;
+    fs::create_directories(cache_path, ec);
+
+    vector<pair<fs::file_time_type, string>> found;
+    for (auto iter = fs::directory_iterator(cache_path, ec); !ec && iter != fs::directory_iterator();
+         iter.increment(ec)) {
+        string name = iter->path().filename().string();
+        if (name.empty() || name[0] == '.') {
+            error_code rmec;
+            fs::remove_all(iter->path(), rmec);
+            continue;
+        }
+        error_code timeec;
+        found.emplace_back(fs::last_write_time(iter->path(), timeec), name);
+    }
+    sort(found.begin(), found.end(), greater<pair<fs::file_time_type, string>>());
+    for (auto &item : found) {
+        long long size = GetDirSize(cache_path + item.second);
+        lru.push_back(item.second);
+        entries[item.second] = {size, prev(lru.end())};
+        total_bytes += size;
+    }
+    for (auto &victim : Evict()) {
+        fs::remove_all(cache_path + victim, ec);
+    }
+}
+
+CompileCache::~CompileCache() {
+    // 析构函数实现
+}
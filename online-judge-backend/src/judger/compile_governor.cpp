@@ -0,0 +1,149 @@
+#include "judger/compile_governor.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <chrono>
+#include <fstream>
+
+#include "constants/judge.h"
+
+using namespace std;
+
+// 局部静态特性的方式实现单实例模式
+CompileGovernor *CompileGovernor::GetInstance() {
+    static CompileGovernor compile_governor;
+    return &compile_governor;
+}
+
+// 获取编译一份代码的预估内存
+long long CompileGovernor::EstimateMemory(const string &language) {
+    long long estimate = constants::judge::COMPILE_MEMORY_ESTIMATE_BYTES;
+    if (language == constants::judge::LANG_CPP || language == constants::judge::LANG_JAVA) {
+        return estimate;
+    }
+    // C 和 Go 的编译器占用明显更少，Python 只生成字节码
+    if (language == constants::judge::LANG_C || language == constants::judge::LANG_GO) {
+        return estimate / 4;
+    }
+    return estimate / 16;
+}
+
+// 获取系统可用内存
+long long CompileGovernor::GetAvailableMemory() {
+    ifstream infile("/proc/meminfo");
+    string key;
+    long long value;
+    string unit;
+    while (infile >> key >> value) {
+        getline(infile, unit);
+        if (key == "MemAvailable:") {
+            return value * 1024;
+        }
+    }
+    return -1;
+}
+
+// 申请编译准入
+long long CompileGovernor::Acquire(const string &language) {
+    long long estimate = EstimateMemory(language);
+    auto start = chrono::steady_clock::now();
+    bool waited = false, memorydeferred = false, loaddeferred = false, forced = false;
+
+    unique_lock<mutex> lock(governor_mutex);
+    while (true) {
+        if (active_num < constants::judge::COMPILE_WORKER_COUNT) {
+            // 已准入的编译可能还没有用到预估的内存，从可用内存中扣除，宁可保守
+            long long available = GetAvailableMemory();
+            bool memoryok = available < 0 || available - active_bytes - estimate >=
+                                                 constants::judge::COMPILE_MEMORY_RESERVE_BYTES;
+            double load = 0;
+            bool loadok = getloadavg(&load, 1) != 1 || load < cpu_num * constants::judge::COMPILE_MAX_LOAD_PER_CPU;
+            if (memoryok && loadok) {
+                break;
+            }
+            if (active_num == 0) {
+                // 没有正在运行的编译时总是准入，否则资源持续紧张时编译阶段会停滞
+                forced = true;
+                break;
+            }
+            memorydeferred = memorydeferred || !memoryok;
+            loaddeferred = loaddeferred || !loadok;
+        }
+        waited = true;
+        // 可用内存和负载不会通知，定期重新检查；有编译结束时提前唤醒
+        governor_cond.wait_for(lock, chrono::milliseconds(constants::judge::COMPILE_ADMISSION_POLL_MS));
+    }
+    active_num++;
+    active_bytes += estimate;
+    lock.unlock();
+
+    admit_num++;
+    if (waited) {
+        wait_num++;
+        long long us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        wait_us += us;
+        long long maxus = max_wait_us.load();
+        while (us > maxus && !max_wait_us.compare_exchange_weak(maxus, us)) {
+        }
+    }
+    memory_defer_num += memorydeferred;
+    load_defer_num += loaddeferred;
+    forced_num += forced;
+    return estimate;
+}
+
+// 编译结束，释放准入
+void CompileGovernor::Release(long long bytes) {
+    {
+        lock_guard<mutex> lock(governor_mutex);
+        active_num--;
+        active_bytes -= bytes;
+    }
+    governor_cond.notify_one();
+}
+
+// 获取编译准入控制的运行状态
+Json::Value CompileGovernor::GetStats() {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(governor_mutex);
+        resjson["ActiveNum"] = active_num;
+    }
+    double load = 0;
+    getloadavg(&load, 1);
+    long long admits = admit_num.load();
+    resjson["MaxActiveNum"] = constants::judge::COMPILE_WORKER_COUNT;
+    resjson["AvailableBytes"] = (Json::Int64)GetAvailableMemory();
+    resjson["LoadAverage"] = load;
+    resjson["AdmitNum"] = (Json::Int64)admits;
+    resjson["WaitNum"] = (Json::Int64)wait_num.load();
+    resjson["MemoryDeferNum"] = (Json::Int64)memory_defer_num.load();
+    resjson["LoadDeferNum"] = (Json::Int64)load_defer_num.load();
+    resjson["ForcedNum"] = (Json::Int64)forced_num.load();
+    resjson["AvgWaitUs"] = admits > 0 ? (double)wait_us.load() / admits : 0.0;
+    resjson["MaxWaitUs"] = (Json::Int64)max_wait_us.load();
+    return resjson;
+}
+
+CompileGovernor::CompileGovernor()
+    : active_num(0),
+      active_bytes(0),
+      cpu_num(1),
+      admit_num(0),
+      wait_num(0),
+      memory_defer_num(0),
+      load_defer_num(0),
+      forced_num(0),
+      wait_us(0),
+      max_wait_us(0) {
+    // 构造函数实现
+    long cpus = sysconf(_SC_NPROCESSORS_ONLN);
+    if (cpus > 0) {
+        cpu_num = cpus;
+    }
+}
+
+CompileGovernor::~CompileGovernor() {
+    // 析构函数实现
+}
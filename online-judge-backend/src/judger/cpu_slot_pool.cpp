@@ -0,0 +1,83 @@
+#include "judger/cpu_slot_pool.h"
+
+#include <pthread.h>
+#include <sched.h>
+
+#include <algorithm>
+
+#include "constants/judge.h"
+
+using namespace std;
+
+// 局部静态特性的方式实现单实例模式
+CpuSlotPool *CpuSlotPool::GetInstance() {
+    static CpuSlotPool cpu_slot_pool;
+    return &cpu_slot_pool;
+}
+
+// 申请评测 CPU
+vector<int> CpuSlotPool::Acquire(int maxnum) {
+    vector<int> cpus;
+    if (total_num == 0 || maxnum <= 0) {
+        return cpus;
+    }
+    unique_lock<mutex> lock(pool_mutex);
+    // 至少等待一个空闲的 CPU，避免与其他评测槽位共享核心
+    pool_cond.wait(lock, [this] { return !free_cpus.empty(); });
+    while (!free_cpus.empty() && (int)cpus.size() < maxnum) {
+        cpus.push_back(free_cpus.back());
+        free_cpus.pop_back();
+    }
+    return cpus;
+}
+
+// 归还评测 CPU
+void CpuSlotPool::Release(const vector<int> &cpus) {
+    if (cpus.empty()) {
+        return;
+    }
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        free_cpus.insert(free_cpus.end(), cpus.begin(), cpus.end());
+    }
+    pool_cond.notify_all();
+}
+
+// 将当前线程绑定到指定的 CPU 上
+bool CpuSlotPool::BindCurrentThread(int cpu) {
+    if (cpu < 0) {
+        return false;
+    }
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    CPU_SET(cpu, &cpuset);
+    return pthread_setaffinity_np(pthread_self(), sizeof(cpuset), &cpuset) == 0;
+}
+
+CpuSlotPool::CpuSlotPool() : total_num(0) {
+    // 构造函数实现
+    // 获取进程允许使用的 CPU，跳过保留给 HTTP 服务和数据库的前几个 CPU
+    cpu_set_t cpuset;
+    CPU_ZERO(&cpuset);
+    if (sched_getaffinity(0, sizeof(cpuset), &cpuset) != 0) {
+        return;
+    }
+    int reserved = constants::judge::JUDGE_RESERVED_CPU_COUNT;
+    for (int cpu = 0; cpu < CPU_SETSIZE; cpu++) {
+        if (!CPU_ISSET(cpu, &cpuset)) {
+            continue;
+        }
+        if (reserved > 0) {
+            reserved--;
+            continue;
+        }
+        free_cpus.push_back(cpu);
+    }
+    // 倒序存放，优先分配编号较小的 CPU
+    reverse(free_cpus.begin(), free_cpus.end());
+    total_num = free_cpus.size();
+}
+
+CpuSlotPool::~CpuSlotPool() {
+    // 析构函数实现
+}
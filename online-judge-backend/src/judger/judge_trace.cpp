@@ -0,0 +1,190 @@
+#include "judger/judge_trace.h"
+
+#include <algorithm>
+#include <chrono>
+
+#include "constants/judge.h"
+
+using namespace std;
+
+// 各阶段的名称（与 JudgeStage 的顺序一致）
+static const char *STAGE_NAMES[STAGE_COUNT] = {
+    "Queue", "Workspace", "Source", "Spj", "Admission", "Compile", "RunQueue",
+    "Execute", "Run", "Compare", "Record", "Statistics", "Total",
+};
+
+JudgeTrace::JudgeTrace() {
+    // 构造函数实现
+    Reset();
+}
+
+// 单调时钟的当前时间
+long long JudgeTrace::Now() {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// 获取阶段名称
+const char *JudgeTrace::GetStageName(int stage) {
+    return stage >= 0 && stage < STAGE_COUNT ? STAGE_NAMES[stage] : "";
+}
+
+// 清空记录的耗时
+void JudgeTrace::Reset() {
+    fill(begin(stages_), end(stages_), 0);
+    caseruns_.clear();
+    casecompares_.clear();
+}
+
+// 累加阶段耗时
+void JudgeTrace::Add(JudgeStage stage, long long ns) {
+    stages_[stage] += max(ns, 0LL);
+}
+
+long long JudgeTrace::Get(JudgeStage stage) const {
+    return stages_[stage];
+}
+
+// 设置测试用例数目
+void JudgeTrace::SetCaseNum(int casenum) {
+    caseruns_.assign(casenum, 0);
+    casecompares_.assign(casenum, 0);
+}
+
+// 记录单个测试用例的沙箱运行和判定耗时
+void JudgeTrace::SetCase(int index, long long runns, long long comparens) {
+    if (index < 1 || index > (int)caseruns_.size()) {
+        return;
+    }
+    caseruns_[index - 1] = runns;
+    casecompares_[index - 1] = comparens;
+    Add(STAGE_RUN, runns);
+    Add(STAGE_COMPARE, comparens);
+}
+
+// 写入测评记录的阶段耗时
+vector<long long> JudgeTrace::GetRecordStages() const {
+    return vector<long long>(stages_, stages_ + STAGE_RECORD);
+}
+
+// 写入测评记录的测试用例耗时
+vector<long long> JudgeTrace::GetRecordCases() const {
+    vector<long long> cases;
+    cases.reserve(caseruns_.size() * 2);
+    for (size_t i = 0; i < caseruns_.size(); i++) {
+        cases.push_back(caseruns_[i]);
+        cases.push_back(casecompares_[i]);
+    }
+    return cases;
+}
+
+// 局部静态特性的方式实现单实例模式
+JudgeTraceStats *JudgeTraceStats::GetInstance() {
+    static JudgeTraceStats judge_trace_stats;
+    return &judge_trace_stats;
+}
+
+// 创建空的各阶段直方图
+JudgeTraceStats::StageHistograms JudgeTraceStats::NewHistograms() {
+    Histogram histogram = {0, 0, 0, vector<long long>(constants::judge::TRACE_HISTOGRAM_BUCKETS, 0)};
+    return {0, vector<Histogram>(STAGE_COUNT, histogram)};
+}
+
+// 将一次提交计入各阶段直方图
+void JudgeTraceStats::Merge(StageHistograms &histograms, const JudgeTrace &trace) {
+    histograms.submitnum++;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        long long ns = trace.Get((JudgeStage)i);
+        // 没有经过的阶段不计入（如编译错误的提交没有运行阶段）
+        if (ns <= 0) {
+            continue;
+        }
+        Histogram &histogram = histograms.stages[i];
+        int bucket = min(63 - __builtin_clzll((unsigned long long)ns), constants::judge::TRACE_HISTOGRAM_BUCKETS - 1);
+        histogram.buckets[bucket]++;
+        histogram.count++;
+        histogram.sum += ns;
+        histogram.max = max(histogram.max, ns);
+    }
+}
+
+// 各阶段直方图转换为 Json
+Json::Value JudgeTraceStats::ToJson(const StageHistograms &histograms) {
+    Json::Value resjson;
+    resjson["SubmitNum"] = (Json::Int64)histograms.submitnum;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        const Histogram &histogram = histograms.stages[i];
+        Json::Value stagejson;
+        stagejson["Count"] = (Json::Int64)histogram.count;
+        stagejson["AvgNs"] = histogram.count > 0 ? (Json::Int64)(histogram.sum / histogram.count) : 0;
+        stagejson["MaxNs"] = (Json::Int64)histogram.max;
+        // 分位数取所在桶的上界（不超过最大值），误差在 2 倍以内
+        const double quantiles[] = {0.5, 0.9, 0.99};
+        const char *names[] = {"P50Ns", "P90Ns", "P99Ns"};
+        for (int q = 0; q < 3; q++) {
+            long long rank = (long long)(quantiles[q] * histogram.count + 0.5), seen = 0, value = 0;
+            for (int b = 0; b < constants::judge::TRACE_HISTOGRAM_BUCKETS && histogram.count > 0; b++) {
+                seen += histogram.buckets[b];
+                if (seen >= max(rank, 1LL)) {
+                    value = b < 62 ? min(1LL << (b + 1), histogram.max) : histogram.max;
+                    break;
+                }
+            }
+            stagejson[names[q]] = (Json::Int64)value;
+        }
+        Json::Value buckets(Json::arrayValue);
+        for (long long num : histogram.buckets) {
+            buckets.append((Json::Int64)num);
+        }
+        stagejson["Buckets"] = buckets;
+        resjson[JudgeTrace::GetStageName(i)] = stagejson;
+    }
+    return resjson;
+}
+
+// 记录一次提交的判题阶段耗时
+void JudgeTraceStats::Record(const string &language, const string &problemid, const JudgeTrace &trace) {
+    lock_guard<mutex> lock(stats_mutex);
+    auto language_it = languages.find(language);
+    if (language_it == languages.end()) {
+        language_it = languages.emplace(language, NewHistograms()).first;
+    }
+    Merge(language_it->second, trace);
+
+    auto problem_it = problems.find(problemid);
+    if (problem_it == problems.end()) {
+        if (problems.size() >= static_cast<size_t>(constants::judge::TRACE_MAX_PROBLEMS)) {
+            dropped_problem_num++;
+            return;
+        }
+        problem_it = problems.emplace(problemid, NewHistograms()).first;
+    }
+    Merge(problem_it->second, trace);
+}
+
+// 获取判题阶段耗时统计
+Json::Value JudgeTraceStats::GetStats(const string &problemid) {
+    Json::Value resjson;
+    for (int i = 0; i < STAGE_COUNT; i++) {
+        resjson["Stages"].append(JudgeTrace::GetStageName(i));
+    }
+    lock_guard<mutex> lock(stats_mutex);
+    resjson["Languages"] = Json::objectValue;
+    for (const auto &item : languages) {
+        resjson["Languages"][item.first] = ToJson(item.second);
+    }
+    resjson["ProblemNum"] = (Json::UInt64)problems.size();
+    resjson["DroppedProblemNum"] = (Json::Int64)dropped_problem_num;
+    if (!problemid.empty()) {
+        auto it = problems.find(problemid);
+        resjson["Problem"] = it != problems.end() ? ToJson(it->second) : Json::Value(Json::nullValue);
+    }
+    return resjson;
+}
+
+JudgeTraceStats::JudgeTraceStats() : dropped_problem_num(0) {
+    // 构造函数实现
+}
+
+JudgeTraceStats::~JudgeTraceStats() {
+    // 析构函数实现
+}
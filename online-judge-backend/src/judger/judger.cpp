@@ -1,14 +1,36 @@
 #include "judger/judger.h"
 
-#include <string.h>
+#include <signal.h>
 #include <sys/stat.h>
+#include <sys/wait.h>
 #include <unistd.h>
 
+#include <atomic>
+#include <chrono>
+#include <cstdio>
 #include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iostream>
+#include <thread>
+#include <vector>
 
 #include "constants/judge.h"
+#include "judger/case_memo.h"
+#include "judger/cgroup_pool.h"
+#include "judger/compile_cache.h"
+#include "judger/compile_governor.h"
+#include "judger/cpu_slot_pool.h"
+#include "judger/jvm_cds.h"
+#include "judger/launcher_pool.h"
+#include "judger/output_comparator.h"
+#include "judger/pch_cache.h"
+#include "judger/spj_cache.h"
+#include "judger/subprocess.h"
+#include "judger/testdata_cache.h"
+#include "judger/testdata_store.h"
+#include "judger/workspace_pool.h"
+#include "utils/sha256.hpp"
 
 extern "C" {
 #include "judger/runner.h"
@@ -23,79 +45,80 @@ size_t GetFileSize(const char *fileName) {
     }
     struct stat statbuf;
 
-    stat(fileName, &statbuf);
+    if (stat(fileName, &statbuf) != 0) {
+        return 0;
+    }
 
     size_t filesize = statbuf.st_size;
 
     return filesize;
 }
 
-Judger::Judger() {}
+Judger::Judger() : m_workspace(-1) {}
+
+Judger::~Judger() {
+    // 析构函数实现
+    // Done 归还后 m_workspace 为 -1，这里只处理异常或提前返回而未归还的工作区，否则槽位耗尽后判题线程会一直阻塞
+    if (m_workspace >= 0) {
+        WorkspacePool::GetInstance()->Release(m_workspace);
+        m_workspace = -1;
+    }
+}
+
+JudgeResult Judger::Run(Json::Value &runjson) {
+    // 编译 运行
+    if (!Compile(runjson)) {
+        return Done();
+    }
+    return Execute();
+}
 
-Json::Value Judger::Run(Json::Value &runjson) {
+// 编译阶段
+bool Judger::Compile(Json::Value &runjson) {
     // 初始化数据
     if (!Init(runjson)) {
-        return Done();
+        return false;
     }
 
-    // 编译 运行
+    // 编译阶段的耗时不包括等待编译准入的时间（在 CompileWithCache 中单独记录）
+    long long start = JudgeTrace::Now(), admission = m_trace.Get(STAGE_ADMISSION);
+    bool success = false;
     if (m_language == constants::judge::LANG_C) {
-        if (!CompileC()) {
-            return Done();
-        }
-
-        if (!RunProgramC_Cpp()) {
-            return Done();
-        }
+        success = CompileC();
     } else if (m_language == constants::judge::LANG_CPP) {
-        if (!CompileCpp()) {
-            return Done();
-        }
-
-        if (!RunProgramC_Cpp()) {
-            return Done();
-        }
+        success = CompileCpp();
     } else if (m_language == constants::judge::LANG_GO) {
-        if (!CompileGo()) {
-            return Done();
-        }
-
-        if (!RunProgramGo()) {
-            return Done();
-        }
+        success = CompileGo();
     } else if (m_language == constants::judge::LANG_JAVA) {
-        if (!CompileJava()) {
-            return Done();
-        }
-
-        if (!RunProgramJava()) {
-            return Done();
-        }
+        success = CompileJava();
     } else if (m_language == constants::judge::LANG_PYTHON2) {
-        if (!CompilePython2()) {
-            return Done();
-        }
-
-        if (!RunProgramPython2()) {
-            return Done();
-        }
+        success = CompilePython2();
     } else if (m_language == constants::judge::LANG_PYTHON3) {
-        if (!CompilePython3()) {
-            return Done();
-        }
-
-        if (!RunProgramPython3()) {
-            return Done();
-        }
+        success = CompilePython3();
     } else if (m_language == constants::judge::LANG_JAVASCRIPT) {
-        if (!CompileJavaScript()) {
-            return Done();
-        }
+        success = CompileJavaScript();
+    }
+    m_trace.Add(STAGE_COMPILE, JudgeTrace::Now() - start - (m_trace.Get(STAGE_ADMISSION) - admission));
+    return success;
+}
 
-        if (!RunProgramJavaScript()) {
-            return Done();
-        }
+// 运行阶段
+JudgeResult Judger::Execute() {
+    long long start = JudgeTrace::Now();
+    if (m_language == constants::judge::LANG_C || m_language == constants::judge::LANG_CPP) {
+        RunProgramC_Cpp();
+    } else if (m_language == constants::judge::LANG_GO) {
+        RunProgramGo();
+    } else if (m_language == constants::judge::LANG_JAVA) {
+        RunProgramJava();
+    } else if (m_language == constants::judge::LANG_PYTHON2) {
+        RunProgramPython2();
+    } else if (m_language == constants::judge::LANG_PYTHON3) {
+        RunProgramPython3();
+    } else if (m_language == constants::judge::LANG_JAVASCRIPT) {
+        RunProgramJavaScript();
     }
+    m_trace.Add(STAGE_EXECUTE, JudgeTrace::Now() - start);
 
     return Done();
 }
@@ -105,14 +128,33 @@ Json::Value Judger::Run(Json::Value &runjson) {
  */
 bool Judger::Init(Json::Value &initjson) {
     // 初始化数据
-    // Json(StatusRecordId, ProblemId, JudgeNum, Code, Language, TimeLimit, MemoryLimit)
+    // Json(StatusRecordId, ProblemId, JudgeNum, JudgeMode, CompareMode, CompareEpsilon, Code, Language, TimeLimit,
+    // MemoryLimit, OutputLimit, EnqueueTime, Rejudge)
+    m_trace.Reset();
+    // 进入判题队列的时间由判题服务设置（直接调用 Run 时没有）
+    if (initjson["EnqueueTime"].isNumeric()) {
+        m_trace.Add(STAGE_QUEUE, JudgeTrace::Now() - initjson["EnqueueTime"].asInt64());
+    }
     m_statusrecordid = initjson["StatusRecordId"].asString();
     m_problemid = initjson["ProblemId"].asString();
     m_code = initjson["Code"].asString();
 
     m_judgenum = initjson["JudgeNum"].asInt();
+    // 未设置评测模式的题目按 OI 模式评测全部测试用例
+    m_stoponfailure = initjson["JudgeMode"].asString() == constants::judge::JUDGE_MODE_ICPC;
+    m_comparemode = OutputComparator::ParseMode(initjson["CompareMode"].asString());
+    m_compareepsilon = initjson["CompareEpsilon"].isNumeric() ? initjson["CompareEpsilon"].asDouble() : 0;
+    if (!(m_compareepsilon > 0 && m_compareepsilon <= 1)) {
+        m_compareepsilon = constants::judge::COMPARE_FLOAT_EPSILON;
+    }
     m_timelimit = initjson["TimeLimit"].asInt();
     m_memorylimit = initjson["MemoryLimit"].asLargestInt() * 1024 * 1024;
+    // 未设置输出限制的题目使用默认值
+    long long outputlimit = initjson["OutputLimit"].isNumeric() ? initjson["OutputLimit"].asLargestInt() : 0;
+    if (outputlimit <= 0 || outputlimit > constants::judge::MAX_OUTPUT_LIMIT_MB) {
+        outputlimit = constants::judge::DEFAULT_OUTPUT_LIMIT_MB;
+    }
+    m_outputlimit = outputlimit * 1024 * 1024;
     m_language = initjson["Language"].asString();
     m_maxtimelimit = m_timelimit * 2;
     m_maxmemorylimie = m_memorylimit * 2;
@@ -120,21 +162,38 @@ bool Judger::Init(Json::Value &initjson) {
     m_reason = "";
     m_runmemory = 0;
     m_runtime = 0;
+    m_length = 0;
     m_isspj = false;
+    m_spjpath = "";
+    m_usezygote = false;
+    m_rejudge = initjson["Rejudge"].asBool();
+    m_binarykey = "";
+    m_compileinfo = "";
+
+    // 热门题目的测试数据直接从内存中获取
+    m_testdata = TestDataCache::GetInstance()->Get(m_problemid, m_judgenum);
+    // 判题期间始终使用同一个数据版本的目录，题目数据被更新也不影响正在进行的判题
+    DATA_PATH = m_testdata->datapath;
+
+    m_judgeresult = JudgeResult();
+    if (!m_testdata->complete) {
+        // 测试数据导出失败或与清单不一致，按系统错误结束，避免给出错误的判定结果
+        m_result = SE;
+        return false;
+    }
 
-    RUN_PATH = constants::judge::RUN_PATH_PREFIX + m_statusrecordid + "/";
-    DATA_PATH = constants::judge::PROBLEM_DATA_PREFIX + m_problemid + "/";
-
-    m_resjson.clear();
-
-    // 创建中间文件夹
-    m_command = "mkdir -p " + RUN_PATH;
-    if (system(m_command.data()) == -1) {
+    // 签出评测工作区作为运行目录
+    long long start = JudgeTrace::Now();
+    m_workspace = WorkspacePool::GetInstance()->Acquire();
+    m_trace.Add(STAGE_WORKSPACE, JudgeTrace::Now() - start);
+    if (m_workspace < 0) {
         m_result = SE;
         return false;
     }
+    RUN_PATH = WorkspacePool::GetInstance()->GetPath(m_workspace);
 
     // 将代码输出到文件中
+    start = JudgeTrace::Now();
     ofstream outfile;
     if (m_language == constants::judge::LANG_C) {
         m_command = RUN_PATH + "main.c";
@@ -162,10 +221,14 @@ bool Judger::Init(Json::Value &initjson) {
     outfile << m_code.data();
     outfile.close();
 
-    m_length = to_string(GetFileSize(m_command.data())) + "B";
+    m_length = GetFileSize(m_command.data());
+    m_trace.Add(STAGE_SOURCE, JudgeTrace::Now() - start);
 
-    // 编译 spj 文件
-    if (!CompileSPJ()) {
+    // 获取 spj 文件
+    start = JudgeTrace::Now();
+    bool spjready = CompileSPJ();
+    m_trace.Add(STAGE_SPJ, JudgeTrace::Now() - start);
+    if (!spjready) {
         m_result = SE;
         return false;
     }
@@ -174,9 +237,9 @@ bool Judger::Init(Json::Value &initjson) {
 }
 
 bool Judger::CompileSPJ() {
-    // 如果存在可执行文件 spj
-    m_command = DATA_PATH + "spj";
-    if (access(m_command.data(), F_OK) == 0) {
+    // SPJ 在创建或修改题目时已经编译好，这里只解析当前版本，判题过程中题目被修改也不会切换 SPJ
+    m_spjpath = SpjCache::GetInstance()->Resolve(m_problemid, DATA_PATH);
+    if (!m_spjpath.empty()) {
         m_isspj = true;
         return true;
     }
@@ -188,36 +251,89 @@ bool Judger::CompileSPJ() {
         return true;
     }
 
-    // 编译 SPJ 文件
-    m_command = "timeout 10 g++ " + DATA_PATH + "spj.cpp -o " + DATA_PATH + "spj -O2 -std=c++17";
-    if (system(m_command.data()) == -1) {
+    // 兼容在引入 SPJ 缓存之前上传、尚未编译过的题目数据
+    string compileinfo;
+    if (!SpjCache::GetInstance()->Build(m_problemid, compileinfo, DATA_PATH)) {
         m_result = SE;
         return false;
     }
-    return true;
+    m_spjpath = SpjCache::GetInstance()->Resolve(m_problemid, DATA_PATH);
+    m_isspj = !m_spjpath.empty();
+    return m_isspj;
 }
 
 bool Judger::GetCompilationFailed() {
-    ifstream infile;
-
-    // 只要编译就会有这个文件
-    m_command = RUN_PATH + "compileinfo.txt";
-    infile.open(m_command.data());
-    // 读取全部信息
-    string reason((istreambuf_iterator<char>(infile)), (istreambuf_iterator<char>()));
-    m_reason = reason;
+    // 编译信息在编译时已经捕获（或从编译缓存中恢复）
+    m_reason = m_compileinfo;
     m_result = CE;
-    infile.close();
 
     return true;
 }
 
+// 在运行目录中执行编译命令，命中编译缓存时直接恢复编译产物和编译信息
+// pchcommand 为使用预编译头的等价命令（为空时不使用），pchforced 表示其编译失败时需要回退为 command
+bool Judger::CompileWithCache(const vector<string> &command, const string &versioncmd, const vector<string> &artifacts,
+                              bool hardlink, const vector<string> &pchcommand, bool pchforced) {
+    // 编译命令中只使用相对路径，编译信息中不会出现运行目录，缓存可以在不同提交之间共享
+    string cachekey = CompileCache::GetInstance()->GetKey(m_language, versioncmd, Subprocess::Join(command), m_code);
+    // 缓存的键同样标识了编译产物，用于测试用例结果记忆
+    m_binarykey = cachekey;
+    if (CompileCache::GetInstance()->Restore(cachekey, RUN_PATH, hardlink)) {
+        ifstream infile(RUN_PATH + "compileinfo.txt");
+        m_compileinfo.assign(istreambuf_iterator<char>(infile), istreambuf_iterator<char>());
+        return true;
+    }
+
+    SubprocessOptions options;
+    options.workdir = RUN_PATH;
+    options.timeout = constants::judge::COMPILE_TIMEOUT;
+    options.outputlimit = constants::judge::WORKSPACE_SLOT_QUOTA_BYTES;
+    options.maxcapture = constants::judge::COMPILE_INFO_MAX_BYTES;
+
+    // 启动编译器之前申请准入，避免多个编译同时占满内存或与正在计时的测试用例争抢 CPU
+    long long admissionstart = JudgeTrace::Now();
+    long long admitted = CompileGovernor::GetInstance()->Acquire(m_language);
+    m_trace.Add(STAGE_ADMISSION, JudgeTrace::Now() - admissionstart);
+    auto start = chrono::steady_clock::now();
+    bool usepch = !pchcommand.empty(), fallback = false;
+    SubprocessResult res = Subprocess::Run(usepch ? pchcommand : command, options);
+    if (usepch && pchforced && !res.Success()) {
+        // 强制包含的头文件与提交的代码冲突，按提交原本的头文件重新编译
+        fallback = true;
+        usepch = false;
+        res = Subprocess::Run(command, options);
+    }
+    CompileGovernor::GetInstance()->Release(admitted);
+    if (m_language == constants::judge::LANG_CPP) {
+        auto us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+        PchCache::GetInstance()->Record(usepch, fallback, us);
+    }
+    if (!res.started) {
+        return false;
+    }
+    m_compileinfo = res.output;
+    if (res.truncated) {
+        m_compileinfo += "\n（编译信息过长，已截断）\n";
+    }
+    // 编译超时可能只是机器繁忙，不缓存
+    if (res.timedout) {
+        m_compileinfo += "\n编译超时（超过 " + to_string(constants::judge::COMPILE_TIMEOUT / 1000) + " 秒）\n";
+        return true;
+    }
+    // 编译信息随编译产物一起缓存
+    if (!m_compileinfo.empty()) {
+        ofstream outfile(RUN_PATH + "compileinfo.txt");
+        outfile << m_compileinfo;
+    }
+    CompileCache::GetInstance()->Store(cachekey, RUN_PATH, artifacts);
+    return true;
+}
+
 // 编译 C 函数
 bool Judger::CompileC() {
     // 进行gcc编译
-    m_command = "timeout 10 gcc " + RUN_PATH + "main.c -fmax-errors=3 -o " + RUN_PATH + "main -O2 -std=c11 2>" +
-                RUN_PATH + "compileinfo.txt";
-    if (system(m_command.data()) == -1) {
+    vector<string> command = {"gcc", "main.c", "-fmax-errors=3", "-o", "main", "-O2", "-std=c11"};
+    if (!CompileWithCache(command, "gcc --version", {"main"}, true)) {
         m_result = SE;
         return false;
     }
@@ -234,10 +350,20 @@ bool Judger::CompileC() {
 
 // 编译 C++ 函数
 bool Judger::CompileCpp() {
-    // 进行g++编译
-    m_command = "timeout 10 g++ " + RUN_PATH + "main.cpp -fmax-errors=3 -o " + RUN_PATH + "main -O2 -std=c++11 2>" +
-                RUN_PATH + "compileinfo.txt";
-    if (system(m_command.data()) == -1) {
+    // 进行g++编译，提交的头文件与预编译头匹配时使用预编译头（编译缓存的键不受影响）
+    string flags = "-O2 -std=c++11";
+    vector<string> command = {"g++", "main.cpp", "-fmax-errors=3", "-o", "main"};
+    for (auto &flag : Subprocess::Split(flags)) {
+        command.push_back(flag);
+    }
+    PchCache::Usage pch = PchCache::GetInstance()->Select(flags, m_code);
+    vector<string> pchcommand;
+    if (!pch.args.empty()) {
+        pchcommand = {command[0]};
+        pchcommand.insert(pchcommand.end(), pch.args.begin(), pch.args.end());
+        pchcommand.insert(pchcommand.end(), command.begin() + 1, command.end());
+    }
+    if (!CompileWithCache(command, "g++ --version", {"main"}, true, pchcommand, pch.forced)) {
         m_result = SE;
         return false;
     }
@@ -255,8 +381,7 @@ bool Judger::CompileCpp() {
 // 编译 Go 函数
 bool Judger::CompileGo() {
     // 进行go编译
-    m_command = "go build -o " + RUN_PATH + "main " + RUN_PATH + "main.go 2>" + RUN_PATH + "compileinfo.txt";
-    if (system(m_command.data()) == -1) {
+    if (!CompileWithCache({"go", "build", "-o", "main", "main.go"}, "go version", {"main"}, true)) {
         m_result = SE;
         return false;
     }
@@ -275,16 +400,13 @@ bool Judger::CompileGo() {
 bool Judger::CompileJava() {
     // 创建目标目录
     std::string outputDir = RUN_PATH + "Main";
-    if (access(outputDir.data(), F_OK) == -1) {
-        if (system(("mkdir -p " + outputDir).c_str()) == -1) {
-            m_result = SE;
-            return false;
-        }
+    if (mkdir(outputDir.data(), 0755) == -1 && access(outputDir.data(), F_OK) == -1) {
+        m_result = SE;
+        return false;
     }
 
-    // 进行 java 编译
-    m_command = "javac " + RUN_PATH + "Main.java -d " + outputDir + " 2>" + RUN_PATH + "compileinfo.txt";
-    if (system(m_command.data()) == -1) {
+    // 进行 java 编译（Java 运行时不受 seccomp 规则限制，缓存产物以复制方式恢复，避免被运行中的程序改写）
+    if (!CompileWithCache({"javac", "Main.java", "-d", "Main"}, "javac -version", {"Main"}, false)) {
         m_result = SE;
         return false;
     }
@@ -303,8 +425,7 @@ bool Judger::CompileJava() {
 // 编译 Python2 函数
 bool Judger::CompilePython2() {
     // 进行 Python2 编译
-    m_command = "python2 -m py_compile " + RUN_PATH + "main.py 2>" + RUN_PATH + "compileinfo.txt";
-    if (system(m_command.data()) == -1) {
+    if (!CompileWithCache({"python2", "-m", "py_compile", "main.py"}, "python2 --version", {"main.pyc"}, false)) {
         m_result = SE;
         return false;
     }
@@ -322,8 +443,7 @@ bool Judger::CompilePython2() {
 // 编译 Python3 函数
 bool Judger::CompilePython3() {
     // 进行 Python3 编译
-    m_command = "python3 -m py_compile " + RUN_PATH + "main.py 2>" + RUN_PATH + "compileinfo.txt";
-    if (system(m_command.data()) == -1) {
+    if (!CompileWithCache({"python3", "-m", "py_compile", "main.py"}, "python3 --version", {"__pycache__"}, false)) {
         m_result = SE;
         return false;
     }
@@ -340,21 +460,26 @@ bool Judger::CompilePython3() {
 
 // 编译 JavaScript 函数
 bool Judger::CompileJavaScript() {
-    // 进行 JavaScript 编译
-    m_command = "/usr/bin/nodejs --check " + RUN_PATH + "main.js 2>" + RUN_PATH + "compileinfo.txt";
-    if (system(m_command.data()) == -1) {
+    // 进行 JavaScript 语法检查（不生成编译产物，按退出码判断是否通过）
+    SubprocessOptions options;
+    options.workdir = RUN_PATH;
+    options.timeout = constants::judge::COMPILE_TIMEOUT;
+    options.maxcapture = constants::judge::COMPILE_INFO_MAX_BYTES;
+    SubprocessResult res = Subprocess::Run({"/usr/bin/nodejs", "--check", "main.js"}, options);
+    if (!res.started) {
         m_result = SE;
         return false;
     }
 
-    // TODO:不能返回错误，因为肯定有这个文件
-    m_command = RUN_PATH + "main.js";
     // 编译失败
-    if (access(m_command.data(), F_OK) == -1) {
+    if (!res.Success()) {
         // 返回编译失败原因
+        m_compileinfo = res.output;
         GetCompilationFailed();
         return false;
     }
+    // 没有编译产物，按解释器版本和源代码标识运行的程序（用于测试用例结果记忆）
+    m_binarykey = CompileCache::GetInstance()->GetKey(m_language, "/usr/bin/nodejs --version", "", m_code);
     return true;
 }
 
@@ -368,18 +493,14 @@ bool Judger::RunProgramC_Cpp() {
     conf.max_memory = m_maxmemorylimie;
     conf.max_stack = 32 * 1024 * 1024;
     conf.max_process_number = 200;
-    conf.max_output_size = -1;
+    conf.max_output_size = m_outputlimit + 1;
     conf.memory_limit_check_only = 0;
     conf.uid = 0;
     conf.gid = 0;
     conf.seccomp_rule_name = (char *)"c_cpp";
 
     string exe_path = RUN_PATH + "main";
-    string error_path = RUN_PATH + "error.out";
-    string log_path = RUN_PATH + "judger.log";
     conf.exe_path = (char *)exe_path.data();
-    conf.error_path = (char *)error_path.data();
-    conf.log_path = (char *)log_path.data();
 
     RunProgram(&conf);
     return true;
@@ -395,18 +516,14 @@ bool Judger::RunProgramGo() {
     conf.max_memory = m_maxmemorylimie;
     conf.max_stack = 32 * 1024 * 1024;
     conf.max_process_number = 200;
-    conf.max_output_size = -1;
+    conf.max_output_size = m_outputlimit + 1;
     conf.memory_limit_check_only = 1;
     conf.uid = 0;
     conf.gid = 0;
     conf.seccomp_rule_name = (char *)"golang";
 
     string exe_path = RUN_PATH + "main";
-    string error_path = RUN_PATH + "error.out";
-    string log_path = RUN_PATH + "judger.log";
     conf.exe_path = (char *)exe_path.data();
-    conf.error_path = (char *)error_path.data();
-    conf.log_path = (char *)log_path.data();
 
     conf.env[0] = (char *)"LANG=en_US.UTF-8";
     conf.env[1] = (char *)"LANGUAGE=en_US:en";
@@ -420,36 +537,39 @@ bool Judger::RunProgramGo() {
 bool Judger::RunProgramJava() {
     // 创建配置结构体
     struct config conf = {};
-    m_memorylimit = m_memorylimit * 3;  // Java 的空间限制为原来的三倍
+    // Java 的空间限制按倍数放大；时间限制只放大沙箱的限制，判定超时仍使用原时间限制
+    m_memorylimit = m_memorylimit * constants::judge::JAVA_MEMORY_FACTOR;
 
-    conf.max_cpu_time = m_timelimit * 3;
-    conf.max_real_time = m_maxtimelimit * 3;
+    conf.max_cpu_time = m_timelimit * constants::judge::JAVA_TIME_FACTOR;
+    conf.max_real_time = m_maxtimelimit * constants::judge::JAVA_TIME_FACTOR;
     conf.max_memory = -1;  // Java 不能限制内存，在虚拟机中限制
     conf.max_stack = 32 * 1024 * 1024;
     conf.max_process_number = 200;
-    conf.max_output_size = -1;
+    conf.max_output_size = m_outputlimit + 1;
     conf.memory_limit_check_only = 1;
     conf.uid = 0;
     conf.gid = 0;
     conf.seccomp_rule_name = nullptr;
 
     string exe_path = "/usr/bin/java";
-    string error_path = RUN_PATH + "error.out";
-    string log_path = RUN_PATH + "judger.log";
     string exe_file = RUN_PATH + "Main";
     string tmp_maxmemory = "-XX:MaxRAM=" + to_string(m_memorylimit) + "k";
 
     conf.exe_path = (char *)exe_path.data();
-    conf.error_path = (char *)error_path.data();
-    conf.log_path = (char *)log_path.data();
 
-    conf.args[0] = (char *)"/usr/bin/java";
-    conf.args[1] = (char *)"-cp";
-    conf.args[2] = (char *)exe_file.data();
-    conf.args[3] = (char *)tmp_maxmemory.data();
-    conf.args[4] = (char *)"-Djava.security.policy==policy";
-    conf.args[5] = (char *)"-Djava.awt.headless=true";
-    conf.args[6] = (char *)"Main";
+    // 固定的启动参数和 CDS 归档（归档生成完成前只使用启动参数）
+    vector<string> launchargs = JvmCds::GetInstance()->GetLaunchArgs();
+    int argc = 0;
+    conf.args[argc++] = (char *)"/usr/bin/java";
+    for (auto &arg : launchargs) {
+        conf.args[argc++] = (char *)arg.data();
+    }
+    conf.args[argc++] = (char *)"-cp";
+    conf.args[argc++] = (char *)exe_file.data();
+    conf.args[argc++] = (char *)tmp_maxmemory.data();
+    conf.args[argc++] = (char *)"-Djava.security.policy==policy";
+    conf.args[argc++] = (char *)"-Djava.awt.headless=true";
+    conf.args[argc++] = (char *)"Main";
 
     conf.env[0] = (char *)"LANG=en_US.UTF-8";
     conf.env[1] = (char *)"LANGUAGE=en_US:en";
@@ -469,20 +589,16 @@ bool Judger::RunProgramPython2() {
     conf.max_memory = m_maxmemorylimie * 2;
     conf.max_stack = 32 * 1024 * 1024;
     conf.max_process_number = 200;
-    conf.max_output_size = -1;
+    conf.max_output_size = m_outputlimit + 1;
     conf.memory_limit_check_only = 0;
     conf.uid = 0;
     conf.gid = 0;
     conf.seccomp_rule_name = (char *)"general";
 
     string exe_path = "/usr/bin/python2";
-    string error_path = RUN_PATH + "error.out";
-    string log_path = RUN_PATH + "judger.log";
     string exe_file = RUN_PATH + "main.pyc";
 
     conf.exe_path = (char *)exe_path.data();
-    conf.error_path = (char *)error_path.data();
-    conf.log_path = (char *)log_path.data();
 
     conf.args[0] = (char *)"/usr/bin/python2";
     conf.args[1] = (char *)exe_file.data();
@@ -491,6 +607,8 @@ bool Judger::RunProgramPython2() {
     conf.env[1] = (char *)"LANGUAGE=en_US:en";
     conf.env[2] = (char *)"LC_ALL=en_US.UTF-8";
 
+    // 可选地由 zygote 运行，各测试用例共享一次解释器启动
+    m_usezygote = constants::judge::ZYGOTE_ENABLED;
     RunProgram(&conf);
     return true;
 }
@@ -505,20 +623,16 @@ bool Judger::RunProgramPython3() {
     conf.max_memory = m_maxmemorylimie * 2;
     conf.max_stack = 32 * 1024 * 1024;
     conf.max_process_number = 200;
-    conf.max_output_size = -1;
+    conf.max_output_size = m_outputlimit + 1;
     conf.memory_limit_check_only = 0;
     conf.uid = 0;
     conf.gid = 0;
     conf.seccomp_rule_name = (char *)"general";
 
     string exe_path = "/usr/bin/python3";
-    string error_path = RUN_PATH + "error.out";
-    string log_path = RUN_PATH + "judger.log";
     string exe_file = RUN_PATH + "__pycache__/main.cpython-38.pyc";
 
     conf.exe_path = (char *)exe_path.data();
-    conf.error_path = (char *)error_path.data();
-    conf.log_path = (char *)log_path.data();
 
     conf.args[0] = (char *)"/usr/bin/python3";
     conf.args[1] = (char *)exe_file.data();
@@ -528,6 +642,8 @@ bool Judger::RunProgramPython3() {
     conf.env[2] = (char *)"LC_ALL=en_US.UTF-8";
     conf.env[3] = (char *)"PYTHONIOENCODING=utf-8";
 
+    // 可选地由 zygote 运行，各测试用例共享一次解释器启动
+    m_usezygote = constants::judge::ZYGOTE_ENABLED;
     RunProgram(&conf);
     return true;
 }
@@ -542,20 +658,16 @@ bool Judger::RunProgramJavaScript() {
     conf.max_memory = m_maxmemorylimie * 2;
     conf.max_stack = 32 * 1024 * 1024;
     conf.max_process_number = 200;
-    conf.max_output_size = -1;
+    conf.max_output_size = m_outputlimit + 1;
     conf.memory_limit_check_only = 1;
     conf.uid = 0;
     conf.gid = 0;
     conf.seccomp_rule_name = (char *)"node";
 
     string exe_path = "/usr/bin/nodejs";
-    string error_path = RUN_PATH + "error.out";
-    string log_path = RUN_PATH + "judger.log";
     string exe_file = RUN_PATH + "main.js";
 
     conf.exe_path = (char *)exe_path.data();
-    conf.error_path = (char *)error_path.data();
-    conf.log_path = (char *)log_path.data();
 
     conf.args[0] = (char *)"/usr/bin/nodejs";
     conf.args[1] = (char *)exe_file.data();
@@ -568,139 +680,270 @@ bool Judger::RunProgramJavaScript() {
     return true;
 }
 
+// 运行单个测试用例
+void Judger::RunCase(struct config *conf, int index, struct result *res, JudgeSlot *slot) {
+    // 每个测试用例使用独立的输出、错误输出和日志文件，便于多个槽位并行评测
+    string input_path = m_testdata->casepath + to_string(index) + ".in";
+    string output_path = RUN_PATH + to_string(index) + ".out";
+    string error_path = RUN_PATH + to_string(index) + ".err";
+    string log_path = RUN_PATH + to_string(index) + ".log";
+    conf->input_path = (char *)input_path.data();
+    conf->output_path = (char *)output_path.data();
+    conf->error_path = (char *)error_path.data();
+    conf->log_path = (char *)log_path.data();
+
+    // 运行程序（zygote 运行失败时按冷启动方式运行，启动器不可用时在本进程内运行）
+    if (slot->zygote != nullptr && slot->zygote->Run(conf, res)) {
+        return;
+    }
+    // 槽位的 cgroup 限制沙箱进程的内存（tmpfs 上的输出文件同样计入，另加工作区的大小上限）和进程数
+    cgroup_sandbox::SandboxCgroup cgroup = {slot->cgroup, CgroupPool::GetHomePath(),
+                                            m_memorylimit * 2 + constants::judge::WORKSPACE_SLOT_QUOTA_BYTES,
+                                            conf->max_process_number};
+    if (LauncherPool::GetInstance()->Run(slot->launcher, slot->cpu, cgroup, conf, res)) {
+        return;
+    }
+    run(conf, res);
+}
+
 // 运行程序并判定所有测试用例
 bool Judger::RunProgram(struct config *conf) {
-    struct result res = {};
-
-    for (int i = 1; i <= m_judgenum; i++) {
-        string index = to_string(i);
-        string input_path = DATA_PATH + index + ".in";
-        string output_path = RUN_PATH + index + ".out";
-        conf->input_path = (char *)input_path.data();
-        conf->output_path = (char *)output_path.data();
+    vector<struct result> results(m_judgenum + 1);
+    vector<CaseResult> testinfos(m_judgenum + 1);
+    vector<string> reasons(m_judgenum + 1);
+    // 各测试用例的沙箱运行和判定耗时（合并结果时计入判题阶段耗时）
+    vector<long long> runns(m_judgenum + 1, 0), comparens(m_judgenum + 1, 0);
+
+    // 测试用例的判定结果还取决于评测参数和 SPJ（SPJ 可执行文件的路径随版本变化）
+    char params[128];
+    snprintf(params, sizeof(params), "%d %.17g %d %ld %ld", (int)m_comparemode, m_compareepsilon, m_timelimit,
+             m_memorylimit, m_outputlimit);
+    string memoparams = m_spjpath + '\0' + params;
+
+    // 已失败的最小测试用例编号，ICPC 模式下编号更大的测试用例不再运行
+    atomic<int> firstfailure(m_judgenum + 1);
+
+    // 申请评测 CPU，每个槽位绑定一个 CPU，各槽位从同一个计数器中依次领取测试用例
+    int maxslots = min(constants::judge::JUDGE_CASE_PARALLEL_SLOTS, m_judgenum);
+    vector<int> cpus = CpuSlotPool::GetInstance()->Acquire(maxslots);
+    atomic<int> nextindex(1);
+    auto runslot = [&](int cpu) {
+        CpuSlotPool::BindCurrentThread(cpu);
+        struct config slotconf = *conf;
+        // 每个槽位签出一个沙箱启动器，由启动器绑定到槽位的 CPU 后 fork 沙箱进程
+        JudgeSlot slot;
+        slot.cpu = cpu;
+        slot.launcher = LauncherPool::GetInstance()->Acquire();
+        slot.cgroup = CgroupPool::GetInstance()->GetSlotPath(cpu);
+        // 每个槽位启动一个 zygote（绑定 CPU 之后启动，继承该绑定），启动失败时按冷启动方式运行
+        if (m_usezygote) {
+            slot.zygote = make_unique<Zygote>();
+            if (!slot.zygote->Start(&slotconf)) {
+                slot.zygote.reset();
+            }
+        }
+        for (int i = nextindex++; i <= m_judgenum; i = nextindex++) {
+            if (m_stoponfailure && i > firstfailure.load()) {
+                break;
+            }
+            // 重新评测时，编译产物、评测参数和测试用例内容都没有变化的测试用例直接使用记忆的结果
+            string memokey = CaseMemo::GetKey(m_binarykey, memoparams, m_testdata->inputhashes[i],
+                                              m_testdata->outputhashes[i]);
+            if (!m_rejudge || !CaseMemo::GetInstance()->Get(memokey, testinfos[i], reasons[i])) {
+                results[i] = {};
+                long long start = JudgeTrace::Now();
+                RunCase(&slotconf, i, &results[i], &slot);
+                long long judgmentstart = JudgeTrace::Now();
+                testinfos[i] = JudgmentResult(&results[i], to_string(i));
+                reasons[i] = GetCaseReason(testinfos[i].status, to_string(i));
+                runns[i] = judgmentstart - start;
+                comparens[i] = JudgeTrace::Now() - judgmentstart;
+                // 判定后不再需要用户输出、错误输出和日志，立即删除，工作区中只保留各槽位正在运行的测试用例的输出
+                unlink((RUN_PATH + to_string(i) + ".out").data());
+                unlink((RUN_PATH + to_string(i) + ".err").data());
+                unlink((RUN_PATH + to_string(i) + ".log").data());
+                CaseMemo::GetInstance()->Store(memokey, testinfos[i], reasons[i], runns[i] + comparens[i]);
+            }
+            if (testinfos[i].status != AC) {
+                int failure = firstfailure.load();
+                while (i < failure && !firstfailure.compare_exchange_weak(failure, i)) {
+                }
+            }
+        }
+        LauncherPool::GetInstance()->Release(slot.launcher);
+    };
 
-        // 运行程序
-        run(conf, &res);
+    if (cpus.empty()) {
+        // 没有可绑定的 CPU，直接在当前线程中串行评测
+        runslot(-1);
+    } else {
+        vector<thread> slots;
+        for (int cpu : cpus) {
+            slots.emplace_back(runslot, cpu);
+        }
+        for (auto &slot : slots) {
+            slot.join();
+        }
+        CpuSlotPool::GetInstance()->Release(cpus);
+    }
 
-        // 判断结果
-        JudgmentResult(&res, index);
+    // 按测试用例编号依次合并结果，保证 TestInfo 的顺序和最终结果与串行评测一致
+    // ICPC 模式下首个失败用例之后的测试用例（包括并行时已经运行完的）均记为跳过
+    m_trace.SetCaseNum(m_judgenum);
+    for (int i = 1; i <= m_judgenum; i++) {
+        m_trace.SetCase(i, runns[i], comparens[i]);
+        if (m_stoponfailure && i > firstfailure.load()) {
+            SkipResult();
+        } else {
+            MergeResult(testinfos[i], reasons[i]);
+        }
     }
     return true;
 }
 
-// 判断单个测试用例结果
-void Judger::JudgmentResult(struct result *res, string &index) {
+// 判断单个测试用例结果（只读取文件，不修改判题机状态，可在多个槽位中并行调用）
+CaseResult Judger::JudgmentResult(struct result *res, const string &index) {
     // 保存本次测试结果
-    Json::Value testinfo;  // Json(Status, RunTime, RunMemory, StandardInput, StandardOutput, PersonalOutput)
-    // 获取最大时间和空间
-    m_runtime = max(m_runtime, res->cpu_time);
-    m_runmemory = max(m_runmemory, res->memory);
+    CaseResult testinfo;
 
     // 获取运行时间和运行内存的数据
-    testinfo["RunTime"] = to_string(res->cpu_time) + "MS";
-    testinfo["RunMemory"] = to_string(res->memory / 1024 / 1024) + "MB";
-
-    // 获取标准输入
-    ifstream infile;
-    string indatapath = DATA_PATH + index + ".in";
-    infile.open(indatapath.data());
-    string standardinput((istreambuf_iterator<char>(infile)), (istreambuf_iterator<char>()));
-    infile.close();
-    // 获取标准答案
-    ifstream infile1;
-    string datapath = DATA_PATH + index + ".out";
-    infile1.open(datapath.data());
-    string standardanswer((istreambuf_iterator<char>(infile1)), (istreambuf_iterator<char>()));
-    infile1.close();
+    testinfo.runtime = res->cpu_time;
+    testinfo.runmemory = res->memory;
+
+    // 获取标准输入和标准答案（直接使用缓存中映射的测试数据）
+    int i = stoi(index);
+    const MappedFile &standardinput = *m_testdata->inputs[i];
+    const MappedFile &standardanswer = *m_testdata->outputs[i];
+    string indatapath = m_testdata->casepath + index + ".in";
+    string datapath = m_testdata->casepath + index + ".out";
     // 获取计算答案
-    ifstream infile2;
     string runpath = RUN_PATH + index + ".out";
-    infile2.open(runpath.data());
-    string calculateanswer((istreambuf_iterator<char>(infile2)), (istreambuf_iterator<char>()));
-    infile2.close();
-
-    testinfo["StandardInput"] = standardinput;
-    testinfo["StandardOutput"] = standardanswer;
-    testinfo["PersonalOutput"] = calculateanswer;
+    MappedFile calculateanswer;
+    calculateanswer.Open(runpath);
+
+    // 测评记录中只保存预览、大小和哈希值，完整的测试数据可按题目 ID 和测试用例编号从题目数据目录中获取
+    testinfo.standardinput = TestDataStore::Preview(standardinput.Data(), standardinput.Size());
+    testinfo.standardinputsize = standardinput.Size();
+    testinfo.standardinputhash = m_testdata->inputhashes[i];
+    testinfo.standardoutput = TestDataStore::Preview(standardanswer.Data(), standardanswer.Size());
+    testinfo.standardoutputsize = standardanswer.Size();
+    testinfo.standardoutputhash = m_testdata->outputhashes[i];
+    testinfo.personaloutput = TestDataStore::Preview(calculateanswer.Data(), calculateanswer.Size());
+    testinfo.personaloutputsize = calculateanswer.Size();
+    testinfo.personaloutputhash = Sha256().Update(calculateanswer.Data(), calculateanswer.Size()).HexDigest();
 
     // 判断结果
-    if (res->result == 0) {
+    // 沙箱的文件大小上限比输出限制多 1 字节，恰好达到输出限制的输出仍然合法，超出时写入失败：
+    // C/C++ 等程序被 SIGXFSZ 终止，忽略该信号的运行时（Python、Java）则继续运行或异常退出，因此同时按输出文件的大小判断
+    if (res->signal == SIGXFSZ || (long long)calculateanswer.Size() > m_outputlimit ||
+        GetFileSize((RUN_PATH + index + ".err").data()) > (size_t)m_outputlimit) {
+        testinfo.status = OLE;
+    } else if (res->result == 0) {
         // 判断是否超出时间限制
         if (res->cpu_time > m_timelimit) {
-            m_result = TLE;
-            testinfo["Status"] = TLE;
+            testinfo.status = TLE;
         } else if (res->memory > m_memorylimit) {
-            m_result = MLE;
-            testinfo["Status"] = MLE;
+            testinfo.status = MLE;
         } else if (m_isspj) {  // SPJ 判断
-            m_command = DATA_PATH + "spj " + indatapath + " " + datapath + " " + runpath;
-            testinfo["Status"] = AC;  // 默认答案正确
-
-            if (system(m_command.data()) != 0) {  // 如果答案错误
-                m_result = WA;
-                testinfo["Status"] = WA;
+            SubprocessOptions options;
+            options.timeout = constants::judge::SPJ_TIMEOUT;
+            SubprocessResult spj = Subprocess::Run({m_spjpath, indatapath, datapath, runpath}, options);
+            // 退出码为 0 表示答案正确；SPJ 无法启动、超时或崩溃时不能据此判定用户答案，记为系统错误
+            if (!spj.Exited()) {
+                testinfo.status = SE;
+            } else {
+                testinfo.status = spj.Success() ? AC : WA;
             }
-        } else {                      // 普通判断
-            testinfo["Status"] = AC;  // 默认答案正确
-            // 比较答案（比较字符串）
-            if (strcmp(standardanswer.data(), calculateanswer.data()) != 0) {
-                testinfo["Status"] = WA;
-                m_result = WA;
+        } else {  // 普通判断
+            // 按题目的比较模式比较标准答案和用户输出
+            CompareResult cmp = {false, 1, 1};  // 标准答案不存在时视为不一致
+            if (m_testdata->hasoutput[i]) {
+                cmp = OutputComparator::Compare(standardanswer.Data(), standardanswer.Size(), calculateanswer.Data(),
+                                                calculateanswer.Size(), m_comparemode, m_compareepsilon);
             }
+            testinfo.status = cmp.equal ? AC : WA;
+            testinfo.mismatchline = cmp.line;
+            testinfo.mismatchcolumn = cmp.column;
         }
     } else if (res->result == 1) {  // CPU_TIME_LIMIT_EXCEEDED CPU 时间限制已超出
-        m_result = TLE;
-        testinfo["Status"] = TLE;
+        testinfo.status = TLE;
     } else if (res->result == 2) {  // REAL_TIME_LIMIT_EXCEEDED 真实时间限制已超出
-        m_result = TLE;
-        testinfo["Status"] = TLE;
+        testinfo.status = TLE;
     } else if (res->result == 3) {  // MEMORY_LIMIT_EXCEEDED 内存限制已超出
-        m_result = MLE;
-        testinfo["Status"] = MLE;
+        testinfo.status = MLE;
     } else if (res->result == 4) {  // RUNTIME_ERROR 运行时错误
-        // 获取失败原因
-        ifstream infile;
-        m_command = RUN_PATH + "error.out";
-        infile.open(m_command.data());
+        testinfo.status = RE;
+    } else {  // SYSTEM_ERROR 系统错误
+        testinfo.status = SE;
+    }
+    return testinfo;
+}
 
+// 获取运行时错误或系统错误的原因（只读取文件，可在多个槽位中并行调用）
+string Judger::GetCaseReason(int status, const string &index) {
+    if (status == RE) {
+        // 获取失败原因
+        ifstream infile(RUN_PATH + index + ".err");
         string reason((istreambuf_iterator<char>(infile)), (istreambuf_iterator<char>()));
-
-        m_reason = reason;
-        m_result = RE;
-        testinfo["Status"] = RE;
-        infile.close();
-    } else if (res->result == 5) {  // SYSTEM_ERROR 系统错误
+        return reason;
+    } else if (status == SE) {
         // 获取失败原因
-        ifstream infile;
-        m_command = RUN_PATH + "judger.log";
-        infile.open(m_command.data());
-
-        char reason[100];
+        ifstream infile(RUN_PATH + index + ".log");
+        char reason[100] = "";
         infile.getline(reason, 100);
+        return reason;
+    }
+    return "";
+}
+
+// 合并单个测试用例结果
+void Judger::MergeResult(CaseResult &caseresult, const string &reason) {
+    // 获取最大时间和空间
+    m_runtime = max(m_runtime, caseresult.runtime);
+    m_runmemory = max(m_runmemory, (long)caseresult.runmemory);
 
+    int status = caseresult.status;
+    if (status == RE || status == SE) {
         m_reason = reason;
-        m_result = SE;
-        testinfo["Status"] = SE;
-        infile.close();
     }
-    m_resjson["TestInfo"].append(testinfo);
+    if (status != AC) {
+        m_result = status;
+    }
+    m_judgeresult.testinfo.push_back(std::move(caseresult));
+}
+
+// 记录被跳过的测试用例
+void Judger::SkipResult() {
+    // 跳过的测试用例只有状态，运行时间、内存和输入输出均为空
+    CaseResult testinfo;
+    testinfo.status = SKIP;
+    m_judgeresult.testinfo.push_back(std::move(testinfo));
 }
 
 // 结束函数
-Json::Value Judger::Done() {
+JudgeResult Judger::Done() {
     if (m_result == PJ)
         m_result = AC;
 
-    m_resjson["StatusRecordId"] = m_statusrecordid;
-    m_resjson["Status"] = m_result;
-    m_resjson["CompilerInfo"] = m_reason;
-    m_resjson["RunTime"] = to_string(m_runtime) + "MS";
-    m_resjson["RunMemory"] = to_string(int(m_runmemory / 1024 / 1024)) + "MB";
-    m_resjson["Length"] = m_length;
-    // 删除中间文件夹
-    m_command = "rm -rf " + RUN_PATH;
-    system(m_command.data());
+    m_judgeresult.statusrecordid = m_statusrecordid;
+    m_judgeresult.status = m_result;
+    m_judgeresult.compilerinfo = std::move(m_reason);
+    m_judgeresult.runtime = m_runtime;
+    m_judgeresult.runmemory = m_runmemory;
+    m_judgeresult.length = m_length;
+    m_judgeresult.trace = m_trace.GetRecordStages();
+    m_judgeresult.tracecases = m_trace.GetRecordCases();
+    // 清空并归还评测工作区
+    WorkspacePool::GetInstance()->Release(m_workspace);
+    m_workspace = -1;
+    // 释放测试数据，缓存失效或被淘汰后映射随之解除
+    m_testdata.reset();
 
     // 返回结果
-    return m_resjson;
+    return std::move(m_judgeresult);
+}
+
+// 获取判题阶段耗时
+JudgeTrace &Judger::GetTrace() {
+    return m_trace;
 }
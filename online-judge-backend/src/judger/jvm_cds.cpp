@@ -0,0 +1,184 @@
+#include "judger/jvm_cds.h"
+
+#include <chrono>
+#include <filesystem>
+#include <fstream>
+#include <thread>
+
+#include "constants/judge.h"
+#include "judger/compile_cache.h"
+#include "judger/subprocess.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// Java 运行时的固定启动参数（生成归档和运行时必须一致，否则归档不会被使用）
+// - 串行 GC，不启动并行 GC 线程
+// - 只报告一个处理器，JIT 编译线程和 GC 线程数随之减少（这些线程的 CPU 时间同样计入用户）
+// - 不写 hsperfdata 文件
+// 保留默认的分层编译（C1 + C2），只使用 C1 会拖慢运行时间较长的程序
+static const vector<string> JAVA_PROFILE = {"-XX:+UseSerialGC", "-XX:ActiveProcessorCount=1", "-XX:-UsePerfData"};
+
+// 预热程序：覆盖判题程序中常见的输入输出、集合、字符串格式化和 lambda 用法
+static const char *WARMUP_SOURCE = R"(import java.io.*;
+import java.util.*;
+import java.util.stream.*;
+
+public class Warmup {
+    public static void main(String[] args) throws IOException {
+        Scanner sc = new Scanner("3 1 2\n4.5 hello\n");
+        int[] a = new int[3];
+        for (int i = 0; i < 3; i++) a[i] = sc.nextInt();
+        double d = sc.nextDouble();
+        String s = sc.next();
+        Arrays.sort(a);
+        BufferedReader br = new BufferedReader(new InputStreamReader(new ByteArrayInputStream("5 6\n".getBytes())));
+        StringTokenizer st = new StringTokenizer(br.readLine());
+        long x = Long.parseLong(st.nextToken()) + Integer.parseInt(st.nextToken());
+        List<Integer> list = new ArrayList<>();
+        for (int v : a) list.add(v);
+        Collections.sort(list, (p, q) -> q - p);
+        Map<String, Integer> map = new HashMap<>();
+        map.put(s, list.get(0));
+        TreeMap<Integer, Long> tree = new TreeMap<>();
+        tree.put(1, x);
+        Set<Integer> set = new HashSet<>(list);
+        PriorityQueue<Integer> pq = new PriorityQueue<>(list);
+        Deque<Integer> dq = new ArrayDeque<>(list);
+        LinkedList<Integer> ll = new LinkedList<>(dq);
+        String joined = list.stream().map(String::valueOf).collect(Collectors.joining(" "));
+        StringBuilder sb = new StringBuilder();
+        sb.append(String.format("%.2f %d %s", d, x, joined)).append(Math.max(pq.peek(), ll.size()));
+        sb.append(map.size() + tree.size() + set.size()).append('\n');
+        PrintWriter out = new PrintWriter(new BufferedWriter(new OutputStreamWriter(System.out)));
+        out.print(sb.length() > 0 ? "" : sb.toString());
+        out.flush();
+        System.out.print("");
+    }
+}
+)";
+
+// 执行命令（不经过 shell，丢弃输出），成功时返回 true
+static bool Execute(const vector<string> &argv) {
+    SubprocessOptions options;
+    options.maxcapture = 0;
+    options.timeout = constants::judge::PCH_BUILD_TIMEOUT;
+    return Subprocess::Run(argv, options).Success();
+}
+
+// 从类列表中去掉预热程序自身的类，只保留 JDK 的类
+static bool FilterClassList(const string &classlist, const string &jdklist) {
+    ifstream in(classlist);
+    ofstream out(jdklist);
+    if (!in || !out) {
+        return false;
+    }
+    string line;
+    while (getline(in, line)) {
+        if (line.find("Warmup") == string::npos) {
+            out << line << "\n";
+        }
+    }
+    return (bool)out;
+}
+
+// 局部静态特性的方式实现单实例模式
+JvmCds *JvmCds::GetInstance() {
+    static JvmCds jvm_cds;
+    return &jvm_cds;
+}
+
+// 在后台开始生成归档
+void JvmCds::Prepare() {
+    lock_guard<mutex> lock(state_mutex);
+    if (state != State::IDLE) {
+        return;
+    }
+    state = State::BUILDING;
+    thread(&JvmCds::Build, this).detach();
+}
+
+// 生成归档
+void JvmCds::Build() {
+    auto start = chrono::steady_clock::now();
+    string profile;
+    for (auto &arg : JAVA_PROFILE) {
+        profile += arg + " ";
+    }
+    string key = CompileCache::GetInstance()->GetKey("JVM-CDS", "/usr/bin/java -version", profile, WARMUP_SOURCE);
+    string finalpath = constants::judge::JVM_CDS_PATH + key;
+    string tmppath = constants::judge::JVM_CDS_PATH + string(".tmp.") + key;
+
+    error_code ec;
+    bool success = fs::exists(finalpath + "/jdk.jsa", ec);
+    if (!success) {
+        fs::remove_all(tmppath, ec);
+        fs::create_directories(tmppath, ec);
+        ofstream out(tmppath + "/Warmup.java");
+        out << WARMUP_SOURCE;
+        out.close();
+
+        // 运行预热程序记录加载的类，只保留 JDK 的类（归档中不包含应用类，运行时不受 -cp 的影响）
+        string classlist = tmppath + "/classes.lst";
+        string jdklist = tmppath + "/jdk.lst";
+        vector<string> trace = {"/usr/bin/java"};
+        trace.insert(trace.end(), JAVA_PROFILE.begin(), JAVA_PROFILE.end());
+        vector<string> dump = trace;
+        trace.insert(trace.end(), {"-Xshare:off", "-XX:DumpLoadedClassList=" + classlist, "-cp", tmppath, "Warmup"});
+        dump.insert(dump.end(), {"-Xshare:dump", "-XX:SharedClassListFile=" + jdklist,
+                                 "-XX:SharedArchiveFile=" + tmppath + "/jdk.jsa"});
+        success = Execute({"javac", "-d", tmppath, tmppath + "/Warmup.java"}) && Execute(trace) &&
+                  FilterClassList(classlist, jdklist) && Execute(dump);
+        if (success) {
+            success = rename(tmppath.data(), finalpath.data()) == 0 || fs::exists(finalpath + "/jdk.jsa", ec);
+        }
+        fs::remove_all(tmppath, ec);
+    }
+
+    lock_guard<mutex> lock(state_mutex);
+    build_us = chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count();
+    if (success) {
+        archive_path = fs::absolute(finalpath + "/jdk.jsa", ec).string();
+        state = State::READY;
+    } else {
+        state = State::FAILED;
+    }
+}
+
+// 获取 Java 运行时的固定启动参数
+vector<string> JvmCds::GetLaunchArgs() {
+    vector<string> args = JAVA_PROFILE;
+    lock_guard<mutex> lock(state_mutex);
+    if (state == State::READY) {
+        // 归档与当前 JVM 不匹配时 -Xshare:auto 会静默地不使用归档
+        args.push_back("-Xshare:auto");
+        args.push_back("-XX:SharedArchiveFile=" + archive_path);
+        hit_num++;
+    } else {
+        miss_num++;
+    }
+    return args;
+}
+
+// 获取 CDS 归档的运行状态
+Json::Value JvmCds::GetStats() {
+    Json::Value resjson;
+    lock_guard<mutex> lock(state_mutex);
+    const char *names[] = {"Idle", "Building", "Ready", "Failed"};
+    resjson["State"] = names[(int)state];
+    resjson["ArchivePath"] = archive_path;
+    resjson["BuildUs"] = (Json::Int64)build_us;
+    resjson["HitNum"] = (Json::Int64)hit_num.load();
+    resjson["MissNum"] = (Json::Int64)miss_num.load();
+    return resjson;
+}
+
+JvmCds::JvmCds() : state(State::IDLE), build_us(0), hit_num(0), miss_num(0) {
+    // 构造函数实现
+    error_code ec;
+    fs::create_directories(constants::judge::JVM_CDS_PATH, ec);
+}
+
+JvmCds::~JvmCds() {
+    // 析构函数实现
+}
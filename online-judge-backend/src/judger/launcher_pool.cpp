@@ -0,0 +1,162 @@
+#include "judger/launcher_pool.h"
+
+#include <signal.h>
+#include <spawn.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <climits>
+
+#include "constants/judge.h"
+#include "judger/cgroup_pool.h"
+#include "judger/launcher_protocol.hpp"
+
+using namespace std;
+
+extern char **environ;
+
+// 局部静态特性的方式实现单实例模式
+LauncherPool *LauncherPool::GetInstance() {
+    static LauncherPool launcher_pool;
+    return &launcher_pool;
+}
+
+// 启动单个启动器
+bool LauncherPool::Spawn(Launcher &launcher) {
+    if (launcher_path.empty()) {
+        return false;
+    }
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+        return false;
+    }
+    // 启动器固定从描述符 3 读取请求（dup2 会清除 close-on-exec 标志）
+    posix_spawn_file_actions_t actions;
+    posix_spawn_file_actions_init(&actions);
+    posix_spawn_file_actions_adddup2(&actions, fds[1], 3);
+    char *argv[] = {(char *)launcher_path.data(), nullptr};
+    pid_t pid;
+    int ret = posix_spawn(&pid, launcher_path.data(), &actions, nullptr, argv, environ);
+    posix_spawn_file_actions_destroy(&actions);
+    close(fds[1]);
+    if (ret != 0) {
+        close(fds[0]);
+        return false;
+    }
+    launcher.pid = pid;
+    launcher.fd = fds[0];
+    spawn_num++;
+    return true;
+}
+
+// 停止单个启动器
+void LauncherPool::Stop(Launcher &launcher) {
+    if (launcher.pid <= 0) {
+        return;
+    }
+    // 关闭套接字后启动器读到文件结束即退出
+    close(launcher.fd);
+    kill(launcher.pid, SIGKILL);
+    waitpid(launcher.pid, nullptr, 0);
+    launcher.pid = -1;
+    launcher.fd = -1;
+}
+
+// 签出一个启动器
+int LauncherPool::Acquire() {
+    lock_guard<mutex> lock(pool_mutex);
+    if (free_launchers.empty()) {
+        return -1;
+    }
+    int id = free_launchers.back();
+    free_launchers.pop_back();
+    return id;
+}
+
+// 归还启动器
+void LauncherPool::Release(int id) {
+    if (id < 0) {
+        return;
+    }
+    lock_guard<mutex> lock(pool_mutex);
+    free_launchers.push_back(id);
+}
+
+// 由启动器运行沙箱
+bool LauncherPool::Run(int id, int cpu, const cgroup_sandbox::SandboxCgroup &cgroup, const struct config *conf,
+                       struct result *res) {
+    if (id < 0) {
+        fallback_num++;
+        return false;
+    }
+    // 签出的启动器只由当前评测槽位使用，不需要加锁
+    Launcher &launcher = launchers[id];
+    if (launcher.pid <= 0 && !Spawn(launcher)) {
+        fallback_num++;
+        return false;
+    }
+    string request = launcher_protocol::EncodeRequest(cpu, cgroup, *conf);
+    uint32_t len = request.size();
+    launcher_protocol::Response response;
+    if (!launcher_protocol::WriteAll(launcher.fd, &len, sizeof(len)) ||
+        !launcher_protocol::WriteAll(launcher.fd, request.data(), len) ||
+        !launcher_protocol::ReadAll(launcher.fd, &response, sizeof(response))) {
+        // 启动器异常退出，下次使用时重新启动
+        Stop(launcher);
+        crash_num++;
+        fallback_num++;
+        return false;
+    }
+    *res = response.res;
+    if (!cgroup.slot.empty()) {
+        CgroupPool::GetInstance()->Record(response.accounted, response.oomkilled);
+    }
+    run_num++;
+    return true;
+}
+
+// 获取启动器池的运行状态
+Json::Value LauncherPool::GetStats() {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        resjson["LauncherNum"] = (Json::UInt64)launchers.size();
+        resjson["FreeNum"] = (Json::UInt64)free_launchers.size();
+    }
+    resjson["RunNum"] = (Json::Int64)run_num.load();
+    resjson["FallbackNum"] = (Json::Int64)fallback_num.load();
+    resjson["SpawnNum"] = (Json::Int64)spawn_num.load();
+    resjson["CrashNum"] = (Json::Int64)crash_num.load();
+    return resjson;
+}
+
+LauncherPool::LauncherPool() : run_num(0), fallback_num(0), spawn_num(0), crash_num(0) {
+    // 构造函数实现
+    // 启动器与后端可执行文件位于同一目录
+    char exepath[PATH_MAX];
+    ssize_t len = readlink("/proc/self/exe", exepath, sizeof(exepath) - 1);
+    if (len > 0) {
+        string dir(exepath, len);
+        string path = dir.substr(0, dir.rfind('/') + 1) + constants::judge::LAUNCHER_NAME;
+        if (access(path.data(), X_OK) == 0) {
+            launcher_path = path;
+        }
+    }
+    // 启动器不可用时不签出，判题机直接在本进程内调用 run()
+    if (launcher_path.empty()) {
+        return;
+    }
+    launchers.resize(constants::judge::LAUNCHER_COUNT, {-1, -1});
+    for (int i = 0; i < constants::judge::LAUNCHER_COUNT; i++) {
+        Spawn(launchers[i]);
+        free_launchers.push_back(i);
+    }
+}
+
+LauncherPool::~LauncherPool() {
+    // 析构函数实现
+    for (auto &launcher : launchers) {
+        Stop(launcher);
+    }
+}
@@ -0,0 +1,359 @@
+#include "judger/output_comparator.h"
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <string_view>
+#include <unordered_map>
+
+#include "constants/judge.h"
+
+using namespace std;
+
+// 每次 memcmp 比较的块大小
+static const size_t COMPARE_CHUNK_SIZE = 64 * 1024;
+
+MappedFile::~MappedFile() {
+    if (size_ > 0) {
+        munmap((void *)data_, size_);
+    }
+}
+
+// 映射文件
+bool MappedFile::Open(const string &path, bool populate) {
+    if (size_ > 0) {
+        munmap((void *)data_, size_);
+    }
+    data_ = "";
+    size_ = 0;
+
+    int fd = open(path.data(), O_RDONLY | O_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    struct stat st;
+    if (fstat(fd, &st) != 0) {
+        close(fd);
+        return false;
+    }
+    if (st.st_size == 0) {
+        close(fd);
+        return true;
+    }
+    void *addr = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE | (populate ? MAP_POPULATE : 0), fd, 0);
+    close(fd);
+    if (addr == MAP_FAILED) {
+        return false;
+    }
+    madvise(addr, st.st_size, MADV_SEQUENTIAL);
+    data_ = (const char *)addr;
+    size_ = st.st_size;
+    return true;
+}
+
+// 将映射的页面锁定在内存中
+bool MappedFile::Lock() {
+    return size_ == 0 || mlock(data_, size_) == 0;
+}
+
+static inline bool IsBlank(char c) {
+    return c == ' ' || c == '\t' || c == '\n' || c == '\r' || c == '\v' || c == '\f';
+}
+
+// 求两段内存的公共前缀长度：按块 memcmp，出现差异的块再二分缩小范围
+static size_t CommonPrefix(const char *a, const char *b, size_t n) {
+    size_t off = 0;
+    while (off < n) {
+        size_t len = min(COMPARE_CHUNK_SIZE, n - off);
+        if (memcmp(a + off, b + off, len) == 0) {
+            off += len;
+            continue;
+        }
+        size_t lo = off, hi = off + len;
+        while (hi - lo > 64) {
+            size_t mid = lo + (hi - lo) / 2;
+            if (memcmp(a + lo, b + lo, mid - lo) == 0) {
+                lo = mid;
+            } else {
+                hi = mid;
+            }
+        }
+        while (a[lo] == b[lo]) {
+            lo++;
+        }
+        return lo;
+    }
+    return n;
+}
+
+// 计算 pos 在 data 中的行号和列号（从 1 开始）
+static CompareResult Locate(const char *data, size_t pos) {
+    CompareResult res;
+    res.equal = false;
+    // 用 memchr 逐个查找换行符，比逐字节计数快得多
+    res.line = 1;
+    for (const char *p = data, *end = data + pos; (p = (const char *)memchr(p, '\n', end - p)) != nullptr; p++) {
+        res.line++;
+    }
+    size_t linestart = pos;
+    while (linestart > 0 && data[linestart - 1] != '\n') {
+        linestart--;
+    }
+    res.column = pos - linestart + 1;
+    return res;
+}
+
+// 按行比较，返回用户输出中第一个不一致的位置，一致时返回 npos
+static size_t CompareLines(const char *a, size_t alen, const char *b, size_t blen, size_t start, bool trimleading) {
+    size_t ia = start, ib = start;
+    while (ia < alen || ib < blen) {
+        // 取出当前行（不含换行符），一方已经结束时视为空行
+        const char *ea = ia < alen ? (const char *)memchr(a + ia, '\n', alen - ia) : nullptr;
+        const char *eb = ib < blen ? (const char *)memchr(b + ib, '\n', blen - ib) : nullptr;
+        size_t la = ia < alen ? (ea ? ea - a : alen) : ia;
+        size_t lb = ib < blen ? (eb ? eb - b : blen) : ib;
+
+        size_t sa = min(ia, la), sb = min(ib, lb);
+        size_t ta = la, tb = lb;
+        while (ta > sa && IsBlank(a[ta - 1])) {
+            ta--;
+        }
+        while (tb > sb && IsBlank(b[tb - 1])) {
+            tb--;
+        }
+        if (trimleading) {
+            while (sa < ta && IsBlank(a[sa])) {
+                sa++;
+            }
+            while (sb < tb && IsBlank(b[sb])) {
+                sb++;
+            }
+        }
+
+        size_t na = ta - sa, nb = tb - sb;
+        size_t same = CommonPrefix(a + sa, b + sb, min(na, nb));
+        if (same < na || same < nb) {
+            return sb + same;
+        }
+        ia = la + 1;
+        ib = lb + 1;
+    }
+    return string::npos;
+}
+
+static inline bool CaselessEqual(const char *a, size_t na, const char *b, size_t nb) {
+    if (na != nb) {
+        return false;
+    }
+    for (size_t i = 0; i < na; i++) {
+        if (tolower((unsigned char)a[i]) != tolower((unsigned char)b[i])) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 将单词解析为浮点数，整个单词都是数字时返回 true
+static bool ParseNumber(const char *token, size_t len, double &value) {
+    char buf[128];
+    if (len == 0 || len >= sizeof(buf)) {
+        return false;
+    }
+    memcpy(buf, token, len);
+    buf[len] = '\0';
+    char *end = nullptr;
+    value = strtod(buf, &end);
+    return end == buf + len && std::isfinite(value);
+}
+
+// 按比较模式判断两个逐字节不同的单词是否等价
+static bool TokenEqual(const char *a, size_t na, const char *b, size_t nb, CompareMode mode, double epsilon) {
+    if (mode == CompareMode::TOKEN_CASELESS) {
+        return CaselessEqual(a, na, b, nb);
+    } else if (mode == CompareMode::YES_NO) {
+        return (CaselessEqual(b, nb, "yes", 3) || CaselessEqual(b, nb, "no", 2)) && CaselessEqual(a, na, b, nb);
+    } else if (mode == CompareMode::FLOAT) {
+        // 满足绝对误差或相对误差之一即可
+        double x, y;
+        if (!ParseNumber(a, na, x) || !ParseNumber(b, nb, y)) {
+            return false;
+        }
+        double diff = fabs(x - y);
+        return diff <= epsilon || diff <= epsilon * fabs(x);
+    }
+    return false;
+}
+
+// 按单词比较，返回用户输出中第一个不一致的位置，一致时返回 npos
+static size_t CompareTokens(const char *a, size_t alen, const char *b, size_t blen, size_t start, CompareMode mode,
+                            double epsilon) {
+    size_t ia = start, ib = start;
+    while (true) {
+        while (ia < alen && IsBlank(a[ia])) {
+            ia++;
+        }
+        while (ib < blen && IsBlank(b[ib])) {
+            ib++;
+        }
+        if (ia >= alen || ib >= blen) {
+            return (ia >= alen && ib >= blen) ? string::npos : ib;
+        }
+        size_t ea = ia, eb = ib;
+        while (ea < alen && !IsBlank(a[ea])) {
+            ea++;
+        }
+        while (eb < blen && !IsBlank(b[eb])) {
+            eb++;
+        }
+        size_t na = ea - ia, nb = eb - ib;
+        size_t same = CommonPrefix(a + ia, b + ib, min(na, nb));
+        if (same < na || same < nb) {
+            if (mode == CompareMode::TOKEN) {
+                return ib + same;
+            }
+            if (!TokenEqual(a + ia, na, b + ib, nb, mode, epsilon)) {
+                return ib;
+            }
+        }
+        ia = ea;
+        ib = eb;
+    }
+}
+
+// 忽略行的顺序比较，返回用户输出中第一个多余的行的位置，缺少行时返回用户输出的末尾，一致时返回 npos
+static size_t CompareUnorderedLines(const char *a, size_t alen, const char *b, size_t blen) {
+    // 依次取出每行（去掉行末空白字符），跳过空行
+    auto nextline = [](const char *data, size_t len, size_t &pos, size_t &linestart) -> string_view {
+        while (pos < len) {
+            linestart = pos;
+            const char *end = (const char *)memchr(data + pos, '\n', len - pos);
+            size_t lineend = end ? end - data : len;
+            pos = lineend + 1;
+            while (lineend > linestart && IsBlank(data[lineend - 1])) {
+                lineend--;
+            }
+            if (lineend > linestart) {
+                return string_view(data + linestart, lineend - linestart);
+            }
+        }
+        return string_view();
+    };
+
+    unordered_map<string_view, long long> remain;
+    long long remainnum = 0;
+    size_t pos = 0, linestart = 0;
+    for (string_view line = nextline(a, alen, pos, linestart); !line.empty();
+         line = nextline(a, alen, pos, linestart)) {
+        remain[line]++;
+        remainnum++;
+    }
+    pos = 0;
+    for (string_view line = nextline(b, blen, pos, linestart); !line.empty();
+         line = nextline(b, blen, pos, linestart)) {
+        auto iter = remain.find(line);
+        if (iter == remain.end() || iter->second == 0) {
+            return linestart;
+        }
+        iter->second--;
+        remainnum--;
+    }
+    return remainnum > 0 ? blen : string::npos;
+}
+
+// 将比较模式名称转换为比较模式
+CompareMode OutputComparator::ParseMode(const string &name) {
+    if (name == constants::judge::COMPARE_MODE_EXACT) {
+        return CompareMode::EXACT;
+    } else if (name == constants::judge::COMPARE_MODE_LINE) {
+        return CompareMode::LINE;
+    } else if (name == constants::judge::COMPARE_MODE_TOKEN) {
+        return CompareMode::TOKEN;
+    } else if (name == constants::judge::COMPARE_MODE_TOKEN_CASELESS) {
+        return CompareMode::TOKEN_CASELESS;
+    } else if (name == constants::judge::COMPARE_MODE_FLOAT) {
+        return CompareMode::FLOAT;
+    } else if (name == constants::judge::COMPARE_MODE_UNORDERED_LINES) {
+        return CompareMode::UNORDERED_LINES;
+    } else if (name == constants::judge::COMPARE_MODE_YES_NO) {
+        return CompareMode::YES_NO;
+    }
+    return CompareMode::TRAILING;
+}
+
+// 获取比较模式的名称
+const char *OutputComparator::ModeName(CompareMode mode) {
+    switch (mode) {
+        case CompareMode::EXACT:
+            return constants::judge::COMPARE_MODE_EXACT;
+        case CompareMode::LINE:
+            return constants::judge::COMPARE_MODE_LINE;
+        case CompareMode::TOKEN:
+            return constants::judge::COMPARE_MODE_TOKEN;
+        case CompareMode::TOKEN_CASELESS:
+            return constants::judge::COMPARE_MODE_TOKEN_CASELESS;
+        case CompareMode::FLOAT:
+            return constants::judge::COMPARE_MODE_FLOAT;
+        case CompareMode::UNORDERED_LINES:
+            return constants::judge::COMPARE_MODE_UNORDERED_LINES;
+        case CompareMode::YES_NO:
+            return constants::judge::COMPARE_MODE_YES_NO;
+        default:
+            return constants::judge::COMPARE_MODE_TRAILING;
+    }
+}
+
+// 比较内存中的标准答案和用户输出
+CompareResult OutputComparator::Compare(const char *expected, size_t expectedlen, const char *actual, size_t actuallen,
+                                        CompareMode mode, double epsilon) {
+    // 快速路径：绝大多数正确的输出与标准答案逐字节相同
+    size_t prefix = CommonPrefix(expected, actual, min(expectedlen, actuallen));
+    if (prefix == expectedlen && prefix == actuallen) {
+        return {true, 0, 0};
+    }
+
+    size_t pos = string::npos;
+    if (mode == CompareMode::EXACT) {
+        pos = prefix;
+    } else if (mode == CompareMode::TOKEN || mode == CompareMode::TOKEN_CASELESS || mode == CompareMode::FLOAT ||
+               mode == CompareMode::YES_NO) {
+        // 从差异所在单词的开头继续比较（公共前缀内两边的内容相同）
+        size_t start = prefix;
+        while (start > 0 && !IsBlank(expected[start - 1])) {
+            start--;
+        }
+        pos = CompareTokens(expected, expectedlen, actual, actuallen, start, mode, epsilon);
+    } else if (mode == CompareMode::UNORDERED_LINES) {
+        pos = CompareUnorderedLines(expected, expectedlen, actual, actuallen);
+    } else {
+        // 从差异所在行的开头继续比较
+        size_t start = prefix;
+        while (start > 0 && expected[start - 1] != '\n') {
+            start--;
+        }
+        pos = CompareLines(expected, expectedlen, actual, actuallen, start, mode == CompareMode::LINE);
+    }
+    if (pos == string::npos) {
+        return {true, 0, 0};
+    }
+    return Locate(actual, min(pos, actuallen));
+}
+
+// 比较标准答案文件和用户输出文件
+CompareResult OutputComparator::CompareFiles(const string &expectedpath, const string &actualpath, CompareMode mode,
+                                             double epsilon) {
+    MappedFile expected, actual;
+    if (!expected.Open(expectedpath)) {
+        return {false, 1, 1};
+    }
+    if (!actual.Open(actualpath)) {
+        return Compare(expected.Data(), expected.Size(), "", 0, mode, epsilon);
+    }
+    return Compare(expected.Data(), expected.Size(), actual.Data(), actual.Size(), mode, epsilon);
+}
@@ -0,0 +1,237 @@
+#include "judger/pch_cache.h"
+
+#include <stdlib.h>
+#include <sys/stat.h>
+
+#include <filesystem>
+#include <fstream>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <vector>
+
+#include "constants/judge.h"
+#include "judger/compile_cache.h"
+#include "judger/subprocess.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// 常用 STL 头文件组合（提交只包含其中的头文件时使用）
+static const set<string> STL_HEADERS = {"algorithm", "bitset", "cassert", "cctype", "climits", "cmath", "cstdio",
+                                        "cstdlib", "cstring", "deque", "functional", "iomanip", "iostream", "list",
+                                        "map", "numeric", "queue", "set", "sstream", "stack", "string", "unordered_map",
+                                        "unordered_set", "utility", "vector"};
+
+// 解析源代码中的 #include，otherfirst 表示在最后一个 #include 之前出现了其他预处理指令（如 #define）
+static vector<string> ParseIncludes(const string &source, bool &otherfirst) {
+    vector<string> headers;
+    bool other = false;
+    otherfirst = false;
+    istringstream in(source);
+    string line;
+    while (getline(in, line)) {
+        size_t pos = line.find_first_not_of(" \t");
+        if (pos == string::npos || line[pos] != '#') {
+            continue;
+        }
+        pos = line.find_first_not_of(" \t", pos + 1);
+        if (pos == string::npos || line.compare(pos, 7, "include") != 0) {
+            other = true;
+            continue;
+        }
+        otherfirst = otherfirst || other;
+        pos = line.find_first_not_of(" \t", pos + 7);
+        if (pos == string::npos) {
+            continue;
+        }
+        char close = line[pos] == '<' ? '>' : '"';
+        size_t end = line.find(close, pos + 1);
+        if (end == string::npos) {
+            continue;
+        }
+        // 用引号包含的头文件不会出现在组合中，加上引号以便区分
+        string name = line.substr(pos + 1, end - pos - 1);
+        headers.push_back(close == '>' ? name : "\"" + name + "\"");
+    }
+    return headers;
+}
+
+// 在 PATH 中查找 g++ 的实际路径
+static string FindCompiler() {
+    const char *path = getenv("PATH");
+    istringstream in(path ? path : "/usr/bin");
+    string dir;
+    while (getline(in, dir, ':')) {
+        string candidate = dir + "/g++";
+        char *resolved = realpath(candidate.data(), nullptr);
+        if (resolved != nullptr) {
+            string result = resolved;
+            free(resolved);
+            return result;
+        }
+    }
+    return "";
+}
+
+// 局部静态特性的方式实现单实例模式
+PchCache *PchCache::GetInstance() {
+    static PchCache pch_cache;
+    return &pch_cache;
+}
+
+// 在后台线程中生成预编译头
+void PchCache::Build(const string &key, const string &header, const string &flags, bool bits) {
+    string tmppath = constants::judge::PCH_CACHE_PATH + string(".tmp.") + key;
+    string finalpath = constants::judge::PCH_CACHE_PATH + key;
+    error_code ec;
+    fs::remove_all(tmppath, ec);
+    string headerpath = bits ? tmppath + "/bits/stdc++.h" : tmppath + "/pch.h";
+    fs::create_directories(fs::path(headerpath).parent_path(), ec);
+    ofstream out(headerpath);
+    out << header;
+    out.close();
+
+    vector<string> command = {"g++"};
+    for (auto &flag : Subprocess::Split(flags)) {
+        command.push_back(flag);
+    }
+    command.insert(command.end(), {"-x", "c++-header", headerpath, "-o", headerpath + ".gch"});
+    SubprocessOptions options;
+    options.timeout = constants::judge::PCH_BUILD_TIMEOUT;
+    bool success = Subprocess::Run(command, options).Success();
+    if (success && bits) {
+        // 只保留 .gch，否则 -I 目录下的同名头文件会在预编译头失效时被当作 <bits/stdc++.h> 包含
+        success = fs::remove(headerpath, ec);
+    }
+    if (success) {
+        success = rename(tmppath.data(), finalpath.data()) == 0 || fs::exists(finalpath, ec);
+    }
+    fs::remove_all(tmppath, ec);
+
+    lock_guard<mutex> lock(state_mutex);
+    if (success) {
+        states[key] = State::READY;
+        build_num++;
+    } else {
+        states[key] = State::FAILED;
+        build_fail_num++;
+    }
+}
+
+// 根据提交的源代码选择可用的预编译头
+PchCache::Usage PchCache::Select(const string &flags, const string &source) {
+    bool otherfirst = false;
+    vector<string> headers = ParseIncludes(source, otherfirst);
+
+    bool bits = false, stl = !headers.empty() && !otherfirst;
+    for (auto &name : headers) {
+        bits = bits || name == "bits/stdc++.h";
+        stl = stl && STL_HEADERS.count(name) > 0;
+    }
+    if (!bits && !stl) {
+        return {{}, false};
+    }
+
+    string header;
+    if (bits) {
+        header = "#include <bits/stdc++.h>\n";
+    } else {
+        for (auto &name : STL_HEADERS) {
+            header += "#include <" + name + ">\n";
+        }
+    }
+    // 编译器的修改时间参与摘要，编译器升级后（即使进程未重启）也会重新生成
+    struct stat st;
+    string compilerstamp = compiler_path;
+    if (!compiler_path.empty() && stat(compiler_path.data(), &st) == 0) {
+        compilerstamp += "@" + to_string(st.st_mtime);
+    }
+    string key = CompileCache::GetInstance()->GetKey(bits ? "PCH:bits" : "PCH:stl", "g++ --version", flags,
+                                                     header + compilerstamp);
+
+    {
+        lock_guard<mutex> lock(state_mutex);
+        auto iter = states.find(key);
+        if (iter == states.end()) {
+            states[key] = State::BUILDING;
+            thread(&PchCache::Build, this, key, header, flags, bits).detach();
+            return {{}, false};
+        }
+        if (iter->second != State::READY) {
+            return {{}, false};
+        }
+    }
+
+    error_code ec;
+    string dir = fs::absolute(constants::judge::PCH_CACHE_PATH + key, ec).string();
+    if (bits) {
+        return {{"-I", dir}, false};
+    }
+    return {{"-include", dir + "/pch.h"}, true};
+}
+
+// 记录一次 C++ 编译的耗时
+void PchCache::Record(bool hit, bool fallback, long long us) {
+    if (hit) {
+        hit_num++;
+        hit_total_us += us;
+    } else {
+        miss_num++;
+        miss_total_us += us;
+    }
+    if (fallback) {
+        fallback_num++;
+    }
+}
+
+// 获取预编译头缓存的运行状态
+Json::Value PchCache::GetStats() {
+    Json::Value resjson;
+    int readynum = 0;
+    {
+        lock_guard<mutex> lock(state_mutex);
+        for (auto &item : states) {
+            readynum += item.second == State::READY;
+        }
+    }
+    long long hitnum = hit_num.load(), missnum = miss_num.load();
+    resjson["ReadyNum"] = readynum;
+    resjson["HitNum"] = (Json::Int64)hitnum;
+    resjson["MissNum"] = (Json::Int64)missnum;
+    resjson["FallbackNum"] = (Json::Int64)fallback_num.load();
+    resjson["BuildNum"] = (Json::Int64)build_num.load();
+    resjson["BuildFailNum"] = (Json::Int64)build_fail_num.load();
+    resjson["AvgCompileUsWithPch"] = (Json::Int64)(hitnum > 0 ? hit_total_us.load() / hitnum : 0);
+    resjson["AvgCompileUsWithoutPch"] = (Json::Int64)(missnum > 0 ? miss_total_us.load() / missnum : 0);
+    return resjson;
+}
+
+PchCache::PchCache()
+    : compiler_path(FindCompiler()),
+      hit_num(0),
+      miss_num(0),
+      fallback_num(0),
+      build_num(0),
+      build_fail_num(0),
+      hit_total_us(0),
+      miss_total_us(0) {
+    // 构造函数实现
+    // 恢复已经生成的预编译头，清理上次异常退出残留的临时目录
+    error_code ec;
+    fs::create_directories(constants::judge::PCH_CACHE_PATH, ec);
+    for (auto iter = fs::directory_iterator(constants::judge::PCH_CACHE_PATH, ec);
+         !ec && iter != fs::directory_iterator(); iter.increment(ec)) {
+        string name = iter->path().filename().string();
+        if (name.empty() || name[0] == '.') {
+            error_code rmec;
+            fs::remove_all(iter->path(), rmec);
+            continue;
+        }
+        states[name] = State::READY;
+    }
+}
+
+PchCache::~PchCache() {
+    // 析构函数实现
+}
@@ -0,0 +1,129 @@
+#include "judger/spj_cache.h"
+
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <filesystem>
+#include <fstream>
+
+#include "constants/judge.h"
+#include "judger/compile_cache.h"
+#include "judger/subprocess.h"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+// 局部静态特性的方式实现单实例模式
+SpjCache *SpjCache::GetInstance() {
+    static SpjCache spj_cache;
+    return &spj_cache;
+}
+
+// 编译题目的 SPJ 并更新符号链接
+bool SpjCache::Build(const string &problemid, string &compileinfo, const string &datapath) {
+    string dirpath = datapath.empty() ? constants::judge::PROBLEM_DATA_PREFIX + problemid + "/" : datapath;
+    string linkpath = dirpath + "spj";
+    string sourcepath = dirpath + "spj.cpp";
+
+    // 没有 SPJ 源文件时删除旧的 spj
+    ifstream infile(sourcepath);
+    if (!infile.is_open()) {
+        unlink(linkpath.data());
+        return true;
+    }
+    string source((istreambuf_iterator<char>(infile)), (istreambuf_iterator<char>()));
+    infile.close();
+
+    string flags = constants::judge::SPJ_COMPILE_FLAGS;
+    string key = CompileCache::GetInstance()->GetKey("SPJ", "g++ --version", flags, source);
+    string binpath = constants::judge::SPJ_CACHE_PATH + key;
+
+    lock_guard<mutex> lock(build_mutex);
+    if (access(binpath.data(), X_OK) == 0) {
+        reuse_num++;
+    } else {
+        // 编译到临时文件，成功后再 rename 为正式的版本文件
+        string tmppath = constants::judge::SPJ_CACHE_PATH + string(".tmp.") + key;
+        vector<string> command = {"g++", sourcepath, "-o", tmppath};
+        for (auto &flag : Subprocess::Split(flags)) {
+            command.push_back(flag);
+        }
+        SubprocessOptions options;
+        options.mergestdout = true;
+        options.timeout = constants::judge::COMPILE_TIMEOUT;
+        options.maxcapture = constants::judge::COMPILE_INFO_MAX_BYTES;
+        SubprocessResult res = Subprocess::Run(command, options);
+        compileinfo = res.output;
+        if (!res.started) {
+            fail_num++;
+            compileinfo = "无法启动编译器";
+            return false;
+        }
+        if (!res.Success() || rename(tmppath.data(), binpath.data())) {
+            unlink(tmppath.data());
+            fail_num++;
+            if (res.timedout) {
+                compileinfo += "\nSPJ 编译超时";
+            } else if (compileinfo.empty()) {
+                compileinfo = "SPJ 编译失败";
+            }
+            return false;
+        }
+        build_num++;
+    }
+
+    // 先创建临时符号链接再 rename 覆盖，正在判题的进程看到的总是旧版本或新版本之一
+    error_code ec;
+    string target = fs::relative(binpath, dirpath, ec).string();
+    if (ec || target.empty()) {
+        target = fs::absolute(binpath, ec).string();
+    }
+    string tmplink = dirpath + ".spj.tmp";
+    unlink(tmplink.data());
+    if (symlink(target.data(), tmplink.data()) != 0 || rename(tmplink.data(), linkpath.data()) != 0) {
+        unlink(tmplink.data());
+        fail_num++;
+        compileinfo = "无法更新 SPJ 链接";
+        return false;
+    }
+    return true;
+}
+
+// 获取题目当前版本的 SPJ 可执行文件
+string SpjCache::Resolve(const string &problemid, const string &datapath) {
+    string linkpath = (datapath.empty() ? constants::judge::PROBLEM_DATA_PREFIX + problemid + "/" : datapath) + "spj";
+    char *path = realpath(linkpath.data(), nullptr);
+    if (path == nullptr) {
+        return "";
+    }
+    string resolved = path;
+    free(path);
+    return resolved;
+}
+
+// 获取 SPJ 缓存的运行状态
+Json::Value SpjCache::GetStats() {
+    Json::Value resjson;
+    resjson["BuildNum"] = (Json::Int64)build_num.load();
+    resjson["ReuseNum"] = (Json::Int64)reuse_num.load();
+    resjson["FailNum"] = (Json::Int64)fail_num.load();
+    return resjson;
+}
+
+SpjCache::SpjCache() : build_num(0), reuse_num(0), fail_num(0) {
+    // 构造函数实现
+    error_code ec;
+    fs::create_directories(constants::judge::SPJ_CACHE_PATH, ec);
+    // 清理上次异常退出残留的临时文件
+    for (auto iter = fs::directory_iterator(constants::judge::SPJ_CACHE_PATH, ec);
+         !ec && iter != fs::directory_iterator(); iter.increment(ec)) {
+        if (iter->path().filename().string().rfind(".tmp.", 0) == 0) {
+            error_code rmec;
+            fs::remove(iter->path(), rmec);
+        }
+    }
+}
+
+SpjCache::~SpjCache() {
+    // 析构函数实现
+}
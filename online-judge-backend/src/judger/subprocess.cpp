@@ -0,0 +1,208 @@
+#include "judger/subprocess.h"
+
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <sstream>
+#include <thread>
+
+using namespace std;
+
+extern char **environ;
+
+// 是否正常退出且退出码为 0
+bool SubprocessResult::Success() const { return Exited() && WEXITSTATUS(status) == 0; }
+
+// 是否正常退出
+bool SubprocessResult::Exited() const { return started && !timedout && WIFEXITED(status); }
+
+// 在 PATH 中查找可执行文件（在 vfork 之前完成，子进程中不再分配内存）
+static string FindProgram(const string &name) {
+    if (name.find('/') != string::npos) {
+        return name;
+    }
+    const char *env = getenv("PATH");
+    string paths = env != nullptr ? env : "/usr/local/bin:/usr/bin:/bin";
+    size_t start = 0;
+    while (start <= paths.size()) {
+        size_t end = paths.find(':', start);
+        if (end == string::npos) {
+            end = paths.size();
+        }
+        string dir = paths.substr(start, end - start);
+        string candidate = (dir.empty() ? "." : dir) + "/" + name;
+        if (access(candidate.data(), X_OK) == 0) {
+            return candidate;
+        }
+        start = end + 1;
+    }
+    return "";
+}
+
+// 设置资源限制（value 为负数时不设置，只调用异步信号安全的函数）
+static void SetLimit(int resource, long long value) {
+    if (value < 0) {
+        return;
+    }
+    struct rlimit limit;
+    limit.rlim_cur = limit.rlim_max = (rlim_t)value;
+    setrlimit(resource, &limit);
+}
+
+// 运行子进程并等待其结束
+SubprocessResult Subprocess::Run(const vector<string> &argv, const SubprocessOptions &options) {
+    SubprocessResult result;
+    string program = argv.empty() ? "" : FindProgram(argv[0]);
+    if (program.empty()) {
+        return result;
+    }
+    vector<char *> args;
+    for (auto &arg : argv) {
+        args.push_back((char *)arg.data());
+    }
+    args.push_back(nullptr);
+    const char *workdir = options.workdir.empty() ? nullptr : options.workdir.data();
+
+    // 描述符都带有 close-on-exec 标志，子进程中只保留 dup2 到 0、1、2 的副本
+    int pipefd[2];
+    if (pipe2(pipefd, O_CLOEXEC) != 0) {
+        return result;
+    }
+    string inpath = options.stdinpath.empty() ? "/dev/null" : options.stdinpath;
+    string outpath = options.stdoutpath.empty() ? "/dev/null" : options.stdoutpath;
+    int infd = open(inpath.data(), O_RDONLY | O_CLOEXEC);
+    int outfd = options.mergestdout ? pipefd[1] : open(outpath.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    auto closeall = [&]() {
+        for (int fd : {infd, pipefd[0], pipefd[1]}) {
+            if (fd >= 0) {
+                close(fd);
+            }
+        }
+        if (outfd >= 0 && !options.mergestdout) {
+            close(outfd);
+        }
+    };
+    if (infd < 0 || outfd < 0) {
+        closeall();
+        return result;
+    }
+
+    // vfork 的子进程与父进程共享内存，期间屏蔽信号，避免父进程的信号处理函数在子进程中运行
+    sigset_t allsignals, oldmask;
+    sigfillset(&allsignals);
+    pthread_sigmask(SIG_SETMASK, &allsignals, &oldmask);
+    volatile int execerrno = 0;
+    pid_t pid = vfork();
+    if (pid == 0) {
+        // 子进程使用独立的进程组，超时时连同编译器派生的进程一起杀死
+        setpgid(0, 0);
+        if (dup2(infd, 0) < 0 || dup2(outfd, 1) < 0 || dup2(pipefd[1], 2) < 0 ||
+            (workdir != nullptr && chdir(workdir) != 0)) {
+            execerrno = errno != 0 ? errno : EINVAL;
+            _exit(127);
+        }
+        SetLimit(RLIMIT_CPU, options.cpulimit);
+        SetLimit(RLIMIT_AS, options.memorylimit);
+        SetLimit(RLIMIT_FSIZE, options.outputlimit);
+        pthread_sigmask(SIG_SETMASK, &oldmask, nullptr);
+        execve(program.data(), args.data(), environ);
+        execerrno = errno;
+        _exit(127);
+    }
+    pthread_sigmask(SIG_SETMASK, &oldmask, nullptr);
+    int readfd = pipefd[0];
+    pipefd[0] = -1;
+    closeall();
+    if (pid < 0) {
+        close(readfd);
+        return result;
+    }
+    if (execerrno != 0) {
+        waitpid(pid, nullptr, 0);
+        close(readfd);
+        return result;
+    }
+    result.started = true;
+
+    // 读取输出直到所有写端关闭，超时后杀死整个进程组
+    auto deadline = chrono::steady_clock::now() + chrono::milliseconds(max(options.timeout, 0));
+    auto remaining = [&]() {
+        if (options.timeout < 0 || result.timedout) {
+            return -1;
+        }
+        auto left = chrono::duration_cast<chrono::milliseconds>(deadline - chrono::steady_clock::now()).count();
+        return left > 0 ? (int)left : 0;
+    };
+    auto killgroup = [&]() {
+        kill(-pid, SIGKILL);
+        result.timedout = true;
+    };
+    char buf[4096];
+    while (true) {
+        struct pollfd pfd = {readfd, POLLIN, 0};
+        int ready = poll(&pfd, 1, remaining());
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready == 0) {
+            killgroup();
+            continue;
+        }
+        ssize_t len = read(readfd, buf, sizeof(buf));
+        if (len < 0 && errno == EINTR) {
+            continue;
+        }
+        if (len <= 0) {
+            break;
+        }
+        size_t keep = min((size_t)len, options.maxcapture - min(options.maxcapture, result.output.size()));
+        result.output.append(buf, keep);
+        result.truncated = result.truncated || keep < (size_t)len;
+    }
+    close(readfd);
+
+    // 子进程可能在关闭标准错误之后继续运行，同样受超时限制
+    int sleepus = 100;
+    while (true) {
+        int timeout = remaining();
+        pid_t ret = waitpid(pid, &result.status, timeout < 0 ? 0 : WNOHANG);
+        if (ret == pid || (ret < 0 && errno != EINTR)) {
+            break;
+        }
+        if (ret == 0 && timeout == 0) {
+            killgroup();
+        } else if (ret == 0) {
+            this_thread::sleep_for(chrono::microseconds(sleepus));
+            sleepus = min(sleepus * 2, 10000);
+        }
+    }
+    return result;
+}
+
+// 按空白字符拆分编译选项
+vector<string> Subprocess::Split(const string &flags) {
+    vector<string> args;
+    istringstream in(flags);
+    string arg;
+    while (in >> arg) {
+        args.push_back(arg);
+    }
+    return args;
+}
+
+// 将参数数组拼接为便于阅读的命令
+string Subprocess::Join(const vector<string> &argv) {
+    string command;
+    for (auto &arg : argv) {
+        command += (command.empty() ? "" : " ") + arg;
+    }
+    return command;
+}
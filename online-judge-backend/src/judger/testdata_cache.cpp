@@ -0,0 +1,319 @@
+#include "judger/testdata_cache.h"
+
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <filesystem>
+
+#include "constants/judge.h"
+#include "judger/testdata_pack.h"
+#include "judger/testdata_store.h"
+#include "utils/sha256.hpp"
+
+using namespace std;
+
+TestDataExtraction::~TestDataExtraction() {
+    // 析构函数实现
+    // 最后一个使用者已释放，映射已解除
+    error_code ec;
+    filesystem::remove_all(casepath, ec);
+}
+
+TestData::~TestData() {
+    // 析构函数实现
+    // 先解除映射，再释放导出目录
+    inputs.clear();
+    outputs.clear();
+    extraction.reset();
+    if (acquired) {
+        TestDataStore::GetInstance()->ReleaseVersion(datapath);
+    }
+}
+
+// 局部静态特性的方式实现单实例模式
+TestDataCache *TestDataCache::GetInstance() {
+    static TestDataCache testdata_cache;
+    return &testdata_cache;
+}
+
+// 获取数据目录的版本
+long long TestDataCache::GetPathVersion(const string &datapath) {
+    struct stat st;
+    if (stat(datapath.data(), &st) != 0) {
+        return -1;
+    }
+    return st.st_mtim.tv_sec * 1000000000LL + st.st_mtim.tv_nsec;
+}
+
+// 获取题目数据的版本
+long long TestDataCache::GetVersion(const string &problemid) {
+    string datapath;
+    if (!TestDataStore::Resolve(problemid, datapath)) {
+        return -1;
+    }
+    return GetPathVersion(datapath);
+}
+
+// 移除保留的导出目录
+void TestDataCache::DropExtraction(const string &problemid) {
+    auto iter = extractions.find(problemid);
+    if (iter == extractions.end()) {
+        return;
+    }
+    extract_bytes -= iter->second.extraction->bytes;
+    extract_lru.erase(iter->second.iter);
+    extractions.erase(iter);
+}
+
+// 获取数据版本的导出目录
+shared_ptr<TestDataExtraction> TestDataCache::Extract(const string &problemid, const string &datapath,
+                                                      const TestDataPack &pack) {
+    shared_ptr<TestDataExtraction> extraction;
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        auto iter = extractions.find(problemid);
+        if (iter != extractions.end() && iter->second.extraction->datapath == datapath) {
+            extract_lru.splice(extract_lru.begin(), extract_lru, iter->second.iter);
+            extraction = iter->second.extraction;
+        } else {
+            // 每个题目只保留最近的数据版本，旧版本的导出目录在使用者释放后删除
+            DropExtraction(problemid);
+            string dirname = datapath.substr(0, datapath.size() - 1);
+            dirname = dirname.substr(dirname.rfind('/') + 1);
+            extraction = make_shared<TestDataExtraction>();
+            extraction->datapath = datapath;
+            extraction->casepath =
+                constants::judge::TESTDATA_EXTRACT_PATH + dirname + "." + to_string(extract_seq++) + "/";
+            extraction->bytes = 0;
+            extraction->done = false;
+            extraction->ok = false;
+            extract_lru.push_front(problemid);
+            extractions[problemid] = {extraction, extract_lru.begin()};
+        }
+    }
+
+    // 同一版本的其他加载在这里等待第一个加载导出完成
+    lock_guard<mutex> lock(extraction->mutex);
+    if (extraction->done) {
+        extract_hit_num++;
+        return extraction;
+    }
+    error_code ec;
+    filesystem::remove_all(extraction->casepath, ec);
+    bool ok = filesystem::create_directories(extraction->casepath, ec);
+    for (const PackEntry *entry : pack.Entries()) {
+        if (!ok) {
+            break;
+        }
+        // 写入失败（如内存文件系统空间不足）时文件可能被截断，整个导出目录作废
+        ok = pack.Extract(entry->name, extraction->casepath + entry->name);
+        extraction->bytes += entry->rawsize;
+    }
+    extraction->done = true;
+    extraction->ok = ok;
+    if (ok) {
+        extract_num++;
+    } else {
+        extract_fail_num++;
+    }
+
+    lock_guard<mutex> cachelock(cache_mutex);
+    auto iter = extractions.find(problemid);
+    if (iter == extractions.end() || iter->second.extraction != extraction) {
+        // 导出期间已被新版本替换或主动失效
+        return extraction;
+    }
+    if (!ok) {
+        // 不保留失败的导出，下一次加载重新导出
+        DropExtraction(problemid);
+        return extraction;
+    }
+    extract_bytes += extraction->bytes;
+    while (extract_bytes > constants::judge::TESTDATA_EXTRACT_MAX_BYTES && extract_lru.size() > 1) {
+        DropExtraction(extract_lru.back());
+    }
+    return extraction;
+}
+
+// 从磁盘加载一个题目的测试数据
+shared_ptr<const TestData> TestDataCache::Load(const string &problemid, const string &datapath, int judgenum,
+                                               long long version, bool acquired) {
+    auto data = make_shared<TestData>();
+    data->version = version;
+    data->datapath = datapath;
+    data->casepath = datapath;
+    data->acquired = acquired;
+    data->complete = true;
+    data->bytes = 0;
+    data->locked = true;
+
+    // 版本目录的清单在提交时生成，其中的哈希与文件内容一致，旧数据目录没有清单时才逐个计算
+    Json::Value manifest;
+    if (access((datapath + constants::judge::TESTDATA_MANIFEST_NAME).data(), F_OK) == 0) {
+        manifest = TestDataStore::LoadManifest(datapath);
+    }
+    const Json::Value &cases = manifest["Cases"];
+
+    // 测试用例打包存放时先导出到内存文件系统，之后与单独存放的文件一样映射和锁定
+    TestDataPack pack;
+    if (pack.Open(datapath + constants::judge::TESTDATA_PACK_NAME)) {
+        data->extraction = Extract(problemid, datapath, pack);
+        data->casepath = data->extraction->casepath;
+        if (!data->extraction->ok) {
+            // 导出不完整时不映射，判题结果为系统错误
+            data->complete = false;
+            incomplete_num++;
+            return data;
+        }
+    }
+
+    data->inputs.resize(judgenum + 1);
+    data->outputs.resize(judgenum + 1);
+    data->hasoutput.resize(judgenum + 1, false);
+    data->inputhashes.resize(judgenum + 1);
+    data->outputhashes.resize(judgenum + 1);
+    for (int i = 1; i <= judgenum; i++) {
+        data->inputs[i] = make_unique<MappedFile>();
+        data->outputs[i] = make_unique<MappedFile>();
+        data->inputs[i]->Open(data->casepath + to_string(i) + ".in", true);
+        data->hasoutput[i] = data->outputs[i]->Open(data->casepath + to_string(i) + ".out", true);
+        data->bytes += data->inputs[i]->Size() + data->outputs[i]->Size();
+        // 文件大小与清单不一致（被截断或缺失）时按不完整处理，避免按错误的数据给出判定结果
+        const Json::Value &caseinfo = cases[i - 1];
+        if (caseinfo.isObject() && (caseinfo["InputSize"].asInt64() != (long long)data->inputs[i]->Size() ||
+                                    caseinfo["OutputSize"].asInt64() != (long long)data->outputs[i]->Size())) {
+            data->complete = false;
+        }
+        // 每个数据版本只计算一次哈希，测评记录中用它指代完整的测试数据（缺失的文件按空文件计算）
+        data->inputhashes[i] = caseinfo["InputHash"].asString();
+        data->outputhashes[i] = caseinfo["OutputHash"].asString();
+        if (data->inputhashes[i].empty()) {
+            data->inputhashes[i] = Sha256().Update(data->inputs[i]->Data(), data->inputs[i]->Size()).HexDigest();
+        }
+        if (data->outputhashes[i].empty()) {
+            data->outputhashes[i] = Sha256().Update(data->outputs[i]->Data(), data->outputs[i]->Size()).HexDigest();
+        }
+        if (constants::judge::TESTDATA_CACHE_LOCK_PAGES) {
+            // 锁定页面后，沙箱通过路径打开输入文件时也总能命中页缓存
+            if (!data->inputs[i]->Lock() || !data->outputs[i]->Lock()) {
+                data->locked = false;
+            }
+        }
+    }
+    if (constants::judge::TESTDATA_CACHE_LOCK_PAGES && !data->locked) {
+        lock_fail_num++;
+    }
+    if (!data->complete) {
+        incomplete_num++;
+    }
+    return data;
+}
+
+// 获取题目的测试数据
+shared_ptr<const TestData> TestDataCache::Get(const string &problemid, int judgenum) {
+    // 只解析一次符号链接，之后全部从同一个版本目录读取，加载期间切换数据版本也不会混用两个版本的文件
+    // 登记使用该版本目录，缓存命中时已由缓存的测试数据登记，直接取消
+    string datapath = constants::judge::PROBLEM_DATA_PREFIX + problemid + "/";
+    bool acquired = TestDataStore::GetInstance()->AcquireVersion(problemid, datapath);
+    long long version = GetPathVersion(datapath);
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        auto iter = entries.find(problemid);
+        if (iter != entries.end() && iter->second.data->version == version &&
+            (int)iter->second.data->inputs.size() == judgenum + 1) {
+            lru.splice(lru.begin(), lru, iter->second.iter);
+            hit_num++;
+            if (acquired) {
+                TestDataStore::GetInstance()->ReleaseVersion(datapath);
+            }
+            return iter->second.data;
+        }
+    }
+
+    // 在锁外加载，避免阻塞其他题目的判题
+    miss_num++;
+    shared_ptr<const TestData> data = Load(problemid, datapath, judgenum, version, acquired);
+    if (!data->complete || data->bytes > constants::judge::TESTDATA_CACHE_MAX_BYTES) {
+        // 不完整的测试数据不缓存，下一次判题重新加载；单个题目就超过缓存上限时同样不缓存，只供本次判题使用
+        return data;
+    }
+
+    lock_guard<mutex> lock(cache_mutex);
+    auto iter = entries.find(problemid);
+    if (iter != entries.end()) {
+        total_bytes -= iter->second.data->bytes;
+        lru.erase(iter->second.iter);
+        entries.erase(iter);
+    }
+    lru.push_front(problemid);
+    entries[problemid] = {data, lru.begin()};
+    total_bytes += data->bytes;
+    // 按最近最少使用淘汰，正在使用的数据由判题机持有，淘汰后才会真正解除映射
+    while (total_bytes > constants::judge::TESTDATA_CACHE_MAX_BYTES && lru.size() > 1) {
+        string victim = lru.back();
+        lru.pop_back();
+        total_bytes -= entries[victim].data->bytes;
+        entries.erase(victim);
+    }
+    return data;
+}
+
+// 使题目的测试数据缓存失效
+void TestDataCache::Invalidate(const string &problemid) {
+    lock_guard<mutex> lock(cache_mutex);
+    DropExtraction(problemid);
+    auto iter = entries.find(problemid);
+    if (iter == entries.end()) {
+        return;
+    }
+    total_bytes -= iter->second.data->bytes;
+    lru.erase(iter->second.iter);
+    entries.erase(iter);
+    invalidate_num++;
+}
+
+// 获取测试数据缓存的运行状态
+Json::Value TestDataCache::GetStats() {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        resjson["EntryNum"] = (Json::UInt64)entries.size();
+        resjson["TotalBytes"] = (Json::Int64)total_bytes;
+        resjson["ExtractEntryNum"] = (Json::UInt64)extractions.size();
+        resjson["ExtractBytes"] = (Json::Int64)extract_bytes;
+    }
+    resjson["MaxBytes"] = (Json::Int64)constants::judge::TESTDATA_CACHE_MAX_BYTES;
+    resjson["HitNum"] = (Json::Int64)hit_num.load();
+    resjson["MissNum"] = (Json::Int64)miss_num.load();
+    resjson["LockFailNum"] = (Json::Int64)lock_fail_num.load();
+    resjson["InvalidateNum"] = (Json::Int64)invalidate_num.load();
+    resjson["IncompleteNum"] = (Json::Int64)incomplete_num.load();
+    resjson["ExtractNum"] = (Json::Int64)extract_num.load();
+    resjson["ExtractFailNum"] = (Json::Int64)extract_fail_num.load();
+    resjson["ExtractHitNum"] = (Json::Int64)extract_hit_num.load();
+    return resjson;
+}
+
+TestDataCache::TestDataCache()
+    : total_bytes(0),
+      extract_bytes(0),
+      hit_num(0),
+      miss_num(0),
+      lock_fail_num(0),
+      invalidate_num(0),
+      extract_seq(0),
+      extract_num(0),
+      extract_fail_num(0),
+      extract_hit_num(0),
+      incomplete_num(0) {
+    // 构造函数实现
+    // 测试数据释放时要取消版本目录的登记，先构造数据存储，保证它在缓存之后析构
+    TestDataStore::GetInstance();
+    // 清理上次异常退出时残留的导出目录
+    error_code ec;
+    filesystem::remove_all(constants::judge::TESTDATA_EXTRACT_PATH, ec);
+}
+
+TestDataCache::~TestDataCache() {
+    // 析构函数实现
+}
@@ -0,0 +1,263 @@
+#include "judger/testdata_pack.h"
+
+#include <fcntl.h>
+#include <unistd.h>
+#include <zstd.h>
+
+#include <cstring>
+
+#include "constants/judge.h"
+#include "utils/sha256.hpp"
+
+using namespace std;
+
+// 数据按 64 字节对齐
+static inline uint64_t AlignUp(uint64_t value) {
+    return (value + 63) & ~(uint64_t)63;
+}
+
+// 映射并校验数据包
+bool TestDataPack::Open(const string &path) {
+    entries_ = nullptr;
+    entrynum_ = 0;
+    indexes_.clear();
+    if (!file_.Open(path) || file_.Size() < sizeof(PackHeader)) {
+        return false;
+    }
+    const PackHeader *header = (const PackHeader *)file_.Data();
+    uint64_t size = file_.Size();
+    if (memcmp(header->magic, PACK_MAGIC, sizeof(PACK_MAGIC)) != 0 || header->version != PACK_FORMAT_VERSION ||
+        header->entrynum > header->capacity || header->filesize != size ||
+        header->dataoffset < sizeof(PackHeader) + (uint64_t)header->capacity * sizeof(PackEntry) ||
+        header->dataoffset > size) {
+        return false;
+    }
+    const PackEntry *entries = (const PackEntry *)(file_.Data() + sizeof(PackHeader));
+    for (uint32_t i = 0; i < header->entrynum; i++) {
+        const PackEntry &entry = entries[i];
+        if (memchr(entry.name, '\0', sizeof(entry.name)) == nullptr || entry.offset < header->dataoffset ||
+            entry.storedsize > size - entry.offset || entry.offset > size) {
+            return false;
+        }
+        indexes_[entry.name] = i;
+    }
+    entries_ = entries;
+    entrynum_ = header->entrynum;
+    return true;
+}
+
+// 查找文件的索引项
+const PackEntry *TestDataPack::Find(const string &name) const {
+    auto iter = indexes_.find(name);
+    return iter == indexes_.end() ? nullptr : &entries_[iter->second];
+}
+
+// 全部索引项
+vector<const PackEntry *> TestDataPack::Entries() const {
+    vector<const PackEntry *> entries;
+    for (uint32_t i = 0; i < entrynum_; i++) {
+        entries.push_back(&entries_[i]);
+    }
+    return entries;
+}
+
+// 顺序读取一个文件原始内容的一段
+bool TestDataPack::Stream(const string &name, size_t offset, size_t length,
+                          const function<bool(const char *, size_t)> &sink) const {
+    const PackEntry *entry = Find(name);
+    if (entry == nullptr) {
+        return false;
+    }
+    if (offset >= entry->rawsize) {
+        return true;
+    }
+    uint64_t end = offset + min<uint64_t>(length, entry->rawsize - offset);
+    const char *data = file_.Data() + entry->offset;
+    size_t chunk = constants::judge::TESTDATA_PACK_CHUNK_SIZE;
+    if (!(entry->flags & PACK_FLAG_ZSTD)) {
+        for (uint64_t off = offset; off < end; off += chunk) {
+            if (!sink(data + off, min<uint64_t>(chunk, end - off))) {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    // 按块解压，内存占用与文件大小无关
+    ZSTD_DCtx *dctx = ZSTD_createDCtx();
+    if (dctx == nullptr) {
+        return false;
+    }
+    vector<char> buffer(chunk);
+    ZSTD_inBuffer in = {data, entry->storedsize, 0};
+    uint64_t total = 0;  // 已解压的字节数
+    size_t ret = 1;
+    bool ok = true;
+    while (ok && total < end && (in.pos < in.size || ret != 0)) {
+        ZSTD_outBuffer out = {buffer.data(), buffer.size(), 0};
+        ret = ZSTD_decompressStream(dctx, &out, &in);
+        if (ZSTD_isError(ret) || (out.pos == 0 && in.pos == in.size && ret != 0)) {
+            ok = false;
+            break;
+        }
+        // 只把与 [offset, end) 重叠的部分交给回调
+        uint64_t begin = max<uint64_t>(total, offset);
+        uint64_t stop = min<uint64_t>(total + out.pos, end);
+        if (begin < stop) {
+            ok = sink(buffer.data() + (begin - total), stop - begin);
+        }
+        total += out.pos;
+    }
+    ZSTD_freeDCtx(dctx);
+    return ok && total >= end;
+}
+
+// 读取一个文件原始内容的一段
+bool TestDataPack::Read(const string &name, size_t offset, size_t length, string &content) const {
+    content.clear();
+    return Stream(name, offset, length, [&content](const char *data, size_t size) {
+        content.append(data, size);
+        return true;
+    });
+}
+
+// 将一个文件的原始内容写到指定路径
+bool TestDataPack::Extract(const string &name, const string &path) const {
+    int fd = open(path.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    if (fd < 0) {
+        return false;
+    }
+    bool ok = Stream(name, 0, SIZE_MAX, [fd](const char *data, size_t size) {
+        while (size > 0) {
+            ssize_t n = write(fd, data, size);
+            if (n <= 0) {
+                return false;
+            }
+            data += n;
+            size -= n;
+        }
+        return true;
+    });
+    return close(fd) == 0 && ok;
+}
+
+TestDataPackWriter::~TestDataPackWriter() {
+    if (fd_ >= 0) {
+        close(fd_);
+    }
+}
+
+// 创建数据包并预留索引项
+bool TestDataPackWriter::Open(const string &path, uint32_t capacity) {
+    fd_ = open(path.data(), O_WRONLY | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+    capacity_ = capacity;
+    dataoffset_ = AlignUp(sizeof(PackHeader) + (uint64_t)capacity * sizeof(PackEntry));
+    offset_ = dataoffset_;
+    entries_.clear();
+    return fd_ >= 0;
+}
+
+// 在当前位置写入数据
+bool TestDataPackWriter::Write(const char *data, size_t size) {
+    while (size > 0) {
+        ssize_t n = pwrite(fd_, data, size, offset_);
+        if (n <= 0) {
+            return false;
+        }
+        data += n;
+        size -= n;
+        offset_ += n;
+    }
+    return true;
+}
+
+// 追加一个索引项
+bool TestDataPackWriter::AddEntry(const string &name, uint64_t storedsize, uint64_t rawsize, uint32_t flags,
+                                  const string &hash) {
+    PackEntry entry;
+    memset(&entry, 0, sizeof(entry));
+    if (entries_.size() >= capacity_ || name.size() >= sizeof(entry.name) || hash.size() != sizeof(entry.hash)) {
+        return false;
+    }
+    memcpy(entry.name, name.data(), name.size());
+    entry.offset = offset_ - storedsize;
+    entry.storedsize = storedsize;
+    entry.rawsize = rawsize;
+    entry.flags = flags;
+    memcpy(entry.hash, hash.data(), sizeof(entry.hash));
+    entries_.push_back(entry);
+    offset_ = AlignUp(offset_);
+    return true;
+}
+
+// 加入一个文件
+bool TestDataPackWriter::AddFile(const string &name, const string &srcpath, const string &hash, bool compress) {
+    MappedFile src;
+    if (fd_ < 0 || !src.Open(srcpath)) {
+        return false;
+    }
+    string digest = hash.empty() ? Sha256().Update(src.Data(), src.Size()).HexDigest() : hash;
+    uint64_t start = offset_;
+    if (compress && src.Size() >= constants::judge::TESTDATA_PACK_MIN_COMPRESS_BYTES) {
+        ZSTD_CCtx *cctx = ZSTD_createCCtx();
+        // 压缩后至少要节省 TESTDATA_PACK_MIN_SAVING 的比例，否则按原样存放（解压同样有开销）
+        uint64_t limit = src.Size() - src.Size() * constants::judge::TESTDATA_PACK_MIN_SAVING / 100;
+        bool ok = cctx != nullptr;
+        if (ok) {
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_compressionLevel, constants::judge::TESTDATA_PACK_ZSTD_LEVEL);
+            // 帧末尾带校验和，数据损坏时解压失败，而不是导出错误的内容
+            ZSTD_CCtx_setParameter(cctx, ZSTD_c_checksumFlag, 1);
+            ZSTD_CCtx_setPledgedSrcSize(cctx, src.Size());
+            vector<char> buffer(ZSTD_CStreamOutSize());
+            ZSTD_inBuffer in = {src.Data(), src.Size(), 0};
+            size_t remaining;
+            do {
+                ZSTD_outBuffer out = {buffer.data(), buffer.size(), 0};
+                remaining = ZSTD_compressStream2(cctx, &out, &in, ZSTD_e_end);
+                ok = !ZSTD_isError(remaining) && Write(buffer.data(), out.pos) && offset_ - start < limit;
+            } while (ok && remaining != 0);
+            ZSTD_freeCCtx(cctx);
+        }
+        if (ok) {
+            return AddEntry(name, offset_ - start, src.Size(), PACK_FLAG_ZSTD, digest);
+        }
+        offset_ = start;
+    }
+    return Write(src.Data(), src.Size()) && AddEntry(name, src.Size(), src.Size(), 0, digest);
+}
+
+// 从另一个数据包原样复制一个文件
+bool TestDataPackWriter::CopyEntry(const TestDataPack &pack, const string &name, const string &newname) {
+    const PackEntry *entry = pack.Find(name);
+    if (fd_ < 0 || entry == nullptr) {
+        return false;
+    }
+    return Write(pack.Data() + entry->offset, entry->storedsize) &&
+           AddEntry(newname, entry->storedsize, entry->rawsize, entry->flags, string(entry->hash, sizeof(entry->hash)));
+}
+
+// 写入头部和索引并关闭文件
+bool TestDataPackWriter::Finish() {
+    if (fd_ < 0) {
+        return false;
+    }
+    PackHeader header;
+    memset(&header, 0, sizeof(header));
+    memcpy(header.magic, PACK_MAGIC, sizeof(PACK_MAGIC));
+    header.version = PACK_FORMAT_VERSION;
+    header.entrynum = entries_.size();
+    header.capacity = capacity_;
+    header.dataoffset = dataoffset_;
+    header.filesize = offset_;
+    // 未使用的索引项和对齐的空隙保持为 0（放弃压缩时写过的部分由 ftruncate 截掉）
+    vector<PackEntry> index(capacity_);
+    memset(index.data(), 0, index.size() * sizeof(PackEntry));
+    copy(entries_.begin(), entries_.end(), index.begin());
+    bool ok = ftruncate(fd_, offset_) == 0 &&
+              pwrite(fd_, &header, sizeof(header), 0) == (ssize_t)sizeof(header) &&
+              pwrite(fd_, index.data(), index.size() * sizeof(PackEntry), sizeof(header)) ==
+                  (ssize_t)(index.size() * sizeof(PackEntry));
+    ok = close(fd_) == 0 && ok;
+    fd_ = -1;
+    return ok;
+}
@@ -0,0 +1,615 @@
+#include "judger/testdata_store.h"
+
+#include <fcntl.h>
+#include <stdio.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstring>
+#include <filesystem>
+#include <fstream>
+#include <vector>
+
+#include "constants/judge.h"
+#include "judger/output_comparator.h"
+#include "judger/spj_cache.h"
+#include "judger/testdata_pack.h"
+#include "utils/sha256.hpp"
+
+using namespace std;
+namespace fs = std::filesystem;
+
+using constants::judge::PROBLEM_DATA_PREFIX;
+using constants::judge::TESTDATA_MANIFEST_NAME;
+using constants::judge::TESTDATA_PACK_NAME;
+
+// 局部静态特性的方式实现单实例模式
+TestDataStore *TestDataStore::GetInstance() {
+    static TestDataStore testdata_store;
+    return &testdata_store;
+}
+
+// 题目 ID 是否合法
+bool TestDataStore::IsValidProblemId(const string &problemid) {
+    if (problemid.empty() || problemid.size() > 20) {
+        return false;
+    }
+    for (char c : problemid) {
+        if (c < '0' || c > '9') {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 是否为可上传的测试数据文件名
+bool TestDataStore::IsDataFileName(const string &name) {
+    if (name == "spj.cpp") {
+        return true;
+    }
+    size_t dot = name.find('.');
+    if (dot == string::npos || dot == 0 || dot > 9 || name[0] == '0') {
+        return false;
+    }
+    string ext = name.substr(dot);
+    if (ext != ".in" && ext != ".out") {
+        return false;
+    }
+    long long index = 0;
+    for (size_t i = 0; i < dot; i++) {
+        if (name[i] < '0' || name[i] > '9') {
+            return false;
+        }
+        index = index * 10 + (name[i] - '0');
+    }
+    return index <= constants::judge::TESTDATA_MAX_CASES;
+}
+
+// 计算文件的大小和 SHA-256
+bool TestDataStore::HashFile(const string &path, long long &size, string &hash) {
+    struct stat st;
+    if (stat(path.data(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        size = 0;
+        hash = "";
+        return false;
+    }
+    MappedFile file;
+    file.Open(path);
+    size = file.Size();
+    hash = Sha256().Update(file.Data(), file.Size()).HexDigest();
+    return true;
+}
+
+// 解析题目当前版本的数据目录
+bool TestDataStore::Resolve(const string &problemid, string &datapath) {
+    string linkpath = PROBLEM_DATA_PREFIX + problemid;
+    struct stat st;
+    if (lstat(linkpath.data(), &st) != 0) {
+        return false;
+    }
+    if (S_ISDIR(st.st_mode)) {
+        // 引入版本目录之前的数据目录
+        datapath = linkpath + "/";
+        return true;
+    }
+    if (!S_ISLNK(st.st_mode)) {
+        return false;
+    }
+    char target[256];
+    ssize_t len = readlink(linkpath.data(), target, sizeof(target) - 1);
+    if (len <= 0) {
+        return false;
+    }
+    datapath = PROBLEM_DATA_PREFIX + string(target, len) + "/";
+    return true;
+}
+
+// 解析题目当前版本的数据目录并登记使用
+bool TestDataStore::AcquireVersion(const string &problemid, string &datapath) {
+    // 与提交删除旧版本使用同一把锁，解析和登记之间版本目录不会被删除
+    lock_guard<mutex> lock(version_mutex);
+    if (!Resolve(problemid, datapath)) {
+        return false;
+    }
+    version_refs[datapath]++;
+    return true;
+}
+
+// 取消版本目录的使用登记
+void TestDataStore::ReleaseVersion(const string &datapath) {
+    {
+        lock_guard<mutex> lock(version_mutex);
+        auto iter = version_refs.find(datapath);
+        if (iter == version_refs.end() || --iter->second > 0) {
+            return;
+        }
+        version_refs.erase(iter);
+        if (retired_paths.erase(datapath) == 0) {
+            return;
+        }
+    }
+    // 已不是当前版本，不会再被登记，可以在锁外删除
+    error_code ec;
+    fs::remove_all(datapath, ec);
+}
+
+// 删除已被替换的版本目录
+void TestDataStore::RetireVersion(const string &datapath) {
+    {
+        lock_guard<mutex> lock(version_mutex);
+        if (version_refs.count(datapath) > 0) {
+            retired_paths.insert(datapath);
+            deferred_num++;
+            return;
+        }
+    }
+    error_code ec;
+    fs::remove_all(datapath, ec);
+}
+
+// 读取数据目录的清单
+Json::Value TestDataStore::LoadManifest(const string &datapath) {
+    Json::Value manifest;
+    ifstream infile(datapath + TESTDATA_MANIFEST_NAME);
+    if (infile.is_open()) {
+        Json::CharReaderBuilder builder;
+        string errs;
+        if (Json::parseFromStream(builder, infile, &manifest, &errs) && manifest.isObject()) {
+            return manifest;
+        }
+        manifest = Json::Value();
+    }
+
+    // 旧数据目录没有清单，测试用例数目按从 1 开始连续存在的输入文件计算
+    manifest["Version"] = 0;
+    manifest["Packed"] = false;
+    manifest["Cases"] = Json::Value(Json::arrayValue);
+    int judgenum = 0;
+    while (judgenum < constants::judge::TESTDATA_MAX_CASES &&
+           access((datapath + to_string(judgenum + 1) + ".in").data(), F_OK) == 0) {
+        judgenum++;
+        Json::Value caseinfo;
+        long long size;
+        string hash;
+        caseinfo["Index"] = judgenum;
+        HashFile(datapath + to_string(judgenum) + ".in", size, hash);
+        caseinfo["InputSize"] = (Json::Int64)size;
+        caseinfo["InputHash"] = hash;
+        HashFile(datapath + to_string(judgenum) + ".out", size, hash);
+        caseinfo["OutputSize"] = (Json::Int64)size;
+        caseinfo["OutputHash"] = hash;
+        manifest["Cases"].append(caseinfo);
+    }
+    manifest["JudgeNum"] = judgenum;
+    long long size;
+    string hash;
+    if (HashFile(datapath + "spj.cpp", size, hash)) {
+        manifest["SPJ"]["Size"] = (Json::Int64)size;
+        manifest["SPJ"]["Hash"] = hash;
+    } else {
+        manifest["SPJ"] = Json::Value();
+    }
+    return manifest;
+}
+
+// 获取数据目录中一个文件的大小
+long long TestDataStore::GetFileSize(const string &datapath, const string &name) {
+    TestDataPack pack;
+    if (name != "spj.cpp" && pack.Open(datapath + TESTDATA_PACK_NAME)) {
+        const PackEntry *entry = pack.Find(name);
+        return entry == nullptr ? -1 : (long long)entry->rawsize;
+    }
+    struct stat st;
+    if (stat((datapath + name).data(), &st) != 0 || !S_ISREG(st.st_mode)) {
+        return -1;
+    }
+    return st.st_size;
+}
+
+// 顺序读取数据目录中一个文件的一段内容
+bool TestDataStore::StreamFile(const string &datapath, const string &name, size_t offset, size_t length,
+                               const function<bool(const char *, size_t)> &sink) {
+    TestDataPack pack;
+    if (name != "spj.cpp" && pack.Open(datapath + TESTDATA_PACK_NAME)) {
+        return pack.Stream(name, offset, length, sink);
+    }
+    MappedFile file;
+    if (!file.Open(datapath + name)) {
+        return false;
+    }
+    size_t chunk = constants::judge::TESTDATA_PACK_CHUNK_SIZE;
+    size_t end = offset + min(length, file.Size() - min(offset, file.Size()));
+    for (size_t off = offset; off < end; off += chunk) {
+        if (!sink(file.Data() + off, min(chunk, end - off))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// 读取数据目录中一个文件的一段内容
+bool TestDataStore::ReadFile(const string &datapath, const string &name, size_t offset, size_t length,
+                             string &content) {
+    content.clear();
+    return StreamFile(datapath, name, offset, length, [&content](const char *data, size_t size) {
+        content.append(data, size);
+        return true;
+    });
+}
+
+// 截取测试数据的预览
+string TestDataStore::Preview(const char *data, size_t size) {
+    size_t len = min(size, (size_t)constants::judge::TESTINFO_PREVIEW_BYTES);
+    const char *p = data;
+    for (int line = 0; line < constants::judge::TESTINFO_PREVIEW_LINES; line++) {
+        p = (const char *)memchr(p, '\n', data + len - p);
+        if (p == nullptr) {
+            break;
+        }
+        p++;
+    }
+    if (p != nullptr) {
+        len = p - data;
+    }
+    while (len < size && len > 0 && (data[len] & 0xC0) == 0x80) {
+        len--;
+    }
+    return string(data, len);
+}
+
+// 获取题目当前版本的清单
+Json::Value TestDataStore::GetManifest(const string &problemid) {
+    string datapath;
+    if (!IsValidProblemId(problemid) || !Resolve(problemid, datapath)) {
+        return Json::Value();
+    }
+    return LoadManifest(datapath);
+}
+
+// 创建上传使用的暂存目录
+string TestDataStore::CreateStaging(const string &problemid) {
+    if (!IsValidProblemId(problemid)) {
+        return "";
+    }
+    string stagingpath = PROBLEM_DATA_PREFIX + string(".staging.") + problemid + "." + to_string(staging_seq++) + "/";
+    error_code ec;
+    fs::remove_all(stagingpath, ec);
+    if (!fs::create_directories(stagingpath, ec)) {
+        return "";
+    }
+    return stagingpath;
+}
+
+// 删除暂存目录
+void TestDataStore::RemoveStaging(const string &stagingpath) {
+    error_code ec;
+    fs::remove_all(stagingpath, ec);
+}
+
+// 将暂存目录中的文件提交为题目数据的新版本
+bool TestDataStore::Commit(const Json::Value &commitjson, const string &stagingpath, Json::Value &resultjson,
+                           string &error) {
+    string problemid = commitjson["ProblemId"].asString();
+    int judgenum = commitjson["JudgeNum"].asInt();
+    if (!IsValidProblemId(problemid)) {
+        error = "题目 ID 不合法";
+        return false;
+    }
+    if (judgenum < 0 || judgenum > constants::judge::TESTDATA_MAX_CASES) {
+        error = "测试用例数目不合法";
+        return false;
+    }
+
+    lock_guard<mutex> lock(commit_mutex);
+    string linkpath = PROBLEM_DATA_PREFIX + problemid;
+    string curpath;
+    bool exists = Resolve(problemid, curpath);
+    Json::Value current = exists ? LoadManifest(curpath) : Json::Value();
+    long long curversion = exists ? current["Version"].asInt64() : 0;
+    int curjudgenum = exists ? current["JudgeNum"].asInt() : 0;
+    if (commitjson.isMember("BaseVersion") && commitjson["BaseVersion"].asInt64() != curversion) {
+        resultjson["Conflict"] = true;
+        resultjson["Version"] = (Json::Int64)curversion;
+        error = "题目数据已被修改，请刷新后重试";
+        return false;
+    }
+
+    // 当前版本的数据包（打包和未打包的版本之间可以互相转换）
+    bool packed = constants::judge::TESTDATA_PACK_ENABLED;
+    if (commitjson.isMember("Packed")) {
+        packed = commitjson["Packed"].asBool();
+    }
+    // 新版本每个测试用例复用的当前版本测试用例序号（0 表示新增），未指定时按相同序号复用
+    const Json::Value &casemap = commitjson["CaseMap"];
+    bool remap = !casemap.isNull();
+    if (remap && (!casemap.isArray() || casemap.size() != (Json::ArrayIndex)judgenum)) {
+        error = "测试用例的重新编号与测试用例数目不一致";
+        return false;
+    }
+    vector<int> sources(judgenum + 1, 0);
+    for (int i = 1; i <= judgenum; i++) {
+        if (remap && !casemap[i - 1].isInt()) {
+            error = "测试用例的重新编号不合法";
+            return false;
+        }
+        sources[i] = remap ? casemap[i - 1].asInt() : (i <= curjudgenum ? i : 0);
+        if (sources[i] < 0 || sources[i] > curjudgenum) {
+            error = "测试用例的重新编号不合法";
+            return false;
+        }
+    }
+
+    bool curpacked = exists && current["Packed"].asBool();
+    TestDataPack curpack;
+    if (curpacked && !curpack.Open(curpath + TESTDATA_PACK_NAME)) {
+        error = "当前版本的数据包已损坏";
+        return false;
+    }
+
+    long long newversion = curversion + 1;
+    string newname = problemid + "@" + to_string(newversion);
+    string newpath = PROBLEM_DATA_PREFIX + newname + "/";
+    error_code ec;
+    // 清理异常退出时残留的同名版本目录
+    fs::remove_all(newpath, ec);
+    if (!fs::create_directories(newpath, ec)) {
+        error = "无法创建数据目录";
+        return false;
+    }
+    TestDataPackWriter packwriter;
+    if (packed && !packwriter.Open(newpath + TESTDATA_PACK_NAME, judgenum * 2)) {
+        error = "无法创建数据包";
+        fs::remove_all(newpath, ec);
+        return false;
+    }
+
+    int writtennum = 0;
+    int reusednum = 0;
+    long long writtenbytes = 0;
+    // 放入一个文件：暂存目录中有且内容不同则写入，否则复用当前版本的文件 srcname（测试用例重新编号时与 name 不同）
+    // 测试用例在新版本打包时加入数据包（复用数据包中的文件时原样复制，不重新压缩），否则移入或硬链接（失败时复制）
+    // 返回值：1 写入，0 复用，-1 两者都没有，-2 出错
+    auto place = [&](const string &name, const string &srcname, const string &curhash, long long cursize,
+                     long long &size, string &hash) {
+        bool topack = packed && name != "spj.cpp";
+        bool frompack = curpacked && name != "spj.cpp";
+        string staged = stagingpath + name;
+        if (HashFile(staged, size, hash) && hash != curhash) {
+            bool ok = topack ? packwriter.AddFile(name, staged, hash, constants::judge::TESTDATA_PACK_COMPRESS)
+                             : rename(staged.data(), (newpath + name).data()) == 0;
+            if (!ok) {
+                return -2;
+            }
+            writtennum++;
+            writtenbytes += size;
+            return 1;
+        }
+        if (curhash.empty()) {
+            size = 0;
+            hash = "";
+            return -1;
+        }
+        bool ok;
+        if (topack && frompack) {
+            ok = packwriter.CopyEntry(curpack, srcname, name);
+        } else if (topack) {
+            ok = packwriter.AddFile(name, curpath + srcname, curhash, constants::judge::TESTDATA_PACK_COMPRESS);
+        } else if (frompack) {
+            ok = curpack.Extract(srcname, newpath + name);
+        } else {
+            error_code copyec;
+            ok = link((curpath + srcname).data(), (newpath + name).data()) == 0 ||
+                 fs::copy_file(curpath + srcname, newpath + name, copyec);
+        }
+        if (!ok) {
+            return -2;
+        }
+        size = cursize;
+        hash = curhash;
+        reusednum++;
+        return 0;
+    };
+
+    bool changed = judgenum != curjudgenum || packed != curpacked;
+    Json::Value manifest;
+    manifest["Version"] = (Json::Int64)newversion;
+    manifest["JudgeNum"] = judgenum;
+    manifest["Packed"] = packed;
+    manifest["Cases"] = Json::Value(Json::arrayValue);
+    for (int i = 1; i <= judgenum; i++) {
+        int src = sources[i];
+        const Json::Value &curcase = src > 0 ? current["Cases"][src - 1] : Json::Value::nullSingleton();
+        // 测试用例移动了位置时，即使内容不变也生成新版本
+        changed = changed || (src > 0 && src != i);
+        Json::Value caseinfo;
+        caseinfo["Index"] = i;
+        for (const char *ext : {".in", ".out"}) {
+            string field = ext == string(".in") ? "Input" : "Output";
+            long long size;
+            string hash;
+            string name = to_string(i) + ext;
+            int placed = place(name, to_string(src) + ext, curcase[field + "Hash"].asString(),
+                               curcase[field + "Size"].asInt64(), size, hash);
+            if (placed == -2 || (placed == -1 && src == 0)) {
+                // 新增的测试用例必须同时上传输入和标准答案
+                error = (placed == -2 ? "无法写入测试数据文件 " : "缺少测试数据文件 ") + name;
+                fs::remove_all(newpath, ec);
+                return false;
+            }
+            changed = changed || placed == 1;
+            caseinfo[field + "Size"] = (Json::Int64)size;
+            caseinfo[field + "Hash"] = hash;
+        }
+        manifest["Cases"].append(caseinfo);
+    }
+
+    // SPJ 源文件，内容不变时连同指向编译产物的符号链接一起复用
+    bool removespj = commitjson["RemoveSPJ"].asBool();
+    string curspjhash = exists ? current["SPJ"]["Hash"].asString() : "";
+    long long curspjsize = exists ? current["SPJ"]["Size"].asInt64() : 0;
+    long long spjsize = 0;
+    string spjhash;
+    int spjplaced = removespj ? -1 : place("spj.cpp", "spj.cpp", curspjhash, curspjsize, spjsize, spjhash);
+    if (spjplaced == -2) {
+        error = "无法写入 SPJ 文件";
+        fs::remove_all(newpath, ec);
+        return false;
+    }
+    bool spjchanged = spjhash != curspjhash;
+    changed = changed || spjchanged;
+    if (spjplaced >= 0) {
+        manifest["SPJ"]["Size"] = (Json::Int64)spjsize;
+        manifest["SPJ"]["Hash"] = spjhash;
+    } else {
+        manifest["SPJ"] = Json::Value();
+    }
+
+    resultjson["JudgeNum"] = judgenum;
+    if (!changed) {
+        // 内容没有变化，不生成新版本，判题使用的缓存也继续有效
+        fs::remove_all(newpath, ec);
+        unchanged_num++;
+        resultjson["Changed"] = false;
+        resultjson["Version"] = (Json::Int64)curversion;
+        resultjson["WrittenNum"] = 0;
+        resultjson["ReusedNum"] = 0;
+        return true;
+    }
+
+    if (packed && !packwriter.Finish()) {
+        error = "无法写入数据包";
+        fs::remove_all(newpath, ec);
+        return false;
+    }
+
+    // 在切换版本之前编译 SPJ，切换之后判题立即使用新版本的 SPJ
+    if (spjplaced >= 0) {
+        char spjtarget[256];
+        ssize_t len = spjchanged ? -1 : readlink((curpath + "spj").data(), spjtarget, sizeof(spjtarget) - 1);
+        if (len <= 0 || symlink(string(spjtarget, len).data(), (newpath + "spj").data()) != 0) {
+            string compileinfo;
+            if (!SpjCache::GetInstance()->Build(problemid, compileinfo, newpath)) {
+                resultjson["CompilerInfo"] = compileinfo;
+            }
+        }
+    }
+
+    Json::StreamWriterBuilder writer;
+    writer["indentation"] = "";
+    ofstream outfile(newpath + TESTDATA_MANIFEST_NAME);
+    outfile << Json::writeString(writer, manifest);
+    outfile.close();
+    if (!outfile) {
+        error = "无法写入测试数据清单";
+        fs::remove_all(newpath, ec);
+        return false;
+    }
+
+    // 先创建临时符号链接再 rename 覆盖，判题时解析到的总是完整的旧版本或新版本之一
+    string tmplink = PROBLEM_DATA_PREFIX + string(".") + problemid + ".tmp";
+    unlink(tmplink.data());
+    if (symlink(newname.data(), tmplink.data()) != 0) {
+        error = "无法创建数据目录链接";
+        fs::remove_all(newpath, ec);
+        return false;
+    }
+    struct stat st;
+    bool legacy = exists && lstat(linkpath.data(), &st) == 0 && S_ISDIR(st.st_mode);
+    string legacypath = PROBLEM_DATA_PREFIX + problemid + "@0";
+    int ret;
+    if (!legacy) {
+        ret = rename(tmplink.data(), linkpath.data());
+    } else if (renameat2(AT_FDCWD, tmplink.data(), AT_FDCWD, linkpath.data(), RENAME_EXCHANGE) == 0) {
+        // 旧数据目录与符号链接原子交换，再改名为版本 0 保留到下一次提交
+        ret = rename(tmplink.data(), legacypath.data());
+    } else if (errno == EINVAL || errno == ENOSYS) {
+        // 文件系统不支持原子交换时先移走旧目录，期间有极短的时间题目数据不存在
+        ret = rename(linkpath.data(), legacypath.data()) || rename(tmplink.data(), linkpath.data());
+    } else {
+        ret = -1;
+    }
+    if (ret != 0) {
+        unlink(tmplink.data());
+        error = "无法切换数据版本";
+        fs::remove_all(newpath, ec);
+        return false;
+    }
+
+    // 保留当前和上一个版本，删除更早的版本（仍有判题在使用时推迟删除，沙箱按路径打开其中的标准输入）
+    if (curversion > 0) {
+        RetireVersion(PROBLEM_DATA_PREFIX + problemid + "@" + to_string(curversion - 1) + "/");
+    }
+
+    commit_num++;
+    written_num += writtennum;
+    written_bytes += writtenbytes;
+    reused_num += reusednum;
+    resultjson["Changed"] = true;
+    resultjson["Version"] = (Json::Int64)newversion;
+    resultjson["WrittenNum"] = writtennum;
+    resultjson["ReusedNum"] = reusednum;
+    return true;
+}
+
+// 删除题目的全部数据版本
+bool TestDataStore::Remove(const string &problemid) {
+    if (!IsValidProblemId(problemid)) {
+        return false;
+    }
+    lock_guard<mutex> lock(commit_mutex);
+    error_code ec;
+    fs::remove_all(PROBLEM_DATA_PREFIX + problemid, ec);
+    string prefix = problemid + "@";
+    for (auto iter = fs::directory_iterator(PROBLEM_DATA_PREFIX, ec); !ec && iter != fs::directory_iterator();
+         iter.increment(ec)) {
+        if (iter->path().filename().string().rfind(prefix, 0) == 0) {
+            error_code rmec;
+            fs::remove_all(iter->path(), rmec);
+        }
+    }
+    return true;
+}
+
+// 获取测试数据存储的运行状态
+Json::Value TestDataStore::GetStats() {
+    Json::Value resjson;
+    resjson["CommitNum"] = (Json::Int64)commit_num.load();
+    resjson["UnchangedNum"] = (Json::Int64)unchanged_num.load();
+    resjson["WrittenNum"] = (Json::Int64)written_num.load();
+    resjson["WrittenBytes"] = (Json::Int64)written_bytes.load();
+    resjson["ReusedNum"] = (Json::Int64)reused_num.load();
+    {
+        lock_guard<mutex> lock(version_mutex);
+        resjson["InUseNum"] = (Json::UInt64)version_refs.size();
+    }
+    resjson["DeferredNum"] = (Json::Int64)deferred_num.load();
+    return resjson;
+}
+
+TestDataStore::TestDataStore()
+    : staging_seq(0),
+      commit_num(0),
+      unchanged_num(0),
+      written_num(0),
+      written_bytes(0),
+      reused_num(0),
+      deferred_num(0) {
+    // 构造函数实现
+    error_code ec;
+    fs::create_directories(PROBLEM_DATA_PREFIX, ec);
+    // 清理上次异常退出残留的暂存目录和临时符号链接
+    for (auto iter = fs::directory_iterator(PROBLEM_DATA_PREFIX, ec); !ec && iter != fs::directory_iterator();
+         iter.increment(ec)) {
+        string name = iter->path().filename().string();
+        if (name.rfind(".staging.", 0) == 0 || (name[0] == '.' && name.size() > 4 &&
+                                                name.compare(name.size() - 4, 4, ".tmp") == 0)) {
+            error_code rmec;
+            fs::remove_all(iter->path(), rmec);
+        }
+    }
+}
+
+TestDataStore::~TestDataStore() {
+    // 析构函数实现
+}
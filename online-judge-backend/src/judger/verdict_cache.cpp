@@ -0,0 +1,147 @@
+#include "judger/verdict_cache.h"
+
+#include "constants/judge.h"
+#include "judger/testdata_cache.h"
+#include "utils/sha256.hpp"
+
+using namespace std;
+
+// 局部静态特性的方式实现单实例模式
+VerdictCache *VerdictCache::GetInstance() {
+    static VerdictCache verdict_cache;
+    return &verdict_cache;
+}
+
+// 估计判题结果占用的字节数
+long long VerdictCache::EstimateBytes(const JudgeResult &result) {
+    long long bytes = sizeof(JudgeResult) + result.statusrecordid.size() + result.compilerinfo.size();
+    for (const CaseResult &testinfo : result.testinfo) {
+        bytes += sizeof(CaseResult) + testinfo.standardinput.size() + testinfo.standardoutput.size() +
+                 testinfo.personaloutput.size() + testinfo.standardinputhash.size() +
+                 testinfo.standardoutputhash.size() + testinfo.personaloutputhash.size();
+    }
+    return bytes;
+}
+
+// 计算缓存键
+string VerdictCache::GetKey(const Json::Value &taskjson) {
+    string problemid = taskjson["ProblemId"].asString();
+    // 题目数据更新时会重新创建数据目录，目录的修改时间随之改变，旧的缓存项不会再被命中
+    long long version = TestDataCache::GetVersion(problemid);
+    if (version < 0) {
+        return "";
+    }
+    Sha256 sha;
+    // 各字段之间以 '\0' 分隔，避免拼接后产生歧义（数值字段按 Json 文本参与计算）
+    sha.Update(problemid).Update("", 1);
+    sha.Update(to_string(version)).Update("", 1);
+    sha.Update(taskjson["Language"].asString()).Update("", 1);
+    for (const char *field : {"JudgeNum", "JudgeMode", "CompareMode", "CompareEpsilon", "TimeLimit", "MemoryLimit",
+                              "OutputLimit"}) {
+        sha.Update(taskjson[field].toStyledString()).Update("", 1);
+    }
+    sha.Update(taskjson["Code"].asString());
+    return sha.HexDigest();
+}
+
+// 是否启用
+bool VerdictCache::IsEnabled() {
+    return enabled.load();
+}
+
+// 启用或关闭
+void VerdictCache::SetEnabled(bool enable) {
+    enabled = enable;
+    if (!enable) {
+        lock_guard<mutex> lock(cache_mutex);
+        entries.clear();
+        lru.clear();
+        total_bytes = 0;
+    }
+}
+
+// 查找判题结果
+shared_ptr<const JudgeResult> VerdictCache::Get(const string &key) {
+    if (!enabled || key.empty()) {
+        return nullptr;
+    }
+    lock_guard<mutex> lock(cache_mutex);
+    auto iter = entries.find(key);
+    if (iter == entries.end()) {
+        miss_num++;
+        return nullptr;
+    }
+    // 移动到 LRU 链表头部
+    lru.splice(lru.begin(), lru, iter->second.iter);
+    hit_num++;
+    saved_ns += iter->second.judgens;
+    return iter->second.result;
+}
+
+// 保存判题结果
+void VerdictCache::Store(const string &key, const JudgeResult &result, long long judgens) {
+    // 系统错误与提交的代码无关，不缓存
+    if (!enabled || key.empty() || result.status == constants::judge::STATUS_SYSTEM_ERROR ||
+        result.status == constants::judge::STATUS_PENDING_JUDGING) {
+        return;
+    }
+    // 复用时测评记录 ID 和判题阶段耗时由新的提交决定，缓存中不保存
+    auto cached = make_shared<JudgeResult>(result);
+    cached->statusrecordid.clear();
+    cached->trace.clear();
+    cached->tracecases.clear();
+    long long bytes = EstimateBytes(*cached) + key.size();
+    if (bytes > constants::judge::VERDICT_CACHE_MAX_BYTES) {
+        return;
+    }
+
+    lock_guard<mutex> lock(cache_mutex);
+    auto iter = entries.find(key);
+    if (iter != entries.end()) {
+        total_bytes -= iter->second.bytes;
+        lru.erase(iter->second.iter);
+        entries.erase(iter);
+    }
+    lru.push_front(key);
+    entries[key] = {cached, judgens, bytes, lru.begin()};
+    total_bytes += bytes;
+    store_num++;
+    // 超出上限时按最近最少使用的顺序淘汰
+    while (total_bytes > constants::judge::VERDICT_CACHE_MAX_BYTES && !lru.empty()) {
+        auto victim = entries.find(lru.back());
+        total_bytes -= victim->second.bytes;
+        entries.erase(victim);
+        lru.pop_back();
+    }
+}
+
+// 获取判题结果复用的运行状态
+Json::Value VerdictCache::GetStats() {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(cache_mutex);
+        resjson["EntryNum"] = (Json::UInt64)entries.size();
+        resjson["TotalBytes"] = (Json::Int64)total_bytes;
+    }
+    resjson["Enabled"] = enabled.load();
+    resjson["MaxBytes"] = (Json::Int64)constants::judge::VERDICT_CACHE_MAX_BYTES;
+    resjson["HitNum"] = (Json::Int64)hit_num.load();
+    resjson["MissNum"] = (Json::Int64)miss_num.load();
+    resjson["StoreNum"] = (Json::Int64)store_num.load();
+    resjson["SavedMs"] = (Json::Int64)(saved_ns.load() / 1000000);
+    return resjson;
+}
+
+VerdictCache::VerdictCache()
+    : total_bytes(0),
+      enabled(constants::judge::VERDICT_CACHE_ENABLED),
+      hit_num(0),
+      miss_num(0),
+      store_num(0),
+      saved_ns(0) {
+    // 构造函数实现
+}
+
+VerdictCache::~VerdictCache() {
+    // 析构函数实现
+}
@@ -0,0 +1,194 @@
+#include "judger/workspace_pool.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <linux/magic.h>
+#include <sys/mount.h>
+#include <sys/stat.h>
+#include <sys/statfs.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+
+#include "constants/judge.h"
+
+using namespace std;
+
+// 距离 start 经过的纳秒数
+static long long ElapsedNs(chrono::steady_clock::time_point start) {
+    return chrono::duration_cast<chrono::nanoseconds>(chrono::steady_clock::now() - start).count();
+}
+
+// 删除目录下的全部内容（不删除目录本身），返回删除的文件总字节数
+static long long RemoveDirContents(int dirfd) {
+    long long bytes = 0;
+    // fdopendir 会接管传入的文件描述符，这里使用一个新打开的描述符，保留调用方的 dirfd
+    int readfd = openat(dirfd, ".", O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (readfd < 0) {
+        return bytes;
+    }
+    DIR *dir = fdopendir(readfd);
+    if (dir == nullptr) {
+        close(readfd);
+        return bytes;
+    }
+    // 先读取全部目录项再删除，避免边遍历边删除
+    vector<string> names;
+    while (struct dirent *entry = readdir(dir)) {
+        if (strcmp(entry->d_name, ".") != 0 && strcmp(entry->d_name, "..") != 0) {
+            names.push_back(entry->d_name);
+        }
+    }
+    closedir(dir);
+
+    for (auto &name : names) {
+        struct stat st;
+        if (fstatat(dirfd, name.data(), &st, AT_SYMLINK_NOFOLLOW) != 0) {
+            continue;
+        }
+        if (S_ISDIR(st.st_mode)) {
+            int subfd = openat(dirfd, name.data(), O_RDONLY | O_DIRECTORY | O_NOFOLLOW | O_CLOEXEC);
+            if (subfd >= 0) {
+                bytes += RemoveDirContents(subfd);
+                close(subfd);
+            }
+            unlinkat(dirfd, name.data(), AT_REMOVEDIR);
+        } else {
+            bytes += st.st_size;
+            unlinkat(dirfd, name.data(), 0);
+        }
+    }
+    return bytes;
+}
+
+// 局部静态特性的方式实现单实例模式
+WorkspacePool *WorkspacePool::GetInstance() {
+    static WorkspacePool workspace_pool;
+    return &workspace_pool;
+}
+
+// 初始化单个槽位
+bool WorkspacePool::InitSlot(const string &path) {
+    if (mkdir(path.data(), 0755) != 0 && errno != EEXIST) {
+        return false;
+    }
+    struct statfs fs;
+    bool tmpfs = statfs(path.data(), &fs) == 0 && fs.f_type == TMPFS_MAGIC;
+    // 槽位本身是挂载点时才有独立的大小（上次运行时挂载的），位于上级目录的 tmpfs 中时上限不生效
+    struct stat st, parent;
+    bool mounted = tmpfs && stat(path.data(), &st) == 0 && stat((path + "/..").data(), &parent) == 0 &&
+                   st.st_dev != parent.st_dev;
+    if (!mounted && constants::judge::WORKSPACE_USE_TMPFS) {
+        // 每个槽位单独挂载 tmpfs，挂载大小即为槽位的大小上限，写满后程序会收到 ENOSPC
+        string options = "size=" + to_string(constants::judge::WORKSPACE_SLOT_QUOTA_BYTES) + ",mode=0755";
+        if (mount("tmpfs", path.data(), "tmpfs", MS_NOSUID | MS_NODEV, options.data()) == 0) {
+            tmpfs = mounted = true;
+        }
+    }
+    is_tmpfs = is_tmpfs && tmpfs;
+    quota_enforced = quota_enforced && mounted;
+
+    int dirfd = open(path.data(), O_RDONLY | O_DIRECTORY | O_CLOEXEC);
+    if (dirfd < 0) {
+        return false;
+    }
+    // 清空上次运行残留的文件
+    RemoveDirContents(dirfd);
+    slots.push_back({path + "/", dirfd});
+    return true;
+}
+
+// 签出一个工作区槽位
+int WorkspacePool::Acquire() {
+    auto start = chrono::steady_clock::now();
+    unique_lock<mutex> lock(pool_mutex);
+    if (slots.empty()) {
+        return -1;
+    }
+    pool_cond.wait(lock, [this] { return !free_slots.empty(); });
+    int slot = free_slots.back();
+    free_slots.pop_back();
+    lock.unlock();
+
+    checkout_num++;
+    checkout_ns += ElapsedNs(start);
+    return slot;
+}
+
+// 获取槽位路径
+string WorkspacePool::GetPath(int slot) {
+    return slots[slot].path;
+}
+
+// 清空并归还工作区槽位
+void WorkspacePool::Release(int slot) {
+    if (slot < 0 || slot >= (int)slots.size()) {
+        return;
+    }
+    auto start = chrono::steady_clock::now();
+    long long bytes = RemoveDirContents(slots[slot].dirfd);
+    clean_ns += ElapsedNs(start);
+    if (bytes > constants::judge::WORKSPACE_SLOT_QUOTA_BYTES) {
+        overquota_num++;
+    }
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        free_slots.push_back(slot);
+    }
+    pool_cond.notify_one();
+}
+
+// 获取工作区池的运行状态
+Json::Value WorkspacePool::GetStats() {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(pool_mutex);
+        resjson["FreeNum"] = (Json::UInt64)free_slots.size();
+    }
+    long long checkouts = checkout_num.load();
+    resjson["SlotNum"] = (Json::UInt64)slots.size();
+    resjson["IsTmpfs"] = is_tmpfs;
+    resjson["QuotaEnforced"] = quota_enforced;
+    resjson["QuotaBytes"] = (Json::Int64)constants::judge::WORKSPACE_SLOT_QUOTA_BYTES;
+    resjson["CheckoutNum"] = (Json::Int64)checkouts;
+    resjson["AvgCheckoutUs"] = checkouts > 0 ? checkout_ns.load() / checkouts / 1000.0 : 0.0;
+    resjson["AvgCleanUs"] = checkouts > 0 ? clean_ns.load() / checkouts / 1000.0 : 0.0;
+    resjson["OverQuotaNum"] = (Json::Int64)overquota_num.load();
+    return resjson;
+}
+
+WorkspacePool::WorkspacePool()
+    : is_tmpfs(true), quota_enforced(true), checkout_num(0), checkout_ns(0), clean_ns(0), overquota_num(0) {
+    // 构造函数实现
+    string root = constants::judge::RUN_PATH_PREFIX;
+    mkdir(root.data(), 0755);
+
+    for (int i = 0; i < constants::judge::WORKSPACE_SLOT_COUNT; i++) {
+        string path = root + "slot" + to_string(i);
+        if (!InitSlot(path)) {
+            cerr << "[ERROR] Failed to init judge workspace " << path << endl;
+            continue;
+        }
+        free_slots.push_back(slots.size() - 1);
+    }
+    if (slots.empty()) {
+        is_tmpfs = false;
+        quota_enforced = false;
+    }
+    cout << "Judge workspace: " << slots.size() << " slots" << (is_tmpfs ? " on tmpfs" : " on disk") << endl;
+    if (!quota_enforced) {
+        cerr << "[WARN] Judge workspace slots are not separate tmpfs mounts, the "
+             << constants::judge::WORKSPACE_SLOT_QUOTA_BYTES << "-byte slot quota is only counted in OverQuotaNum"
+             << endl;
+    }
+}
+
+WorkspacePool::~WorkspacePool() {
+    // 析构函数实现
+    for (auto &slot : slots) {
+        close(slot.dirfd);
+    }
+}
@@ -0,0 +1,323 @@
+#include "judger/zygote.h"
+
+#include <dlfcn.h>
+#include <fcntl.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/resource.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <unistd.h>
+
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+
+#include "constants/judge.h"
+
+using namespace std;
+
+// zygote 程序（兼容 Python2 和 Python3）
+// 启动后通过描述符 3 接收测试用例，每个测试用例 fork 一个子进程，父进程等待子进程结束后上报运行时间和内存；
+// 子进程按沙箱的顺序设置资源限制、重定向标准输入输出、加载 seccomp 规则，然后从 serve 返回，
+// 像冷启动的解释器一样以 __main__ 运行字节码文件，并按解释器退出时的顺序处理退出码、异常、atexit 和输出缓冲。
+// 子进程最后直接 _exit 而不做完整的解释器清理：清理会修改从 zygote 继承的所有对象，写时复制的开销比冷启动还大
+static const char *ZYGOTE_SOURCE = R"(import atexit
+import ctypes
+import os
+import pkgutil
+import resource
+import runpy
+import signal
+import sys
+import time
+
+
+class Config(ctypes.Structure):
+    _fields_ = [('max_cpu_time', ctypes.c_int), ('max_real_time', ctypes.c_int), ('max_memory', ctypes.c_long),
+                ('max_stack', ctypes.c_long), ('max_process_number', ctypes.c_int),
+                ('max_output_size', ctypes.c_long), ('memory_limit_check_only', ctypes.c_int),
+                ('exe_path', ctypes.c_char_p), ('input_path', ctypes.c_char_p), ('output_path', ctypes.c_char_p),
+                ('error_path', ctypes.c_char_p), ('args', ctypes.c_char_p * 256), ('env', ctypes.c_char_p * 256),
+                ('log_path', ctypes.c_char_p), ('seccomp_rule_name', ctypes.c_char_p), ('uid', ctypes.c_uint),
+                ('gid', ctypes.c_uint)]
+
+
+def limit(which, value):
+    if value >= 0:
+        resource.setrlimit(which, (value, value))
+
+
+def prepare(fields, rule):
+    cpu, memory, output, checkonly = [int(value) for value in fields[:4]]
+    if checkonly == 0 and memory >= 0:
+        limit(resource.RLIMIT_AS, memory * 2)
+    if cpu >= 0:
+        limit(resource.RLIMIT_CPU, (cpu + 1000) // 1000)
+    limit(resource.RLIMIT_FSIZE, output)
+    truncate = os.O_WRONLY | os.O_CREAT | os.O_TRUNC
+    for fd, path, flags in ((0, fields[4], os.O_RDONLY), (1, fields[5], truncate), (2, fields[6], truncate)):
+        if path:
+            newfd = os.open(path, flags, 0o666)
+            os.dup2(newfd, fd)
+            os.close(newfd)
+    os.close(3)
+    if rule is not None:
+        config = Config()
+        config.exe_path = sys.executable.encode()
+        if rule(ctypes.byref(config)) != 0:
+            os.kill(os.getpid(), signal.SIGUSR1)
+
+
+def serve():
+    rule = None
+    if sys.argv[2]:
+        rule = getattr(ctypes.CDLL(sys.argv[1]), sys.argv[2] + '_seccomp_rules')
+    os.write(3, b'O\n')
+    buffer = b''
+    while True:
+        while b'\n' not in buffer:
+            data = os.read(3, 65536)
+            if not data:
+                os._exit(0)
+            buffer += data
+        request, buffer = buffer.split(b'\n', 1)
+        start = time.time()
+        pid = os.fork()
+        if pid == 0:
+            prepare(request.decode('utf-8').split('\t'), rule)
+            return
+        os.write(3, ('P %d\n' % pid).encode())
+        status, usage = os.wait4(pid, 0)[1:]
+        real = int((time.time() - start) * 1000)
+        os.write(3, ('R %d %d %d %d\n' % (status, int(usage.ru_utime * 1000), usage.ru_maxrss, real)).encode())
+
+
+def execute():
+    try:
+        runpy.run_path(sys.argv[0], run_name='__main__')
+        code = 0
+    except SystemExit as e:
+        code = e.code
+    except BaseException:
+        sys.excepthook(*sys.exc_info())
+        code = 1
+    if code is None:
+        code = 0
+    elif not isinstance(code, int):
+        sys.stderr.write('%s\n' % code)
+        code = 1
+    atexit._run_exitfuncs()
+    try:
+        sys.stdout.flush()
+    except Exception:
+        code = 120
+    try:
+        sys.stderr.flush()
+    except Exception:
+        pass
+    os._exit(code & 0xff)
+
+
+serve()
+sys.argv = sys.argv[3:]
+sys.path[0] = os.path.dirname(os.path.abspath(sys.argv[0]))
+execute()
+)";
+
+// 设置资源限制（value 为 UNLIMITED 时不设置）
+static bool SetLimit(int resource, long value) {
+    if (value == UNLIMITED) {
+        return true;
+    }
+    struct rlimit limit;
+    limit.rlim_cur = limit.rlim_max = (rlim_t)value;
+    return setrlimit(resource, &limit) == 0;
+}
+
+// 启动 zygote 进程
+bool Zygote::Start(const struct config *conf) {
+    // zygote 中的子进程通过沙箱库加载 seccomp 规则，保证与冷启动时的规则完全一致
+    Dl_info info;
+    if (dladdr((void *)&run, &info) == 0 || info.dli_fname == nullptr) {
+        return false;
+    }
+    string libjudger = info.dli_fname;
+    string rulename = conf->seccomp_rule_name != nullptr ? conf->seccomp_rule_name : "";
+    string program = conf->args[1];
+
+    // fork 之后只能调用异步信号安全的函数，参数在 fork 之前准备好
+    vector<char *> argv = {conf->args[0], (char *)"-c", (char *)ZYGOTE_SOURCE,
+                           (char *)libjudger.data(), (char *)rulename.data(), (char *)program.data(), nullptr};
+    vector<char *> envp;
+    for (int i = 0; i < ENV_MAX_NUMBER && conf->env[i] != nullptr; i++) {
+        envp.push_back(conf->env[i]);
+    }
+    envp.push_back(nullptr);
+
+    int fds[2];
+    if (socketpair(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0, fds) != 0) {
+        return false;
+    }
+    pid_t pid = fork();
+    if (pid < 0) {
+        close(fds[0]);
+        close(fds[1]);
+        return false;
+    }
+    if (pid == 0) {
+        // zygote 和它 fork 出的子进程使用独立的进程组，停止时一并杀死
+        setpgid(0, 0);
+        int nullfd = open("/dev/null", O_RDWR);
+        if (nullfd < 0 || dup2(nullfd, 0) < 0 || dup2(nullfd, 1) < 0 || dup2(nullfd, 2) < 0) {
+            _exit(127);
+        }
+        // 通信套接字固定为描述符 3（dup2 会清除 close-on-exec 标志）
+        if (fds[1] == 3 ? fcntl(3, F_SETFD, 0) < 0 : dup2(fds[1], 3) < 0) {
+            _exit(127);
+        }
+        if (!SetLimit(RLIMIT_STACK, conf->max_stack) || !SetLimit(RLIMIT_NPROC, conf->max_process_number)) {
+            _exit(127);
+        }
+        if (setgid(conf->gid) != 0 || setuid(conf->uid) != 0) {
+            _exit(127);
+        }
+        execve(conf->exe_path, argv.data(), envp.data());
+        _exit(127);
+    }
+    setpgid(pid, pid);
+    close(fds[1]);
+    pid_ = pid;
+    fd_ = fds[0];
+    buffer_.clear();
+
+    // 等待解释器完成启动
+    string line;
+    if (!ReadLine(line, constants::judge::ZYGOTE_START_TIMEOUT) || line != "O") {
+        Stop();
+        return false;
+    }
+    return true;
+}
+
+// 运行单个测试用例
+bool Zygote::Run(const struct config *conf, struct result *res) {
+    if (pid_ <= 0) {
+        return false;
+    }
+    string request = to_string(conf->max_cpu_time) + "\t" + to_string(conf->max_memory) + "\t" +
+                     to_string(conf->max_output_size) + "\t" + to_string(conf->memory_limit_check_only) + "\t" +
+                     conf->input_path + "\t" + conf->output_path + "\t" + conf->error_path + "\n";
+    for (size_t sent = 0; sent < request.size();) {
+        ssize_t len = send(fd_, request.data() + sent, request.size() - sent, MSG_NOSIGNAL);
+        if (len <= 0) {
+            Stop();
+            return false;
+        }
+        sent += len;
+    }
+
+    string line;
+    pid_t child;
+    if (!ReadLine(line, constants::judge::ZYGOTE_START_TIMEOUT) || sscanf(line.data(), "P %d", &child) != 1) {
+        Stop();
+        return false;
+    }
+    // 与沙箱一样，超出实际运行时间限制后杀死子进程
+    if (!ReadLine(line, conf->max_real_time)) {
+        kill(child, SIGKILL);
+        if (pid_ <= 0 || !ReadLine(line, -1)) {
+            Stop();
+            return false;
+        }
+    }
+    int status, cputime, realtime;
+    long maxrss;
+    if (sscanf(line.data(), "R %d %d %ld %d", &status, &cputime, &maxrss, &realtime) != 4) {
+        Stop();
+        return false;
+    }
+
+    // 按沙箱的规则判定运行结果
+    *res = {};
+    res->real_time = realtime;
+    if (WIFSIGNALED(status)) {
+        res->signal = WTERMSIG(status);
+    }
+    if (res->signal == SIGUSR1) {
+        res->result = SYSTEM_ERROR;
+        return true;
+    }
+    res->exit_code = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+    res->cpu_time = cputime;
+    res->memory = maxrss * 1024;
+    if (res->exit_code != 0) {
+        res->result = RUNTIME_ERROR;
+    }
+    if (res->signal == SIGSEGV) {
+        bool exceeded = conf->max_memory != UNLIMITED && res->memory > conf->max_memory;
+        res->result = exceeded ? MEMORY_LIMIT_EXCEEDED : RUNTIME_ERROR;
+    } else {
+        if (res->signal != 0) {
+            res->result = RUNTIME_ERROR;
+        }
+        if (conf->max_memory != UNLIMITED && res->memory > conf->max_memory) {
+            res->result = MEMORY_LIMIT_EXCEEDED;
+        }
+        if (conf->max_real_time != UNLIMITED && res->real_time > conf->max_real_time) {
+            res->result = REAL_TIME_LIMIT_EXCEEDED;
+        }
+        if (conf->max_cpu_time != UNLIMITED && res->cpu_time > conf->max_cpu_time) {
+            res->result = CPU_TIME_LIMIT_EXCEEDED;
+        }
+    }
+    return true;
+}
+
+// 读取 zygote 上报的一行
+bool Zygote::ReadLine(string &line, int timeout) {
+    size_t pos;
+    while ((pos = buffer_.find('\n')) == string::npos) {
+        struct pollfd pfd = {fd_, POLLIN, 0};
+        int ready = poll(&pfd, 1, timeout);
+        if (ready < 0 && errno == EINTR) {
+            continue;
+        }
+        if (ready <= 0) {
+            return false;
+        }
+        char buf[256];
+        ssize_t len = read(fd_, buf, sizeof(buf));
+        if (len <= 0) {
+            Stop();
+            return false;
+        }
+        buffer_.append(buf, len);
+    }
+    line = buffer_.substr(0, pos);
+    buffer_.erase(0, pos + 1);
+    return true;
+}
+
+// 停止 zygote 进程
+void Zygote::Stop() {
+    if (pid_ <= 0) {
+        return;
+    }
+    // 杀死整个进程组，包括可能仍在运行的测试用例子进程
+    close(fd_);
+    kill(-pid_, SIGKILL);
+    waitpid(pid_, nullptr, 0);
+    pid_ = -1;
+    fd_ = -1;
+}
+
+Zygote::Zygote() : pid_(-1), fd_(-1) {
+    // 构造函数实现
+}
+
+Zygote::~Zygote() {
+    // 析构函数实现
+    Stop();
+}
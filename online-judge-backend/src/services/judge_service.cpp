@@ -0,0 +1,477 @@
+#include "services/judge_service.h"
+
+#include <chrono>
+#include <iostream>
+#include <map>
+
+#include "constants/judge.h"
+#include "judger/case_memo.h"
+#include "judger/cgroup_pool.h"
+#include "judger/compile_cache.h"
+#include "judger/compile_governor.h"
+#include "judger/judge_trace.h"
+#include "judger/jvm_cds.h"
+#include "judger/launcher_pool.h"
+#include "judger/pch_cache.h"
+#include "judger/spj_cache.h"
+#include "judger/testdata_cache.h"
+#include "judger/testdata_store.h"
+#include "judger/verdict_cache.h"
+#include "judger/workspace_pool.h"
+#include "services/problem_service.h"
+#include "services/status_record_service.h"
+#include "services/user_service.h"
+#include "utils/response.h"
+
+using namespace std;
+
+// 局部静态特性的方式实现单实例模式
+JudgeService *JudgeService::GetInstance() {
+    static JudgeService judge_service;
+    return &judge_service;
+}
+
+// 判题队列是否已满
+bool JudgeService::IsQueueFull() {
+    lock_guard<mutex> lock(queue_mutex);
+    return task_queue.size() >= static_cast<size_t>(constants::judge::JUDGE_QUEUE_CAPACITY);
+}
+
+// 记录一次因队列已满被拒绝的提交
+void JudgeService::RecordRejected() {
+    rejected_num++;
+}
+
+// 将判题任务加入判题队列
+bool JudgeService::PushTask(Json::Value &taskjson) {
+    // 相同代码在测试数据和评测参数未变化时直接复用判题结果，不进入判题队列
+    if (VerdictCache::GetInstance()->IsEnabled()) {
+        string key = VerdictCache::GetKey(taskjson);
+        shared_ptr<const JudgeResult> cached = VerdictCache::GetInstance()->Get(key);
+        if (cached != nullptr) {
+            JudgeResult result = *cached;
+            result.statusrecordid = taskjson["StatusRecordId"].asString();
+            FinishTask(taskjson, result, nullptr);
+            reused_num++;
+            return true;
+        }
+        // 判题完成后以该键保存结果
+        taskjson["VerdictKey"] = key;
+    }
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        if (stopping || task_queue.size() >= static_cast<size_t>(constants::judge::JUDGE_QUEUE_CAPACITY)) {
+            rejected_num++;
+            return false;
+        }
+        taskjson["EnqueueTime"] = (Json::Int64)JudgeTrace::Now();
+        task_queue.push_back(taskjson);
+    }
+    queue_cond.notify_one();
+    return true;
+}
+
+// 获取判题服务的运行状态
+Json::Value JudgeService::GetJudgeStats(const string &problemid) {
+    Json::Value resjson;
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        resjson["QueueLength"] = (Json::UInt64)task_queue.size();
+    }
+    {
+        lock_guard<mutex> lock(run_mutex);
+        resjson["RunQueueLength"] = (Json::UInt64)run_queue.size();
+    }
+    resjson["WorkerNum"] = constants::judge::JUDGE_WORKER_COUNT;
+    resjson["CompileWorkerNum"] = constants::judge::COMPILE_WORKER_COUNT;
+    resjson["QueueCapacity"] = constants::judge::JUDGE_QUEUE_CAPACITY;
+    resjson["RunQueueCapacity"] = constants::judge::COMPILE_RUN_QUEUE_CAPACITY;
+    resjson["CompilingNum"] = compiling_num.load();
+    resjson["RunningNum"] = running_num.load();
+    resjson["FinishedNum"] = (Json::Int64)finished_num.load();
+    resjson["RejectedNum"] = (Json::Int64)rejected_num.load();
+    resjson["ReusedNum"] = (Json::Int64)reused_num.load();
+    resjson["CompileGovernor"] = CompileGovernor::GetInstance()->GetStats();
+    resjson["CompileCache"] = CompileCache::GetInstance()->GetStats();
+    resjson["Workspace"] = WorkspacePool::GetInstance()->GetStats();
+    resjson["TestDataCache"] = TestDataCache::GetInstance()->GetStats();
+    resjson["TestDataStore"] = TestDataStore::GetInstance()->GetStats();
+    resjson["SpjCache"] = SpjCache::GetInstance()->GetStats();
+    resjson["PchCache"] = PchCache::GetInstance()->GetStats();
+    resjson["JvmCds"] = JvmCds::GetInstance()->GetStats();
+    resjson["Launcher"] = LauncherPool::GetInstance()->GetStats();
+    resjson["Cgroup"] = CgroupPool::GetInstance()->GetStats();
+    resjson["Trace"] = JudgeTraceStats::GetInstance()->GetStats(problemid);
+    resjson["VerdictCache"] = VerdictCache::GetInstance()->GetStats();
+    resjson["CaseMemo"] = CaseMemo::GetInstance()->GetStats();
+    {
+        lock_guard<mutex> lock(rejudge_mutex);
+        resjson["Rejudge"]["QueueLength"] = (Json::UInt64)rejudge_queue.size();
+        resjson["Rejudge"]["PendingNum"] = (Json::UInt64)rejudge_records.size();
+    }
+    resjson["Rejudge"]["FinishedNum"] = (Json::Int64)rejudged_num.load();
+    return resjson;
+}
+
+// 启用或关闭判题结果复用
+Json::Value JudgeService::UpdateVerdictCache(Json::Value &updatejson) {
+    if (!updatejson["Enabled"].isBool()) {
+        return response::BadRequest("Enabled 必须为布尔值");
+    }
+    VerdictCache::GetInstance()->SetEnabled(updatejson["Enabled"].asBool());
+    return response::Success("设置成功", VerdictCache::GetInstance()->GetStats());
+}
+
+// 重新评测
+Json::Value JudgeService::Rejudge(Json::Value &queryjson) {
+    bool hasfilter = false;
+    for (const char *field : {"ProblemId", "UserId", "StartTime", "EndTime"}) {
+        hasfilter = hasfilter || queryjson[field].asString().size() > 0;
+    }
+    if (!hasfilter) {
+        return response::BadRequest("ProblemId、UserId、StartTime 和 EndTime 至少指定一项");
+    }
+
+    // 查询需要重新评测的测评记录
+    Json::Value recordsjson = StatusRecordService::GetInstance()->SelectRejudgeRecords(queryjson);
+    if (!recordsjson["success"].asBool()) {
+        return recordsjson;
+    }
+    const Json::Value &records = recordsjson["data"]["List"];
+
+    // 按题目当前的评测参数构造判题任务，同一题目只查询一次
+    map<string, Json::Value> problems;
+    vector<Json::Value> tasks;
+    int skippednum = 0;
+    for (const Json::Value &record : records) {
+        string problemid = record["ProblemId"].asString();
+        auto iter = problems.find(problemid);
+        if (iter == problems.end()) {
+            Json::Value problemjson;
+            problemjson["ProblemId"] = problemid;
+            iter = problems.emplace(problemid, ProblemService::GetInstance()->SelectProblemInfo(problemjson)).first;
+        }
+        // 题目已被删除的测评记录不再重新评测
+        if (!iter->second["success"].asBool()) {
+            skippednum++;
+            continue;
+        }
+        const Json::Value &problem = iter->second["data"];
+        Json::Value taskjson;
+        taskjson["Code"] = record["Code"];
+        taskjson["StatusRecordId"] = record["_id"].asString();
+        taskjson["ProblemId"] = problemid;
+        taskjson["UserId"] = record["UserId"].asString();
+        taskjson["Language"] = record["Language"];
+        taskjson["JudgeNum"] = problem["JudgeNum"];
+        taskjson["JudgeMode"] = problem["JudgeMode"];
+        taskjson["CompareMode"] = problem["CompareMode"];
+        taskjson["CompareEpsilon"] = problem["CompareEpsilon"];
+        taskjson["TimeLimit"] = problem["TimeLimit"];
+        taskjson["MemoryLimit"] = problem["MemoryLimit"];
+        taskjson["OutputLimit"] = problem["OutputLimit"];
+        taskjson["Rejudge"] = true;
+        tasks.push_back(std::move(taskjson));
+    }
+
+    // 加入重新评测队列，已在队列中或正在评测的测评记录不重复加入
+    int queuednum = 0;
+    Json::Value data;
+    {
+        lock_guard<mutex> lock(rejudge_mutex);
+        for (Json::Value &taskjson : tasks) {
+            if (!rejudge_records.insert(taskjson["StatusRecordId"].asString()).second) {
+                skippednum++;
+                continue;
+            }
+            rejudge_problems.insert(taskjson["ProblemId"].asString());
+            rejudge_userprobs.insert({taskjson["UserId"].asString(), taskjson["ProblemId"].asString()});
+            rejudge_queue.push_back(std::move(taskjson));
+            queuednum++;
+        }
+        data["PendingNum"] = (Json::UInt64)rejudge_records.size();
+    }
+    rejudge_cond.notify_one();
+
+    data["MatchedNum"] = recordsjson["data"]["Total"];
+    data["QueuedNum"] = queuednum;
+    data["SkippedNum"] = skippednum;
+    return response::Success("已加入重新评测队列", data);
+}
+
+// 编译工作线程的主循环
+void JudgeService::CompileLoop() {
+    while (true) {
+        Json::Value taskjson;
+        {
+            unique_lock<mutex> lock(queue_mutex);
+            queue_cond.wait(lock, [this] { return stopping || !task_queue.empty(); });
+            if (stopping && task_queue.empty()) {
+                return;
+            }
+            taskjson = std::move(task_queue.front());
+            task_queue.pop_front();
+        }
+
+        compiling_num++;
+        try {
+            // 编译代码
+            // Json(StatusRecordId, ProblemId, JudgeNum, JudgeMode, CompareMode, CompareEpsilon, Code, Language,
+            // TimeLimit, MemoryLimit, OutputLimit, EnqueueTime)
+            auto judger = make_unique<Judger>();
+            if (judger->Compile(taskjson)) {
+                // 编译通过，等待运行队列有空位后交给判题工作线程
+                unique_lock<mutex> lock(run_mutex);
+                run_space_cond.wait(lock, [this] {
+                    return run_queue.size() < static_cast<size_t>(constants::judge::COMPILE_RUN_QUEUE_CAPACITY);
+                });
+                run_queue.push_back({std::move(taskjson), std::move(judger), JudgeTrace::Now()});
+                lock.unlock();
+                run_cond.notify_one();
+                compiling_num--;
+                continue;
+            }
+            // 编译错误或系统错误，判题直接结束
+            JudgeResult result = judger->Done();
+            FinishTask(taskjson, result, &judger->GetTrace());
+        } catch (const exception &e) {
+            cerr << "[ERROR] Judge task " << taskjson["StatusRecordId"].asString() << " failed: " << e.what() << endl;
+            // 判题失败的重新评测任务同样计为完成，避免本批的统计信息一直得不到修正
+            if (taskjson["Rejudge"].asBool()) {
+                FinishRejudge(taskjson);
+            }
+        }
+        compiling_num--;
+        finished_num++;
+    }
+}
+
+// 判题工作线程的主循环
+void JudgeService::WorkerLoop() {
+    while (true) {
+        RunTask task;
+        {
+            unique_lock<mutex> lock(run_mutex);
+            run_cond.wait(lock, [this] { return run_stopping || !run_queue.empty(); });
+            if (run_stopping && run_queue.empty()) {
+                return;
+            }
+            task = std::move(run_queue.front());
+            run_queue.pop_front();
+        }
+        run_space_cond.notify_one();
+
+        running_num++;
+        try {
+            // 运行代码
+            task.judger->GetTrace().Add(STAGE_RUN_QUEUE, JudgeTrace::Now() - task.enqueuetime);
+            JudgeResult result = task.judger->Execute();
+            FinishTask(task.taskjson, result, &task.judger->GetTrace());
+        } catch (const exception &e) {
+            cerr << "[ERROR] Judge task " << task.taskjson["StatusRecordId"].asString() << " failed: " << e.what()
+                 << endl;
+            if (task.taskjson["Rejudge"].asBool()) {
+                FinishRejudge(task.taskjson);
+            }
+        }
+        running_num--;
+        finished_num++;
+    }
+}
+
+// 重新评测送入线程的主循环
+void JudgeService::RejudgeLoop() {
+    const auto interval = chrono::milliseconds(constants::judge::REJUDGE_INTERVAL_MS);
+    while (true) {
+        Json::Value taskjson;
+        {
+            unique_lock<mutex> lock(rejudge_mutex);
+            rejudge_cond.wait(lock, [this] { return rejudge_stopping || !rejudge_queue.empty(); });
+            if (rejudge_stopping) {
+                return;
+            }
+            taskjson = std::move(rejudge_queue.front());
+            rejudge_queue.pop_front();
+        }
+
+        // 重新评测不查找判题结果复用（由测试用例结果记忆跳过未变化的测试用例），但判题结果同样保存供之后的提交复用
+        if (VerdictCache::GetInstance()->IsEnabled()) {
+            taskjson["VerdictKey"] = VerdictCache::GetKey(taskjson);
+        }
+        // 判题队列中的任务较多时等待，优先评测正常的提交
+        while (true) {
+            {
+                lock_guard<mutex> lock(queue_mutex);
+                if (task_queue.size() < static_cast<size_t>(constants::judge::REJUDGE_MAX_QUEUED)) {
+                    taskjson["EnqueueTime"] = (Json::Int64)JudgeTrace::Now();
+                    task_queue.push_back(std::move(taskjson));
+                    break;
+                }
+            }
+            unique_lock<mutex> lock(rejudge_mutex);
+            if (rejudge_cond.wait_for(lock, interval, [this] { return rejudge_stopping; })) {
+                return;
+            }
+        }
+        queue_cond.notify_one();
+
+        // 相邻两次送入之间至少间隔 REJUDGE_INTERVAL_MS
+        unique_lock<mutex> lock(rejudge_mutex);
+        if (rejudge_cond.wait_for(lock, interval, [this] { return rejudge_stopping; })) {
+            return;
+        }
+    }
+}
+
+// 完成一个重新评测任务
+void JudgeService::FinishRejudge(const Json::Value &taskjson) {
+    rejudged_num++;
+    Json::Value problemjson, userjson;
+    {
+        lock_guard<mutex> lock(rejudge_mutex);
+        rejudge_records.erase(taskjson["StatusRecordId"].asString());
+        // 本批还有未完成的任务时暂不修正统计信息
+        if (!rejudge_records.empty()) {
+            return;
+        }
+        for (const string &problemid : rejudge_problems) {
+            problemjson["ProblemIds"].append(problemid);
+        }
+        for (const auto &userprob : rejudge_userprobs) {
+            Json::Value item;
+            item["UserId"] = userprob.first;
+            item["ProblemId"] = userprob.second;
+            userjson["List"].append(item);
+        }
+        rejudge_problems.clear();
+        rejudge_userprobs.clear();
+    }
+
+    /**
+     * 按测评记录重新统计题目状态
+     * 传入：Json(ProblemIds)
+     * 传出：bool
+     */
+    ProblemService::GetInstance()->RecountProblemStatusNum(problemjson);
+
+    /**
+     * 按测评记录修正用户题目状态
+     * 传入：Json(List[{UserId, ProblemId}])
+     * 传出：bool
+     */
+    UserService::GetInstance()->RecountUserProblemInfo(userjson);
+}
+
+// 根据判题结果更新测评记录、题目和用户的状态信息，并记录判题阶段耗时和保存判题结果
+void JudgeService::FinishTask(Json::Value &taskjson, const JudgeResult &result, JudgeTrace *trace) {
+    /**
+     * 更新测评记录
+     * 传入：JudgeResult
+     * 传出：bool
+     */
+    long long start = JudgeTrace::Now();
+    StatusRecordService::GetInstance()->UpdateStatusRecord(result);
+    long long recordns = JudgeTrace::Now() - start;
+
+    // 重新评测不逐个增减统计信息，一批任务全部完成后按测评记录批量修正
+    if (taskjson["Rejudge"].asBool()) {
+        FinishRejudge(taskjson);
+    } else {
+        /**
+         * 更新题目状态
+         * 传入：Json(ProblemId, Status)
+         * 传出：bool
+         */
+        Json::Value updatejson;
+        updatejson["ProblemId"] = taskjson["ProblemId"];
+        updatejson["Status"] = result.status;
+        ProblemService::GetInstance()->UpdateProblemStatusNum(updatejson);
+
+        /**
+         * 更新用户题目状态
+         * 传入：Json(UserId, ProblemId, Status)
+         * 传出：bool （是否为该题目的第一次 AC）
+         */
+        updatejson["UserId"] = taskjson["UserId"];
+        UserService::GetInstance()->UpdateUserProblemInfo(updatejson);
+    }
+
+    // 复用的判题结果没有经过判题，不计入判题阶段耗时统计
+    if (trace == nullptr) {
+        return;
+    }
+    // 更新统计信息的耗时和从入队开始的总耗时只计入直方图
+    long long end = JudgeTrace::Now();
+    trace->Add(STAGE_RECORD, recordns);
+    trace->Add(STAGE_STATISTICS, end - start - recordns);
+    trace->Add(STAGE_TOTAL, end - taskjson["EnqueueTime"].asInt64());
+    JudgeTraceStats::GetInstance()->Record(taskjson["Language"].asString(), taskjson["ProblemId"].asString(), *trace);
+
+    // 保存判题结果供相同的提交复用，命中时节省的是签出工作区到运行结束的耗时
+    long long judgens = trace->Get(STAGE_WORKSPACE) + trace->Get(STAGE_SOURCE) + trace->Get(STAGE_SPJ) +
+                        trace->Get(STAGE_COMPILE) + trace->Get(STAGE_EXECUTE);
+    VerdictCache::GetInstance()->Store(taskjson["VerdictKey"].asString(), result, judgens);
+}
+
+JudgeService::JudgeService()
+    : stopping(false),
+      run_stopping(false),
+      compiling_num(0),
+      running_num(0),
+      finished_num(0),
+      rejected_num(0),
+      reused_num(0),
+      rejudge_stopping(false),
+      rejudged_num(0) {
+    // 构造函数实现
+    // 在后台生成 Java 运行使用的 CDS 归档
+    JvmCds::GetInstance()->Prepare();
+    // 在启动判题工作线程之前启动沙箱启动器，启动器不继承任何评测槽位的 CPU 绑定
+    LauncherPool::GetInstance();
+    // 创建判题使用的 cgroup（未启用或不可用时只记录原因）
+    CgroupPool::GetInstance();
+    // 启动编译工作线程和判题工作线程
+    for (int i = 0; i < constants::judge::COMPILE_WORKER_COUNT; i++) {
+        compile_workers.emplace_back(&JudgeService::CompileLoop, this);
+    }
+    for (int i = 0; i < constants::judge::JUDGE_WORKER_COUNT; i++) {
+        workers.emplace_back(&JudgeService::WorkerLoop, this);
+    }
+    // 启动重新评测的送入线程
+    rejudge_feeder = thread(&JudgeService::RejudgeLoop, this);
+}
+
+JudgeService::~JudgeService() {
+    // 析构函数实现
+    // 先停止送入重新评测任务，尚未送入的任务直接丢弃（测评记录保留原来的结果）
+    {
+        lock_guard<mutex> lock(rejudge_mutex);
+        rejudge_stopping = true;
+    }
+    rejudge_cond.notify_all();
+    if (rejudge_feeder.joinable()) {
+        rejudge_feeder.join();
+    }
+    // 等待队列中剩余的判题任务完成后停止工作线程
+    {
+        lock_guard<mutex> lock(queue_mutex);
+        stopping = true;
+    }
+    queue_cond.notify_all();
+    for (auto &worker : compile_workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    // 编译阶段结束后，运行完运行队列中剩余的提交
+    {
+        lock_guard<mutex> lock(run_mutex);
+        run_stopping = true;
+    }
+    run_cond.notify_all();
+    for (auto &worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+}
@@ -4,11 +4,15 @@
 #include <utils/json_utils.h>
 
 #include <fstream>
+#include <sstream>
 
 #include "constants/judge.h"
 #include "db/mongo_database.h"
 #include "db/redis_database.h"
+#include "judger/testdata_cache.h"
+#include "judger/testdata_store.h"
 #include "utils/response.h"
+#include "utils/sha256.hpp"
 
 /**
  * 存储题目数据的路径前缀
@@ -46,6 +50,24 @@ Json::Value ProblemService::SelectProblemInfo(Json::Value &queryjson) {
     return resjson;
 }
 
+// 分页获取测试用例的信息（只包含大小、哈希和预览，不读取完整内容）
+static Json::Value SelectCaseInfo(const string &datapath, const Json::Value &manifest, int page, int pagesize) {
+    Json::Value testinfo(Json::arrayValue);
+    const Json::Value &cases = manifest["Cases"];
+    for (int i = (page - 1) * pagesize; i < (int)cases.size() && i < page * pagesize; i++) {
+        Json::Value caseinfo = cases[i];
+        for (const auto &[field, ext] : {make_pair("Input", ".in"), make_pair("Output", ".out")}) {
+            // 多读几个字节，截取预览时可以判断末尾是否为不完整的 UTF-8 字符
+            string content;
+            TestDataStore::ReadFile(datapath, to_string(i + 1) + ext, 0, constants::judge::TESTINFO_PREVIEW_BYTES + 4,
+                                    content);
+            caseinfo[string(field) + "Preview"] = TestDataStore::Preview(content.data(), content.size());
+        }
+        testinfo.append(caseinfo);
+    }
+    return testinfo;
+}
+
 // 查询题目信息（管理员权限）
 Json::Value ProblemService::SelectProblemInfoByAdmin(Json::Value &queryjson) {
     // 获取基本信息
@@ -56,27 +78,13 @@ Json::Value ProblemService::SelectProblemInfoByAdmin(Json::Value &queryjson) {
     // 获取测试点信息
     Json::Value &data = resjson["data"];
     string problemid = data["_id"].asString();
-    int judgenum = stoi(data["JudgeNum"].asString());
+    // 只解析一次当前的数据版本，读取期间数据被更新也不会混用两个版本的文件
     string DATA_PATH = PROBLEM_DATA_PREFIX + problemid + "/";
-    ifstream infilein, infileout;
-    for (int i = 1; i <= judgenum; i++) {
-        Json::Value jsoninfo;
-        string infilepath = DATA_PATH + to_string(i) + ".in";
-        string outfilepath = DATA_PATH + to_string(i) + ".out";
-
-        infilein.open(infilepath.data());
-        string infile((istreambuf_iterator<char>(infilein)), (istreambuf_iterator<char>()));
-
-        infileout.open(outfilepath.data());
-        string outfile((istreambuf_iterator<char>(infileout)), (istreambuf_iterator<char>()));
-        jsoninfo["Input"] = infile;
-        jsoninfo["Output"] = outfile;
-
-        infilein.close();
-        infileout.close();
-
-        data["TestInfo"].append(jsoninfo);
-    }
+    TestDataStore::Resolve(problemid, DATA_PATH);
+    Json::Value manifest = TestDataStore::LoadManifest(DATA_PATH);
+    data["DataVersion"] = manifest["Version"];
+    // 只返回第一页测试用例的信息，响应大小与测试数据的大小无关，其余页和完整内容通过单独的接口按需获取
+    data["TestInfo"] = SelectCaseInfo(DATA_PATH, manifest, 1, constants::judge::TESTDATA_CASE_PAGE_SIZE);
     // 获取 SPJ 文件
     data["IsSPJ"] = false;
     string spjpath = DATA_PATH + "spj.cpp";
@@ -91,37 +99,67 @@ Json::Value ProblemService::SelectProblemInfoByAdmin(Json::Value &queryjson) {
     return resjson;
 }
 
-// 插入题目测试数据
-bool InsertProblemDataInfo(Json::Value &insertjson) {
-    // 添加测试用例
-    string DATA_PATH = PROBLEM_DATA_PREFIX + insertjson["ProblemId"].asString();
-    string command = "mkdir " + DATA_PATH;
-    // 创建文件夹
-    system(command.data());
+// 将题目数据中的测试用例写入暂存目录（与当前版本内容相同的文件不写入），然后提交为新的数据版本
+static bool CommitProblemDataInfo(Json::Value &datajson, Json::Value &resultjson, string &error) {
+    string problemid = datajson["ProblemId"].asString();
+    TestDataStore *store = TestDataStore::GetInstance();
+    string stagingpath = store->CreateStaging(problemid);
+    if (stagingpath.empty()) {
+        error = "无法创建暂存目录";
+        return false;
+    }
+    const Json::Value manifest = store->GetManifest(problemid);
+    const Json::Value &cases = manifest["Cases"];
+    const Json::Value &testinfo = datajson["TestInfo"];
+    auto stage = [&stagingpath](const string &name, const string &content, const string &curhash) {
+        if (Sha256().Update(content).HexDigest() == curhash) {
+            return true;
+        }
+        ofstream outfile(stagingpath + name, ios::binary);
+        outfile << content;
+        outfile.close();
+        return !outfile.fail();
+    };
     // 添加测试文件
-    for (int i = 1; i <= insertjson["TestInfo"].size(); i++) {
+    bool staged = true;
+    for (int i = 1; staged && i <= (int)testinfo.size(); i++) {
         string index = to_string(i);
-        ofstream outfilein, outfileout;
-        string inpath = DATA_PATH + "/" + index + ".in";
-        string outpath = DATA_PATH + "/" + index + ".out";
+        staged = stage(index + ".in", testinfo[i - 1]["Input"].asString(), cases[i - 1]["InputHash"].asString()) &&
+                 stage(index + ".out", testinfo[i - 1]["Output"].asString(), cases[i - 1]["OutputHash"].asString());
+    }
+    // 添加 SPJ 文件
+    if (staged && datajson["IsSPJ"].asBool()) {
+        staged = stage("spj.cpp", datajson["SPJ"].asString(), manifest["SPJ"]["Hash"].asString());
+    }
+    if (!staged) {
+        store->RemoveStaging(stagingpath);
+        error = "无法写入测试数据文件";
+        return false;
+    }
 
-        outfilein.open(inpath.data());
-        outfilein << insertjson["TestInfo"][i - 1]["Input"].asString();
-        outfilein.close();
+    Json::Value commitjson;
+    commitjson["ProblemId"] = problemid;
+    commitjson["JudgeNum"] = (int)testinfo.size();
+    commitjson["RemoveSPJ"] = !datajson["IsSPJ"].asBool();
+    bool committed = store->Commit(commitjson, stagingpath, resultjson, error);
+    store->RemoveStaging(stagingpath);
+    return committed;
+}
 
-        outfileout.open(outpath.data());
-        outfileout << insertjson["TestInfo"][i - 1]["Output"].asString();
-        outfileout.close();
+// 根据测试数据的提交结果生成响应（SPJ 在提交时编译，判题时直接使用编译好的版本）
+static Json::Value FinishProblemData(const string &problemid, const Json::Value &resultjson, Json::Value okjson) {
+    // 数据版本变化时释放旧版本的测试数据缓存，内容没有变化时判题使用的缓存继续有效
+    if (resultjson["Changed"].asBool()) {
+        TestDataCache::GetInstance()->Invalidate(problemid);
     }
-    // 添加 SPJ 文件
-    if (insertjson["IsSPJ"].asBool()) {
-        ofstream outfilespj;
-        string spjpath = DATA_PATH + "/spj.cpp";
-        outfilespj.open(spjpath.data());
-        outfilespj << insertjson["SPJ"].asString();
-        outfilespj.close();
+    if (resultjson.isMember("CompilerInfo")) {
+        Json::Value data;
+        data["ProblemId"] = problemid;
+        data["CompilerInfo"] = resultjson["CompilerInfo"];
+        return response::ProblemSpjCompileFailed(data);
     }
-    return true;
+    okjson["data"]["DataVersion"] = resultjson["Version"];
+    return okjson;
 }
 
 // 插入题目（管理员权限）
@@ -134,28 +172,59 @@ Json::Value ProblemService::InsertProblem(Json::Value &insertjson) {
     // 插入题目测试数据
     Json::Value &data = tmpjson["data"];          // 获取插入题目成功后返回的数据（即题目 ID）
     insertjson["ProblemId"] = data["ProblemId"];  // 设置题目 ID
-    InsertProblemDataInfo(insertjson);
-    return tmpjson;
+    Json::Value resultjson;
+    string error;
+    if (!CommitProblemDataInfo(insertjson, resultjson, error)) {
+        return response::ProblemDataInvalid("题目已保存，但测试数据保存失败：" + error);
+    }
+    return FinishProblemData(insertjson["ProblemId"].asString(), resultjson, tmpjson);
 }
 
 // 更新题目信息（管理员权限）
 Json::Value ProblemService::UpdateProblem(Json::Value &updatejson) {
+    // 获取题目 ID
+    string problemid = updatejson["ProblemId"].asString();
+    bool hastestinfo = updatejson["TestInfo"].isArray();
+    Json::Value resultjson;
+    if (hastestinfo) {
+        // 题目必须存在，不存在的题目不生成数据版本
+        Json::Value problemjson = MoDB::GetInstance()->SelectProblemInfoByAdmin(updatejson);
+        if (!problemjson["success"].asBool()) {
+            return problemjson;
+        }
+        // 先提交测试数据（只写入内容变化的文件，全部未变化时不生成新的数据版本），提交失败时不修改题目信息，
+        // 成功后以提交返回的测试用例数目更新题目信息，保证两者一致
+        string error;
+        if (!CommitProblemDataInfo(updatejson, resultjson, error)) {
+            return response::ProblemDataInvalid("测试数据保存失败，题目未修改：" + error);
+        }
+        updatejson["JudgeNum"] = to_string(resultjson["JudgeNum"].asInt());
+    } else {
+        // 没有传入测试用例时只更新题目信息，测试用例数目以当前的数据版本为准
+        Json::Value manifest = TestDataStore::GetInstance()->GetManifest(problemid);
+        if (!manifest.isNull()) {
+            updatejson["JudgeNum"] = to_string(manifest["JudgeNum"].asInt());
+        }
+    }
     Json::Value tmpjson = MoDB::GetInstance()->UpdateProblem(updatejson);
     if (!tmpjson["success"].asBool()) {
-        // 更新失败，直接返回，不进行后续操作
+        // 题目信息更新失败，但测试数据已提交为新版本时，仍同步测试用例数目并释放旧版本的缓存
+        if (resultjson["Changed"].asBool()) {
+            Json::Value judgenumjson;
+            judgenumjson["ProblemId"] = problemid;
+            judgenumjson["JudgeNum"] = resultjson["JudgeNum"];
+            MoDB::GetInstance()->UpdateProblemJudgeNum(judgenumjson);
+            ReDB::GetInstance()->DeleteProblemCache(problemid);
+            TestDataCache::GetInstance()->Invalidate(problemid);
+        }
         return tmpjson;
     }
-    // 获取题目 ID
-    string problemid = updatejson["ProblemId"].asString();
-    string DATA_PATH = PROBLEM_DATA_PREFIX + problemid;
-    // 删除文件夹
-    string command = "rm -rf " + DATA_PATH;
-    system(command.data());
-    // 创建文件夹
-    InsertProblemDataInfo(updatejson);
     // 删除缓存
     ReDB::GetInstance()->DeleteProblemCache(problemid);
-    return tmpjson;
+    if (!hastestinfo) {
+        return tmpjson;
+    }
+    return FinishProblemData(problemid, resultjson, tmpjson);
 }
 
 // 删除题目（管理员权限）
@@ -164,15 +233,146 @@ Json::Value ProblemService::DeleteProblem(Json::Value &deletejson) {
     if (!tmpjson["success"].asBool()) {
         return tmpjson;
     }
-    // 删除数据
-    string DATA_PATH = PROBLEM_DATA_PREFIX + deletejson["ProblemId"].asString();
-    string command = "rm -rf " + DATA_PATH;
-    system(command.data());
+    // 删除数据（全部数据版本）
+    TestDataStore::GetInstance()->Remove(deletejson["ProblemId"].asString());
     // 删除缓存
     ReDB::GetInstance()->DeleteProblemCache(deletejson["ProblemId"].asString());
+    TestDataCache::GetInstance()->Invalidate(deletejson["ProblemId"].asString());
     return tmpjson;
 }
 
+// 获取题目测试数据的清单（管理员权限）
+Json::Value ProblemService::GetProblemDataManifest(Json::Value &queryjson) {
+    Json::Value manifest = TestDataStore::GetInstance()->GetManifest(queryjson["ProblemId"].asString());
+    if (manifest.isNull()) {
+        return response::ProblemNotFound("题目数据不存在！");
+    }
+    return response::Success("查询成功", manifest);
+}
+
+// 分页获取题目测试用例的信息（管理员权限）
+Json::Value ProblemService::SelectProblemDataCases(Json::Value &queryjson) {
+    string problemid = queryjson["ProblemId"].asString();
+    string datapath;
+    if (!TestDataStore::IsValidProblemId(problemid) || !TestDataStore::Resolve(problemid, datapath)) {
+        return response::ProblemNotFound("题目数据不存在！");
+    }
+    int page = max(1, atoi(queryjson["Page"].asString().data()));
+    int pagesize = atoi(queryjson["PageSize"].asString().data());
+    if (pagesize <= 0) {
+        pagesize = constants::judge::TESTDATA_CASE_PAGE_SIZE;
+    }
+    pagesize = min(pagesize, constants::judge::TESTDATA_CASE_PAGE_MAX);
+
+    Json::Value manifest = TestDataStore::LoadManifest(datapath);
+    Json::Value data;
+    data["ProblemId"] = problemid;
+    data["DataVersion"] = manifest["Version"];
+    data["Total"] = manifest["JudgeNum"];
+    data["TestInfo"] = SelectCaseInfo(datapath, manifest, page, pagesize);
+    return response::Success("查询成功", data);
+}
+
+// 获取题目的一个测试数据文件（管理员权限）
+Json::Value ProblemService::SelectProblemDataFile(Json::Value &queryjson, const TestDataSender &sender) {
+    string problemid = queryjson["ProblemId"].asString();
+    string name = queryjson["File"].asString();
+    if (!TestDataStore::IsDataFileName(name)) {
+        return response::BadRequest("不支持的测试数据文件名：" + name);
+    }
+    // 登记使用当前版本目录，下载期间该版本即使被新的提交替换也不会被删除
+    string datapath;
+    TestDataStore *store = TestDataStore::GetInstance();
+    if (!TestDataStore::IsValidProblemId(problemid) || !store->AcquireVersion(problemid, datapath)) {
+        return response::ProblemNotFound("题目数据不存在！");
+    }
+    long long size = TestDataStore::GetFileSize(datapath, name);
+    if (size < 0) {
+        store->ReleaseVersion(datapath);
+        return response::NotFound("测试数据文件不存在！");
+    }
+    // 文件内容不经过 JSON，由 HTTP 层按请求的范围从已登记的版本目录流式读取，响应结束后释放登记
+    sender(datapath, name, size);
+    Json::Value data;
+    data["File"] = name;
+    data["Size"] = (Json::Int64)size;
+    return response::Success("查询成功", data);
+}
+
+// 上传题目的测试数据（管理员权限）
+Json::Value ProblemService::UploadProblemData(Json::Value &uploadjson, const TestDataReceiver &receiver) {
+    // 题目必须存在
+    string problemid = uploadjson["ProblemId"].asString();
+    Json::Value problemjson = MoDB::GetInstance()->SelectProblemInfoByAdmin(uploadjson);
+    if (!problemjson["success"].asBool()) {
+        return problemjson;
+    }
+    TestDataStore *store = TestDataStore::GetInstance();
+    Json::Value commitjson;
+    commitjson["ProblemId"] = problemid;
+    // 未指定测试用例数目时保持当前数据版本的数目
+    if (uploadjson.isMember("JudgeNum")) {
+        commitjson["JudgeNum"] = atoi(uploadjson["JudgeNum"].asCString());
+    } else {
+        commitjson["JudgeNum"] = store->GetManifest(problemid)["JudgeNum"].asInt();
+    }
+    if (uploadjson.isMember("BaseVersion")) {
+        commitjson["BaseVersion"] = (Json::Int64)atoll(uploadjson["BaseVersion"].asCString());
+    }
+    commitjson["RemoveSPJ"] = uploadjson["RemoveSPJ"].asBool();
+    // 测试用例的重新编号：逗号分隔的当前版本序号，数目和范围在提交时校验
+    if (uploadjson.isMember("CaseMap")) {
+        commitjson["CaseMap"] = Json::Value(Json::arrayValue);
+        stringstream casemap(uploadjson["CaseMap"].asString());
+        string item;
+        while (getline(casemap, item, ',')) {
+            if (item.empty() || item.size() > 9 || item.find_first_not_of("0123456789") != string::npos) {
+                return response::BadRequest("测试用例的重新编号不合法");
+            }
+            commitjson["CaseMap"].append(atoi(item.c_str()));
+        }
+    }
+
+    // 接收请求体中的文件
+    string stagingpath = store->CreateStaging(problemid);
+    if (stagingpath.empty()) {
+        return response::InternalError("无法创建暂存目录");
+    }
+    string error;
+    if (!receiver(stagingpath, error)) {
+        store->RemoveStaging(stagingpath);
+        return response::BadRequest(error);
+    }
+    Json::Value resultjson;
+    bool committed = store->Commit(commitjson, stagingpath, resultjson, error);
+    store->RemoveStaging(stagingpath);
+    if (!committed) {
+        if (resultjson["Conflict"].asBool()) {
+            return response::ProblemDataConflict(resultjson, error);
+        }
+        return response::ProblemDataInvalid(error);
+    }
+
+    if (resultjson["Changed"].asBool()) {
+        // 测试用例数目变化时同步到题目信息，判题按题目信息中的数目读取测试数据
+        if (resultjson["JudgeNum"].asInt() != problemjson["data"]["JudgeNum"].asInt()) {
+            Json::Value updatejson;
+            updatejson["ProblemId"] = problemid;
+            updatejson["JudgeNum"] = resultjson["JudgeNum"];
+            MoDB::GetInstance()->UpdateProblemJudgeNum(updatejson);
+            ReDB::GetInstance()->DeleteProblemCache(problemid);
+        }
+        TestDataCache::GetInstance()->Invalidate(problemid);
+    }
+    if (resultjson.isMember("CompilerInfo")) {
+        Json::Value data;
+        data["ProblemId"] = problemid;
+        data["CompilerInfo"] = resultjson["CompilerInfo"];
+        return response::ProblemSpjCompileFailed(data, "测试数据已保存，但 SPJ 编译失败！");
+    }
+    return response::Success("上传成功", resultjson);
+}
+
 // 分页获取题目列表
 Json::Value ProblemService::SelectProblemList(Json::Value &queryjson) {
     return MoDB::GetInstance()->SelectProblemList(queryjson);
@@ -188,6 +388,11 @@ bool ProblemService::UpdateProblemStatusNum(Json::Value &updatejson) {
     return MoDB::GetInstance()->UpdateProblemStatusNum(updatejson);
 }
 
+// 按测评记录重新统计题目的状态数量
+bool ProblemService::RecountProblemStatusNum(Json::Value &updatejson) {
+    return MoDB::GetInstance()->RecountProblemStatusNum(updatejson);
+}
+
 ProblemService::ProblemService() {
     // 构造函数实现
 }
@@ -46,9 +46,9 @@ std::string StatusRecordService::InsertStatusRecord(Json::Value &insertjson) {
     return MoDB::GetInstance()->InsertStatusRecord(insertjson);
 }
 
-// 更新测评信息返回测评结果
-bool StatusRecordService::UpdateStatusRecord(Json::Value &updatejson) {
-    return MoDB::GetInstance()->UpdateStatusRecord(updatejson);
+// 将判题结果写入测评记录
+bool StatusRecordService::UpdateStatusRecord(const JudgeResult &result) {
+    return MoDB::GetInstance()->UpdateStatusRecord(result);
 }
 
 // 获取状态记录的作者 UserId
@@ -56,6 +56,11 @@ std::string StatusRecordService::GetStatusRecordAuthorId(int64_t statusRecordId)
     return MoDB::GetInstance()->GetStatusRecordAuthorId(statusRecordId);
 }
 
+// 查询需要重新评测的测评记录
+Json::Value StatusRecordService::SelectRejudgeRecords(Json::Value &queryjson) {
+    return MoDB::GetInstance()->SelectRejudgeRecords(queryjson);
+}
+
 StatusRecordService::StatusRecordService() {
     // 构造函数实现
 }
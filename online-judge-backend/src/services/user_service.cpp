@@ -94,6 +94,11 @@ bool UserService::UpdateUserProblemInfo(Json::Value &updatejson) {
     return MoDB::GetInstance()->UpdateUserProblemInfo(updatejson);
 }
 
+// 按测评记录重新统计用户题目信息
+bool UserService::RecountUserProblemInfo(Json::Value &updatejson) {
+    return MoDB::GetInstance()->RecountUserProblemInfo(updatejson);
+}
+
 // 用户修改密码
 Json::Value UserService::UpdateUserPassword(Json::Value &updatejson) {
     Json::Value json = MoDB::GetInstance()->UpdateUserPassword(updatejson);
@@ -0,0 +1,99 @@
+/**
+ * 测试数据打包工具
+ *
+ * 将已有题目的测试数据转换为打包存放（使用 --unpack 时转换回单独存放的文件），每个题目生成一个内容相同的新数据版本，
+ * 正在进行的判题继续使用旧版本。需要在后端的工作目录下运行，运行期间不要通过后台修改题目数据（提交锁只在进程内有效）。
+ *
+ * 用法：pack-testdata [--unpack] [题目 ID ...]（不指定题目时处理全部题目）
+ */
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <filesystem>
+#include <iomanip>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#include "constants/judge.h"
+#include "judger/testdata_store.h"
+
+using namespace std;
+
+int main(int argc, char *argv[]) {
+    bool packed = true;
+    vector<string> problemids;
+    for (int i = 1; i < argc; i++) {
+        string arg = argv[i];
+        if (arg == "--unpack") {
+            packed = false;
+        } else {
+            problemids.push_back(arg);
+        }
+    }
+    if (problemids.empty()) {
+        // 数据目录中名称全部为数字的项是题目当前版本的符号链接（或引入版本目录之前的数据目录）
+        error_code ec;
+        for (auto iter = filesystem::directory_iterator(constants::judge::PROBLEM_DATA_PREFIX, ec);
+             !ec && iter != filesystem::directory_iterator(); iter.increment(ec)) {
+            string name = iter->path().filename().string();
+            if (TestDataStore::IsValidProblemId(name)) {
+                problemids.push_back(name);
+            }
+        }
+        sort(problemids.begin(), problemids.end(), [](const string &a, const string &b) {
+            return a.size() != b.size() ? a.size() < b.size() : a < b;
+        });
+    }
+
+    TestDataStore *store = TestDataStore::GetInstance();
+    int failnum = 0;
+    for (const string &problemid : problemids) {
+        Json::Value manifest = store->GetManifest(problemid);
+        if (manifest.isNull()) {
+            cout << "题目 " << problemid << "：数据不存在" << endl;
+            failnum++;
+            continue;
+        }
+        long long rawbytes = 0;
+        for (const Json::Value &caseinfo : manifest["Cases"]) {
+            rawbytes += caseinfo["InputSize"].asInt64() + caseinfo["OutputSize"].asInt64();
+        }
+
+        // 暂存目录为空，全部文件从当前版本复用，只改变存放方式
+        Json::Value commitjson;
+        commitjson["ProblemId"] = problemid;
+        commitjson["JudgeNum"] = manifest["JudgeNum"];
+        commitjson["RemoveSPJ"] = manifest["SPJ"].isNull();
+        commitjson["Packed"] = packed;
+        string stagingpath = store->CreateStaging(problemid);
+        Json::Value resultjson;
+        string error;
+        bool ok = !stagingpath.empty() && store->Commit(commitjson, stagingpath, resultjson, error);
+        store->RemoveStaging(stagingpath);
+        if (!ok) {
+            cout << "题目 " << problemid << "：失败（" << (stagingpath.empty() ? "无法创建暂存目录" : error) << "）"
+                 << endl;
+            failnum++;
+            continue;
+        }
+        if (!resultjson["Changed"].asBool()) {
+            cout << "题目 " << problemid << "：无需转换（版本 " << resultjson["Version"].asInt64() << "）" << endl;
+            continue;
+        }
+        cout << "题目 " << problemid << "：版本 " << manifest["Version"].asInt64() << " -> "
+             << resultjson["Version"].asInt64() << "，测试用例 " << manifest["JudgeNum"].asInt() << " 个";
+        string datapath;
+        struct stat st;
+        if (packed && TestDataStore::Resolve(problemid, datapath) &&
+            stat((datapath + constants::judge::TESTDATA_PACK_NAME).data(), &st) == 0) {
+            cout << fixed << setprecision(2) << "，" << rawbytes / 1048576.0 << " MB -> " << st.st_size / 1048576.0
+                 << " MB";
+        }
+        if (resultjson.isMember("CompilerInfo")) {
+            cout << "，SPJ 编译失败";
+        }
+        cout << endl;
+    }
+    return failnum == 0 ? 0 : 1;
+}
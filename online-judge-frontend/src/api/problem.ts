@@ -7,12 +7,13 @@
  * - 获取题目详情
  * - 编辑题目（新增/更新）
  * - 删除题目（管理员权限）
+ * - 分页获取测试用例信息、获取单个测试数据文件、上传测试数据（管理员权限）
  * - 获取题目列表
  *
  * @module api/problem
  */
 
-import { get, post, del } from "@/utils/http";
+import service, { get, post, del } from "@/utils/http";
 import type { AxiosResponse } from "axios";
 import type { Api } from "@/types/api/api";
 
@@ -92,6 +93,72 @@ export const deleteProblem = (
     );
 };
 
+/**
+ * 分页获取题目测试用例信息（管理员权限）
+ * @name selectProblemDataCases
+ * @tags 题目模块
+ * @description 分页获取测试用例的大小、哈希和预览，不包含完整内容
+ * @request GET `/admin/problem/data/cases`
+ * @param problemId 题目 ID，详见 {@link Api.Problem.ProblemId}
+ * @param page 页码（从 1 开始）
+ * @param pageSize 每页数目
+ * @returns 测试用例信息，详见 {@link Api.Problem.SelectProblemDataCasesResponse}
+ */
+export const selectProblemDataCases = (
+    problemId: Api.Problem.ProblemId,
+    page: number,
+    pageSize: number
+): Promise<AxiosResponse<Api.Problem.SelectProblemDataCasesResponse>> => {
+    return get<Api.Problem.SelectProblemDataCasesResult>("/admin/problem/data/cases", {
+        ProblemId: problemId,
+        Page: page,
+        PageSize: pageSize,
+    });
+};
+
+/**
+ * 获取题目的单个测试数据文件（管理员权限）
+ * @name selectProblemDataFile
+ * @tags 题目模块
+ * @description 获取测试数据文件的原始内容（服务端支持 Range 请求）
+ * @request GET `/admin/problem/data/file`
+ * @param problemId 题目 ID，详见 {@link Api.Problem.ProblemId}
+ * @param file 文件名（<序号>.in、<序号>.out 或 spj.cpp）
+ * @returns 文件的原始内容
+ */
+export const selectProblemDataFile = (
+    problemId: Api.Problem.ProblemId,
+    file: string
+): Promise<AxiosResponse<string>> => {
+    return service.get<string>("/admin/problem/data/file", {
+        params: { ProblemId: problemId, File: file },
+        // 按原始文本返回，不解析为 JSON；大文件不受默认超时限制
+        responseType: "text",
+        transformResponse: [(data: string) => data],
+        timeout: 0,
+    });
+};
+
+/**
+ * 上传题目测试数据（管理员权限）
+ * @name uploadProblemData
+ * @tags 题目模块
+ * @description 只需上传内容变化的文件，服务端与当前版本比较后生成新的数据版本
+ * @request POST `/admin/problem/data/upload`
+ * @param params 上传参数，详见 {@link Api.Problem.UploadProblemDataParams}
+ * @param files 测试数据文件（字段名为文件名），不传时只修改测试用例数目或删除 SPJ
+ * @returns 上传结果，详见 {@link Api.Problem.UploadProblemDataResponse}
+ */
+export const uploadProblemData = (
+    params: Api.Problem.UploadProblemDataParams,
+    files?: FormData
+): Promise<AxiosResponse<Api.Problem.UploadProblemDataResponse>> => {
+    return post<Api.Problem.UploadProblemDataResult>("/admin/problem/data/upload", files, {
+        params,
+        timeout: 0,
+    });
+};
+
 /**
  * 分页获取题目列表
  * @name selectProblemList
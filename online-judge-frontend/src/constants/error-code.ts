@@ -70,6 +70,10 @@ export enum BusinessErrorCode {
     PROBLEM_TITLE_EXISTS = 3002,
     /** 题目数据格式错误 */
     PROBLEM_DATA_INVALID = 3003,
+    /** SPJ 编译失败 */
+    PROBLEM_SPJ_COMPILE_FAILED = 3004,
+    /** 题目数据版本冲突 */
+    PROBLEM_DATA_CONFLICT = 3005,
 
     // ==================== 公告模块错误 (4xxx) ====================
     /** 公告不存在 */
@@ -138,6 +142,8 @@ export const ERROR_CODE_MESSAGES: Record<BusinessErrorCode, string> = {
     [BusinessErrorCode.PROBLEM_NOT_FOUND]: "题目不存在",
     [BusinessErrorCode.PROBLEM_TITLE_EXISTS]: "题目标题已存在",
     [BusinessErrorCode.PROBLEM_DATA_INVALID]: "题目数据格式错误",
+    [BusinessErrorCode.PROBLEM_SPJ_COMPILE_FAILED]: "SPJ 编译失败",
+    [BusinessErrorCode.PROBLEM_DATA_CONFLICT]: "题目数据版本冲突",
 
     // 公告模块错误
     [BusinessErrorCode.ANNOUNCEMENT_NOT_FOUND]: "公告不存在",
@@ -300,6 +300,14 @@ declare namespace Api {
             MemoryLimit: number;
             /** 测试用例数目 */
             JudgeNum: number;
+            /** 评测模式 */
+            JudgeMode?: JudgeMode;
+            /** 输出比较模式 */
+            CompareMode?: CompareMode;
+            /** 浮点数比较的误差（Float 比较模式） */
+            CompareEpsilon?: number;
+            /** 输出限制（兆字节） */
+            OutputLimit?: number;
             /** 提交数量 */
             SubmitNum: number;
             /** 通过数量 */
@@ -312,6 +320,22 @@ declare namespace Api {
         /** 查询题目信息（单条）响应参数 */
         type SelectProblemResponse = ApiResponse<SelectProblemResult>;
 
+        /** 评测模式：ICPC 遇到首个失败的测试用例即停止，OI 评测全部测试用例 */
+        type JudgeMode = "ICPC" | "OI";
+        /**
+         * 输出比较模式：逐字节、忽略行末空白、忽略每行首尾空白、按单词比较，
+         * 以及内置的特殊判题：忽略大小写、浮点数误差、忽略行顺序、yes/no
+         */
+        type CompareMode =
+            | "Exact"
+            | "Trailing"
+            | "Line"
+            | "Token"
+            | "TokenCaseless"
+            | "Float"
+            | "UnorderedLines"
+            | "YesNo";
+
         /** 测试信息 */
         interface TestInfo {
             /** 测试输入 */
@@ -319,6 +343,23 @@ declare namespace Api {
             /** 测试输出 */
             Output: string;
         }
+        /** 测试用例信息（只包含大小、哈希和预览，完整内容通过 selectProblemDataFile 按需获取） */
+        interface TestCaseInfo {
+            /** 测试用例序号（从 1 开始） */
+            Index: number;
+            /** 测试输入的字节数 */
+            InputSize: number;
+            /** 测试输入的 SHA-256 */
+            InputHash: string;
+            /** 测试输入的预览 */
+            InputPreview: string;
+            /** 测试输出的字节数 */
+            OutputSize: number;
+            /** 测试输出的 SHA-256 */
+            OutputHash: string;
+            /** 测试输出的预览 */
+            OutputPreview: string;
+        }
         /** 查询题目信息（单条，管理员权限）响应数据结构 */
         interface SelectProblemByAdminResult {
             /** 题目 ID */
@@ -335,14 +376,24 @@ declare namespace Api {
             MemoryLimit: number;
             /** 测试用例数目 */
             JudgeNum: number;
+            /** 评测模式 */
+            JudgeMode?: JudgeMode;
+            /** 输出比较模式 */
+            CompareMode?: CompareMode;
+            /** 浮点数比较的误差（Float 比较模式） */
+            CompareEpsilon?: number;
+            /** 输出限制（兆字节） */
+            OutputLimit?: number;
             /** 题目标签列表 */
             Tags: Tag.Tags;
             /** 特判标志 */
             IsSPJ?: boolean;
             /** 特判代码 */
             SPJ?: string;
-            /** 测试信息列表 */
-            TestInfo: TestInfo[];
+            /** 测试数据版本（上传测试数据时作为 BaseVersion） */
+            DataVersion: number;
+            /** 第一页测试用例的信息，其余页通过 selectProblemDataCases 获取 */
+            TestInfo: TestCaseInfo[];
         }
         /** 查询题目信息（单条，管理员权限）响应参数 */
         type SelectProblemByAdminResponse = ApiResponse<SelectProblemByAdminResult>;
@@ -361,14 +412,22 @@ declare namespace Api {
             MemoryLimit: number;
             /** 测试用例数目 */
             JudgeNum: number;
+            /** 评测模式 */
+            JudgeMode: JudgeMode;
+            /** 输出比较模式 */
+            CompareMode: CompareMode;
+            /** 浮点数比较的误差（Float 比较模式） */
+            CompareEpsilon?: number;
+            /** 输出限制（兆字节） */
+            OutputLimit?: number;
             /** 题目标签列表 */
             Tags: Tag.Tags;
             /** 特判标志 */
             IsSPJ: boolean;
             /** 特判代码 */
             SPJ?: string;
-            /** 测试信息列表 */
-            TestInfo: TestInfo[];
+            /** 测试信息列表（更新题目时不传则只更新题目信息，测试数据通过 uploadProblemData 上传） */
+            TestInfo?: TestInfo[];
         }
         /** 编辑题目请求参数 */
         interface EditProblemParams {
@@ -383,6 +442,8 @@ declare namespace Api {
             ProblemId?: ProblemId;
             /** 更新结果 */
             Result?: boolean;
+            /** SPJ 编译失败时的编译器输出 */
+            CompilerInfo?: string;
         }
         /** 编辑题目响应参数 */
         type EditProblemResponse = ApiResponse<EditProblemResult>;
@@ -390,6 +451,51 @@ declare namespace Api {
         /** 删除题目响应参数 */
         type DeleteProblemResponse = ApiResponse<Common.OperationResult>;
 
+        /** 分页获取题目测试用例信息响应数据结构 */
+        interface SelectProblemDataCasesResult {
+            /** 题目 ID */
+            ProblemId: ProblemId;
+            /** 测试数据版本 */
+            DataVersion: number;
+            /** 测试用例总数 */
+            Total: number;
+            /** 当前页的测试用例信息 */
+            TestInfo: TestCaseInfo[];
+        }
+        /** 分页获取题目测试用例信息响应参数 */
+        type SelectProblemDataCasesResponse = ApiResponse<SelectProblemDataCasesResult>;
+
+        /** 上传题目测试数据请求参数（文件放在 multipart/form-data 请求体中，字段名为文件名） */
+        interface UploadProblemDataParams {
+            /** 题目 ID */
+            ProblemId: ProblemId;
+            /** 测试用例数目（不传时保持不变） */
+            JudgeNum?: number;
+            /** 基于的测试数据版本（与当前版本不一致时拒绝上传） */
+            BaseVersion?: number;
+            /** 是否删除 SPJ */
+            RemoveSPJ?: boolean;
+            /** 测试用例的重新编号：逗号分隔的当前版本测试用例序号，依次对应新的每个测试用例（0 表示新增） */
+            CaseMap?: string;
+        }
+        /** 上传题目测试数据响应数据结构 */
+        interface UploadProblemDataResult {
+            /** 内容是否变化（未变化时不生成新的数据版本） */
+            Changed: boolean;
+            /** 当前的测试数据版本 */
+            Version: number;
+            /** 测试用例数目 */
+            JudgeNum: number;
+            /** 写入的文件数 */
+            WrittenNum: number;
+            /** 从上一个版本复用的文件数 */
+            ReusedNum: number;
+            /** SPJ 编译失败时的编译器输出 */
+            CompilerInfo?: string;
+        }
+        /** 上传题目测试数据响应参数 */
+        type UploadProblemDataResponse = ApiResponse<UploadProblemDataResult>;
+
         /** 分页获取题目列表请求参数 */
         interface SelectProblemListParams extends Common.PaginationParams {
             /** 搜索信息 */
@@ -436,6 +542,8 @@ declare namespace Api {
             TLENum: number;
             /** 内存超限数量 */
             MLENum: number;
+            /** 输出超限数量 */
+            OLENum?: number;
             /** 系统错误数量 */
             SENum: number;
             /** 题目标签列表 */
@@ -986,12 +1094,28 @@ declare namespace Api {
             RunMemory: string;
             /** 状态 */
             Status: string;
-            /** 标准输入 */
+            /** 标准输入（预览） */
             StandardInput: string;
-            /** 标准输出 */
+            /** 标准输入的完整字节数 */
+            StandardInputSize?: number;
+            /** 标准输入的 SHA-256 */
+            StandardInputHash?: string;
+            /** 标准输出（预览） */
             StandardOutput: string;
-            /** 用户输出 */
+            /** 标准输出的完整字节数 */
+            StandardOutputSize?: number;
+            /** 标准输出的 SHA-256 */
+            StandardOutputHash?: string;
+            /** 用户输出（预览） */
             PersonalOutput: string;
+            /** 用户输出的完整字节数 */
+            PersonalOutputSize?: number;
+            /** 用户输出的 SHA-256 */
+            PersonalOutputHash?: string;
+            /** 答案错误时第一个不一致位置的行号（从 1 开始，0 表示没有） */
+            MismatchLine?: number;
+            /** 答案错误时第一个不一致位置的列号（从 1 开始，0 表示没有） */
+            MismatchColumn?: number;
         }
 
         /** 查询一条状态记录响应数据结构 */
@@ -1092,12 +1216,12 @@ declare namespace Api {
         interface SubmitJudgeCodeResult {
             /** 提交成功返回的状态记录 ID */
             StatusRecordId: Status.StatusRecordId;
-            /** 编译器信息 */
-            CompilerInfo: string;
-            /** 判题结果 */
+            /** 编译器信息（异步判题完成后通过测评记录获取） */
+            CompilerInfo?: string;
+            /** 判题结果（提交时为 0，即等待判题） */
             Status: number;
             /** 是否第一次通过 */
-            IsFirstAC: boolean;
+            IsFirstAC?: boolean;
         }
         /** 提交判题响应参数 */
         type SubmitJudgeCodeResponse = ApiResponse<SubmitJudgeCodeResult>;
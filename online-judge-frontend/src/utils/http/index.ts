@@ -190,6 +190,11 @@ service.interceptors.response.use(
             console.log(`[Response] ${config.url}`, data);
         }
 
+        // 非 JSON 响应（如测试数据文件的原始内容）直接返回，由业务层处理
+        if (config.responseType === "text") {
+            return response;
+        }
+
         // 处理业务层面的成功响应
         if (data.success && data.code === BusinessErrorCode.SUCCESS) {
             // 如果配置了显示成功提示